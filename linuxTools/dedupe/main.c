@@ -0,0 +1,246 @@
+//----------------------------------------------------------------------
+//--
+//--    dedupe - main.c
+//--
+//--            Remove symmetric duplicates from a corpus of grids
+//--
+//----------------------------------------------------------------------
+//
+//  usage : dedupe [-l level] [-i corpus] [-g grids] [-b seed] [-o file]
+//
+//  A corpus is a file of packed masks (see src/mask.h) of a single
+//  level. The corpus is read as a stream : only the 64 bits canonical
+//  hashes of the grids already seen are kept in memory (open addressing
+//  hash set). A grid is a duplicate if one of its symmetries has already
+//  been seen.
+//
+//  Without an input file, the grids of the bots' series are generated
+//  (see bot_gameSeed). Unique grids are written in the output file.
+//
+
+#include "../../src/bot.h"
+#include "../../src/mask.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+// Default values
+//
+#define DEF_GRIDS           1000000
+#define DEF_SEED            0x6765654Du
+
+#define BUFFER_RECORDS      8192    // Grids read at once
+#define MAX_RECORD_SIZE     mask_packedSize(MASK_MAX_SIZE, MASK_MAX_SIZE)
+
+#define SET_MIN_SIZE        (1 << 16)
+#define SET_EMPTY           0       // Free slot (hashes are never 0)
+
+// Set of hashes
+//
+typedef struct __hashSet{
+    uint64_t* slots;
+    uint64_t size;          // Count of slots (power of 2)
+    uint64_t count;         // Used slots
+} HASH_SET, * PHASH_SET;
+
+static void _usage(const char* app);
+static size_t _generate(PGRID const grid, uint32_t seed, uint32_t* next, uint32_t last, uint8_t* records);
+static BOOL _setAdd(PHASH_SET const set, uint64_t hash);
+static BOOL _setGrow(PHASH_SET const set);
+
+int main(int argc, char* argv[]){
+    static uint8_t records[BUFFER_RECORDS * MAX_RECORD_SIZE];
+    const char* input = NULL;
+    const char* output = NULL;
+    GAME_LEVEL level = LEVEL_BEGINNER;
+    uint32_t grids = DEF_GRIDS, seed = DEF_SEED, next = 0;
+    uint64_t total = 0, duplicates = 0, hash;
+    uint16_t recordSize;
+    size_t count, index;
+    HASH_SET set = {NULL, 0, 0};
+    FILE* src = NULL;
+    FILE* dest = NULL;
+    MASK mask, canonical;
+    PGRID grid;
+    double elapsed;
+    clock_t start;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "l:i:g:b:o:h"))){
+        switch (opt){
+            case 'l':
+                level = (GAME_LEVEL)atoi(optarg);
+                break;
+
+            case 'i':
+                input = optarg;
+                break;
+
+            case 'g':
+                grids = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'b':
+                seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'o':
+                output = optarg;
+                break;
+
+            default:
+                _usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (level > LEVEL_EXPERT){
+        _usage(argv[0]);
+        return 1;
+    }
+
+    if (!(grid = grid_create()) || !grid_init(grid, level) || !_setGrow(&set)){
+        printf("Not enough memory\n");
+        return 1;
+    }
+
+    mask.cols = grid->size.col;
+    mask.rows = grid->size.row;
+    recordSize = mask_packedSize(mask.cols, mask.rows);
+
+    if (input && !(src = fopen(input, "rb"))){
+        printf("Unable to open '%s'\n", input);
+        return 1;
+    }
+
+    if (output && !(dest = fopen(output, "wb"))){
+        printf("Unable to create '%s'\n", output);
+        return 1;
+    }
+
+    start = clock();
+    while ((count = src?fread(records, recordSize, BUFFER_RECORDS, src):
+                        _generate(grid, seed, &next, grids, records))){
+        for (index = 0; index < count; index++){
+            mask_unpack(&mask, &records[index * recordSize]);
+            mask_canonical(&mask, &canonical);
+            hash = mask_hash(&canonical);
+
+            if ((set.count + 1) * 2 > set.size && !_setGrow(&set)){
+                printf("Not enough memory\n");
+                return 1;
+            }
+
+            if (_setAdd(&set, hash)){
+                if (dest && 1 != fwrite(&records[index * recordSize], recordSize, 1, dest)){
+                    printf("Unable to write in '%s'\n", output);
+                    return 1;
+                }
+            }
+            else{
+                duplicates++;
+            }
+        }
+
+        total += count;
+    }
+    elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+
+    printf("%llu grids, %llu unique, %llu duplicates (%.2f%%)\n",
+            (unsigned long long)total, (unsigned long long)set.count, (unsigned long long)duplicates,
+            total?(100.0 * duplicates / total):0.0);
+    printf("%.2f s, %.0f grids/s, %llu MB of hashes\n",
+            elapsed, elapsed > 0.0?(total / elapsed):0.0,
+            (unsigned long long)(set.size * sizeof(uint64_t) >> 20));
+
+    // Free
+    if (src){
+        fclose(src);
+    }
+    if (dest){
+        fclose(dest);
+    }
+    free(set.slots);
+    grid_free(grid, TRUE);
+
+    return 0;
+}
+
+// _usage() : Show command-line options
+//
+static void _usage(const char* app){
+    printf("usage : %s [-l level] [-i corpus] [-g grids] [-b seed] [-o file]\n\n", app);
+    printf("\t-l : level of the grids, 0 = beginner, 1 = medium, 2 = expert (0)\n");
+    printf("\t-i : corpus of packed masks (generated grids)\n");
+    printf("\t-g : count of generated grids (%d)\n", DEF_GRIDS);
+    printf("\t-b : seed of the generated series (0x%08X)\n", DEF_SEED);
+    printf("\t-o : file of unique grids (none)\n");
+}
+
+// _generate() : Next grids of the series as packed masks
+//
+static size_t _generate(PGRID const grid, uint32_t seed, uint32_t* next, uint32_t last, uint8_t* records){
+    uint16_t recordSize = mask_packedSize(grid->size.col, grid->size.row);
+    MASK mask;
+    size_t count;
+
+    for (count = 0; count < BUFFER_RECORDS && *next < last; (*next)++){
+        if (grid_init(grid, grid->level) &&
+            grid_layMinesEx(grid, bot_gameSeed(seed, grid->level, *next)) &&
+            mask_fromGrid(grid, &mask)){
+            mask_pack(&mask, &records[count++ * recordSize]);
+        }
+    }
+
+    return count;
+}
+
+// _setAdd() : Add a hash to the set (which must have a free slot)
+//
+//  @return : TRUE if the hash is new
+//
+static BOOL _setAdd(PHASH_SET const set, uint64_t hash){
+    uint64_t index;
+
+    if (SET_EMPTY == hash){
+        hash = 1;
+    }
+
+    for (index = hash & (set->size - 1); SET_EMPTY != set->slots[index];
+        index = (index + 1) & (set->size - 1)){
+        if (set->slots[index] == hash){
+            return FALSE;
+        }
+    }
+
+    set->slots[index] = hash;
+    set->count++;
+    return TRUE;
+}
+
+// _setGrow() : Double the size of the set
+//
+static BOOL _setGrow(PHASH_SET const set){
+    HASH_SET old = *set;
+    uint64_t index;
+
+    set->size = old.size?(old.size << 1):SET_MIN_SIZE;
+    if (!(set->slots = (uint64_t*)calloc(set->size, sizeof(uint64_t)))){
+        *set = old;
+        return FALSE;
+    }
+
+    set->count = 0;
+    for (index = 0; index < old.size; index++){
+        if (SET_EMPTY != old.slots[index]){
+            _setAdd(set, old.slots[index]);
+        }
+    }
+
+    free(old.slots);
+    return TRUE;
+}
+
+// EOF
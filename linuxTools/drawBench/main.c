@@ -0,0 +1,179 @@
+//----------------------------------------------------------------------
+//--
+//--    drawBench - main.c
+//--
+//--            Frames and drawing time of the game boards
+//--
+//----------------------------------------------------------------------
+//
+//  usage : drawBench [-n frames] [-o folder] [-f pattern] [-b seed]
+//
+//  A board is drawn with board_drawEx() for each level, orientation and
+//  zoom, then the visible grid is drawn again and again with
+//  board_drawGridEx(). Each first frame is saved in a PNG file of the
+//  output folder so that two versions of the code can be compared pixel
+//  by pixel.
+//
+//  Boards are laid with the seed and all their openings are revealed.
+//
+
+#include "../../src/board.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// Default values
+//
+#define DEF_FRAMES          1000
+#define DEF_FOLDER          "."
+#define DEF_SEED            0x6765654Du
+
+#define LEVEL_COUNT         (LEVEL_EXPERT + 1)
+
+static const char* _levels[LEVEL_COUNT] = {"beginner", "medium", "expert"};
+static const char* _orientations[] = {"vertical", "horizontal"};
+
+static void _usage(const char* app);
+static BOOL _layBoard(PBOARD const board, GAME_LEVEL level, uint32_t seed);
+static uint64_t _now();
+
+int main(int argc, char* argv[]){
+    const char* folder = DEF_FOLDER;
+    const char* pattern = NULL;
+    uint32_t frames = DEF_FRAMES, seed = DEF_SEED, index;
+    uint64_t start, duration;
+    char file[256];
+    GAME_LEVEL level;
+    uint8_t orientation, zoom;
+    PBOARD board;
+    int opt;
+
+    while (-1 != (opt = getopt(argc, argv, "n:o:f:b:h"))){
+        switch (opt){
+            case 'n':
+                frames = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'o':
+                folder = optarg;
+                break;
+
+            case 'f':
+                pattern = optarg;
+                break;
+
+            case 'b':
+                seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                _usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (!frames){
+        _usage(argv[0]);
+        return 1;
+    }
+
+    if (!(board = board_create())){
+        printf("Unable to create the board\n");
+        return 1;
+    }
+
+    // Every frame can be saved
+    render_setOutput(pattern);
+
+    printf("%-10s %-10s %4s %6s %10s %12s\n", "Level", "Orient.", "Box", "Boxes", "Frames", "us/frame");
+    for (level = LEVEL_BEGINNER; level <= LEVEL_EXPERT; level++){
+        if (!_layBoard(board, level, seed)){
+            printf("Unable to create the %s grid\n", _levels[level]);
+            continue;
+        }
+
+        for (orientation = CALC_VERTICAL; orientation <= CALC_HORIZONTAL; orientation++){
+            for (zoom = 0; zoom < ZOOM_COUNT; zoom++){
+                board_setOrientation(board, (CALC_ORIENTATION)orientation);
+                board_setZoom(board, zoom);
+
+                // Reference frame
+                board_drawEx(board, FALSE, TRUE);
+                snprintf(file, sizeof(file), "%s/board-%s-%s-%u.png",
+                        folder, _levels[level], _orientations[orientation], board->boxSize);
+                if (!render_savePNG(file)){
+                    printf("Unable to write %s\n", file);
+                }
+
+                // Visible grid only
+                start = _now();
+                for (index = 0; index < frames; index++){
+                    board_drawGridEx(board, TRUE);
+                }
+                duration = _now() - start;
+
+                printf("%-10s %-10s %4u %6u %10u %12.2f\n",
+                        _levels[level], _orientations[orientation], board->boxSize,
+                        board->viewPort.visibleFrame.w * board->viewPort.visibleFrame.h,
+                        frames, (double)duration / frames);
+            }
+        }
+    }
+
+    render_setOutput(NULL);
+    board_free(board, TRUE);
+    return 0;
+}
+
+// _usage() : Show command-line options
+//
+static void _usage(const char* app){
+    printf("usage : %s [-n frames] [-o folder] [-f pattern] [-b seed]\n\n", app);
+    printf("\t-n : grids drawn by board (%d)\n", DEF_FRAMES);
+    printf("\t-o : folder of the reference frames (%s)\n", DEF_FOLDER);
+    printf("\t-f : pattern of the files to save every frame (\"frame-%%05u.png\")\n");
+    printf("\t-b : seed of the grids (0x%08X)\n", DEF_SEED);
+}
+
+// _layBoard() : New board whose openings are revealed
+//
+//  @board : Pointer to the board
+//  @level : Level of the grid
+//  @seed : Seed of the mines
+//
+//  @return : TRUE if done
+//
+static BOOL _layBoard(PBOARD const board, GAME_LEVEL level, uint32_t seed){
+    PGRID grid = board->grid;
+    COORD pos;
+    PBOX box;
+
+    if (!grid_init(grid, level) || !grid_layMinesEx(grid, seed)){
+        return FALSE;
+    }
+
+    board_reset(board);
+    for (pos.row = 0; pos.row < grid->size.row; pos.row++){
+        for (pos.col = 0; pos.col < grid->size.col; pos.col++){
+            box = BOX_AT_POS(grid, &pos);
+            if (!box->mine && !box->around && BOX_IS_COVERED(box)){
+                board->steps += grid_step(grid, &pos, NULL, NULL);
+            }
+        }
+    }
+
+    board_setGameStateEx(board, STATE_PLAYING, FALSE);
+    return TRUE;
+}
+
+// _now() : Current time in µs
+//
+static uint64_t _now(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+// EOF
@@ -0,0 +1,231 @@
+//----------------------------------------------------------------------
+//--
+//--    gridStats - main.c
+//--
+//--            Difficulty of a corpus of seeded grids
+//--
+//----------------------------------------------------------------------
+//
+//  usage : gridStats [-n grids] [-t threads] [-l levels] [-b seed]
+//
+//  Grids are the ones played by the bots (see bot_gameSeed) and are
+//  analysed with grid_analyse().
+//
+
+#include "../../src/bot.h"
+#include "../shared/pool.h"
+#include "../shared/stats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Default values
+//
+#define DEF_GRIDS           1000000
+#define DEF_SEED            0x6765654Du
+
+#define BATCH_SIZE          4096    // Grids per task
+
+#define LEVEL_COUNT         (LEVEL_EXPERT + 1)
+
+// Indicators
+//
+enum{
+    IND_3BV, IND_OPENINGS, IND_ISOLATED, IND_ZINI, IND_COUNT
+};
+
+// Results of a level
+//
+typedef struct __levelStats{
+    pthread_mutex_t lock;
+    STATS values[IND_COUNT];
+    uint16_t min[IND_COUNT];
+    uint16_t max[IND_COUNT];
+} LEVEL_STATS, * PLEVEL_STATS;
+
+// A task : a batch of grids
+//
+typedef struct __batch{
+    GAME_LEVEL level;
+    uint32_t first;         // Index of the first grid
+    uint32_t count;
+} BATCH, * PBATCH;
+
+// Shared context
+//
+typedef struct __context{
+    LEVEL_STATS levels[LEVEL_COUNT];
+    PGRID grids[POOL_MAX_WORKERS];  // One grid per worker
+    uint32_t seed;
+} CONTEXT, * PCONTEXT;
+
+static void _usage(const char* app);
+static void _runBatch(void* task, uint8_t worker, void* param);
+static void _showResults(PCONTEXT const context, const char* levels);
+
+int main(int argc, char* argv[]){
+    static CONTEXT context;
+    const char* levels = "012";
+    uint32_t grids = DEF_GRIDS, index;
+    uint8_t threads = 0, id, worker = 0;
+    BATCH batch;
+    PPOOL pool;
+    int opt;
+
+    context.seed = DEF_SEED;
+
+    while (-1 != (opt = getopt(argc, argv, "n:t:l:b:h"))){
+        switch (opt){
+            case 'n':
+                grids = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                threads = (uint8_t)atoi(optarg);
+                break;
+
+            case 'l':
+                levels = optarg;
+                break;
+
+            case 'b':
+                context.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                _usage(argv[0]);
+                return 1;
+        }
+    }
+
+    for (const char* level = levels; *level; level++){
+        if (*level < '0' || *level >= '0' + LEVEL_COUNT){
+            _usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!grids || !*levels){
+        _usage(argv[0]);
+        return 1;
+    }
+
+    if (!(pool = pool_create(threads, (grids / BATCH_SIZE + 1) * strlen(levels), sizeof(BATCH), _runBatch, &context))){
+        printf("Unable to create the pool\n");
+        return 1;
+    }
+
+    for (id = 0; id < LEVEL_COUNT; id++){
+        pthread_mutex_init(&context.levels[id].lock, NULL);
+        memset(context.levels[id].min, 0xFF, sizeof(context.levels[id].min));
+    }
+
+    for (id = 0; id < pool->workers; id++){
+        if (!(context.grids[id] = grid_create())){
+            printf("Unable to create the grids\n");
+            return 1;
+        }
+    }
+
+    for (const char* level = levels; *level; level++){
+        for (index = 0; index < grids; index += BATCH_SIZE){
+            batch.level = (GAME_LEVEL)(*level - '0');
+            batch.first = index;
+            batch.count = MIN_VAL(BATCH_SIZE, grids - index);
+            pool_push(pool, worker, &batch);
+            worker = (worker + 1) % pool->workers;
+        }
+    }
+
+    pool_run(pool);
+    _showResults(&context, levels);
+
+    // Free
+    for (id = 0; id < pool->workers; id++){
+        grid_free(context.grids[id], TRUE);
+    }
+    for (id = 0; id < LEVEL_COUNT; id++){
+        pthread_mutex_destroy(&context.levels[id].lock);
+    }
+    pool_free(pool, TRUE);
+
+    return 0;
+}
+
+// _usage() : Show command-line options
+//
+static void _usage(const char* app){
+    printf("usage : %s [-n grids] [-t threads] [-l levels] [-b seed]\n\n", app);
+    printf("\t-n : grids per level (%d)\n", DEF_GRIDS);
+    printf("\t-t : count of threads (count of CPUs)\n");
+    printf("\t-l : levels, 0 = beginner, 1 = medium, 2 = expert (012)\n");
+    printf("\t-b : seed of the series (0x%08X)\n", DEF_SEED);
+}
+
+// _runBatch() : Analyse a batch of grids
+//
+static void _runBatch(void* task, uint8_t worker, void* param){
+    PCONTEXT context = (PCONTEXT)param;
+    PBATCH batch = (PBATCH)task;
+    PLEVEL_STATS level = &context->levels[batch->level];
+    PGRID grid = context->grids[worker];
+    STATS values[IND_COUNT];
+    uint16_t min[IND_COUNT], max[IND_COUNT], current[IND_COUNT];
+    GRID_STATS stats;
+    uint32_t index;
+    uint8_t id;
+
+    memset(values, 0, sizeof(values));
+    memset(min, 0xFF, sizeof(min));
+    memset(max, 0, sizeof(max));
+
+    for (index = batch->first; index < batch->first + batch->count; index++){
+        if (!grid_init(grid, batch->level) ||
+            !grid_layMinesEx(grid, bot_gameSeed(context->seed, batch->level, index)) ||
+            !grid_analyse(grid, &stats)){
+            continue;
+        }
+
+        current[IND_3BV] = stats.bbbv;
+        current[IND_OPENINGS] = stats.openings;
+        current[IND_ISOLATED] = stats.isolated;
+        current[IND_ZINI] = stats.zini;
+        for (id = 0; id < IND_COUNT; id++){
+            stats_add(&values[id], current[id]);
+            min[id] = MIN_VAL(min[id], current[id]);
+            max[id] = MAX_VAL(max[id], current[id]);
+        }
+    }
+
+    pthread_mutex_lock(&level->lock);
+    for (id = 0; id < IND_COUNT; id++){
+        stats_merge(&level->values[id], &values[id]);
+        level->min[id] = MIN_VAL(level->min[id], min[id]);
+        level->max[id] = MAX_VAL(level->max[id], max[id]);
+    }
+    pthread_mutex_unlock(&level->lock);
+}
+
+// _showResults() : Results of all the levels
+//
+static void _showResults(PCONTEXT const context, const char* levels){
+    const char* names[LEVEL_COUNT] = {"beginner", "medium", "expert"};
+    const char* indicators[IND_COUNT] = {"3BV", "openings", "isolated", "ZiNi"};
+    PLEVEL_STATS level;
+    INTERVAL mean;
+
+    printf("%-9s %-9s %9s %8s %10s %6s %6s\n",
+            "level", "value", "grids", "mean", "95% +/-", "min", "max");
+    for (; *levels; levels++){
+        level = &context->levels[*levels - '0'];
+        for (uint8_t id = 0; id < IND_COUNT; id++){
+            stats_mean(&level->values[id], &mean);
+            printf("%-9s %-9s %9u %8.2f %10.3f %6u %6u\n",
+                    id?"":names[*levels - '0'], indicators[id], level->values[id].count,
+                    mean.value, mean.high - mean.value, level->min[id], level->max[id]);
+        }
+    }
+}
+
+// EOF
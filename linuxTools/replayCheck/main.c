@@ -0,0 +1,395 @@
+//----------------------------------------------------------------------
+//--
+//--    replayCheck - main.c
+//--
+//--            Deterministic replay of recorded games
+//--
+//----------------------------------------------------------------------
+//
+//  usage : replayCheck [-i replays] [-t threads] [-s scores] [-v]
+//
+//  Each game of the replay file is played again at full speed : the grid
+//  is rebuilt from the seed and the actions are applied with grid_step().
+//  A replay is valid if the result and the duration of the game match
+//  the recorded ones.
+//
+//  The replay file is mapped in memory and split in batches of games
+//  spread across the threads of a work-stealing pool.
+//
+//  With a scores journal (_geeMines.sc0 or .sc1 written by the calculator),
+//  each recorded score must match a valid won game (same level, time and
+//  3BV).
+//
+
+#include "../../src/game.h"
+#include "../../src/replay.h"
+#include "../../src/scores.h"
+#include "../shared/pool.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Default values
+//
+#define DEF_REPLAYS         REPLAY_FILE
+
+#define BATCH_SIZE          256     // Games per task
+#define MAX_TIME            (TIMER_MAX_VALUE * TIMER_SECOND)
+
+// Results of a replay
+//
+enum{
+    CHECK_VALID,
+    CHECK_TRUNCATED,        // Oldest actions are missing
+    CHECK_GRID,             // Invalid level
+    CHECK_ACTION,           // Invalid box or action
+    CHECK_AFTER_END,        // Actions after the end of the game
+    CHECK_RESULT,           // Not the recorded result
+    CHECK_TIME,             // Not the recorded duration
+    CHECK_COUNT
+};
+
+// A checked replay
+//
+typedef struct __check{
+    uint8_t status;
+    uint8_t level;
+    uint8_t result;
+    uint16_t time;
+    uint16_t bbbv;
+} CHECK, * PCHECK;
+
+// A task : a batch of replays
+//
+typedef struct __batch{
+    uint32_t first;         // Index of the first replay
+    uint32_t count;
+} BATCH, * PBATCH;
+
+// Shared context
+//
+typedef struct __context{
+    const uint8_t* data;    // Mapped file
+    size_t size;
+    size_t* offsets;        // Offset of each replay
+    PCHECK checks;
+    PGRID grids[POOL_MAX_WORKERS];      // One grid ...
+    PREPLAY replays[POOL_MAX_WORKERS];  // ... and one replay per worker
+} CONTEXT, * PCONTEXT;
+
+static void _usage(const char* app);
+static uint32_t _index(PCONTEXT const context);
+static void _runBatch(void* task, uint8_t worker, void* param);
+static void _check(PGRID const grid, const REPLAY* replay, PCHECK check);
+static void _checkScores(PCONTEXT const context, uint32_t count, const char* file);
+
+int main(int argc, char* argv[]){
+    static CONTEXT context;
+    const char* names[CHECK_COUNT] = {"valid", "truncated", "bad grid",
+                        "bad action", "after end", "bad result", "bad time"};
+    const char* input = DEF_REPLAYS;
+    const char* scores = NULL;
+    uint32_t count, index, totals[CHECK_COUNT] = {0};
+    uint8_t threads = 0, id, worker = 0;
+    BOOL verbose = FALSE;
+    struct stat info;
+    BATCH batch;
+    PPOOL pool;
+    double elapsed;
+    struct timespec start, end;
+    int opt, fd;
+
+    while (-1 != (opt = getopt(argc, argv, "i:t:s:vh"))){
+        switch (opt){
+            case 'i':
+                input = optarg;
+                break;
+
+            case 't':
+                threads = (uint8_t)atoi(optarg);
+                break;
+
+            case 's':
+                scores = optarg;
+                break;
+
+            case 'v':
+                verbose = TRUE;
+                break;
+
+            default:
+                _usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (-1 == (fd = open(input, O_RDONLY)) || fstat(fd, &info) || !info.st_size ||
+        MAP_FAILED == (context.data = (const uint8_t*)mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0))){
+        printf("Unable to read '%s'\n", input);
+        return 1;
+    }
+
+    context.size = info.st_size;
+    if (!(count = _index(&context)) ||
+        !(context.checks = (PCHECK)calloc(count, sizeof(CHECK))) ||
+        !(pool = pool_create(threads, count / BATCH_SIZE + 1, sizeof(BATCH), _runBatch, &context))){
+        printf("No replay or not enough memory\n");
+        return 1;
+    }
+
+    for (id = 0; id < pool->workers; id++){
+        if (!(context.grids[id] = grid_create()) || !(context.replays[id] = replay_create())){
+            printf("Not enough memory\n");
+            return 1;
+        }
+    }
+
+    for (index = 0; index < count; index += BATCH_SIZE){
+        batch.first = index;
+        batch.count = MIN_VAL(BATCH_SIZE, count - index);
+        pool_push(pool, worker, &batch);
+        worker = (worker + 1) % pool->workers;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    pool_run(pool);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    // Results
+    for (index = 0; index < count; index++){
+        totals[context.checks[index].status]++;
+        if (verbose && CHECK_VALID != context.checks[index].status){
+            printf("game %u : %s\n", index + 1, names[context.checks[index].status]);
+        }
+    }
+
+    printf("%u game(s) checked by %d thread(s) in %.3f s (%.0f games/s)\n",
+            count, pool->workers, elapsed, elapsed > 0.0?(count / elapsed):0.0);
+    for (id = 0; id < CHECK_COUNT; id++){
+        if (totals[id] || !id){
+            printf("\t%-10s : %u\n", names[id], totals[id]);
+        }
+    }
+
+    if (scores){
+        _checkScores(&context, count, scores);
+    }
+
+    // Free
+    for (id = 0; id < pool->workers; id++){
+        grid_free(context.grids[id], TRUE);
+        replay_free(context.replays[id]);
+    }
+    pool_free(pool, TRUE);
+    free(context.checks);
+    free(context.offsets);
+    munmap((void*)context.data, info.st_size);
+    close(fd);
+
+    return (totals[CHECK_VALID] == count)?0:2;
+}
+
+// _usage() : Show command-line options
+//
+static void _usage(const char* app){
+    printf("usage : %s [-i replays] [-t threads] [-s scores] [-v]\n\n", app);
+    printf("\t-i : replay file (%s)\n", DEF_REPLAYS);
+    printf("\t-t : count of threads (count of CPUs)\n");
+    printf("\t-s : scores journal to check\n");
+    printf("\t-v : show invalid games\n");
+}
+
+// _index() : Find the replays in the mapped file
+//
+//  @return : count of replays
+//
+static uint32_t _index(PCONTEXT const context){
+    uint32_t count = 0, capacity = 0;
+    size_t offset = 0, len;
+    PREPLAY replay = replay_create();
+    size_t* offsets;
+
+    while (replay && offset < context->size &&
+        (len = replay_parse(context->data + offset, context->size - offset, replay))){
+        if (count == capacity){
+            capacity = capacity?(capacity << 1):4096;
+            if (!(offsets = (size_t*)realloc(context->offsets, capacity * sizeof(size_t)))){
+                break;
+            }
+            context->offsets = offsets;
+        }
+
+        context->offsets[count++] = offset;
+        offset += len;
+    }
+
+    if (offset < context->size){
+        printf("Invalid data at offset %zu\n", offset);
+    }
+
+    replay_free(replay);
+    return count;
+}
+
+// _runBatch() : Check a batch of replays
+//
+static void _runBatch(void* task, uint8_t worker, void* param){
+    PCONTEXT context = (PCONTEXT)param;
+    PBATCH batch = (PBATCH)task;
+    PREPLAY replay = context->replays[worker];
+
+    for (uint32_t index = batch->first; index < batch->first + batch->count; index++){
+        replay_parse(context->data + context->offsets[index], context->size - context->offsets[index], replay);
+        _check(context->grids[worker], replay, &context->checks[index]);
+    }
+}
+
+// _check() : Play a replay again
+//
+static void _check(PGRID const grid, const REPLAY* replay, PCHECK check){
+    uint8_t result = REPLAY_CANCELLED;
+    uint16_t offset = 0, count = 0, revealed = 0;
+    uint32_t tick = 0;
+    int16_t steps;
+    GRID_STATS stats;
+    REPLAY_ACTION action;
+    COORD pos;
+    PBOX box;
+
+    check->level = replay->level;
+    check->result = replay->result;
+    check->time = replay->time;
+    check->bbbv = 0;
+
+    if (replay->truncated){
+        check->status = CHECK_TRUNCATED;
+        return;
+    }
+
+    if (replay->level > LEVEL_EXPERT || !grid_init(grid, (GAME_LEVEL)replay->level) ||
+        !grid_layMinesEx(grid, replay->seed)){
+        check->status = CHECK_GRID;
+        return;
+    }
+
+    if (grid_analyse(grid, &stats)){
+        check->bbbv = stats.bbbv;
+    }
+
+    while (replay_getAction(replay, &offset, &action)){
+        count++;
+        tick += action.delta;
+        if (REPLAY_CANCELLED != result){
+            check->status = CHECK_AFTER_END;
+            return;
+        }
+
+        if (action.box >= grid->size.col * grid->size.row){
+            check->status = CHECK_ACTION;
+            return;
+        }
+
+        pos.col = action.box % grid->size.col;
+        pos.row = action.box / grid->size.col;
+        box = BOX_AT_POS(grid, &pos);
+
+        // Same rules as in the game
+        switch (action.action){
+            case REPLAY_STEP:
+                if (GRID_STEP_MINE == (steps = grid_step(grid, &pos, NULL, NULL))){
+                    result = REPLAY_LOST;
+                }
+                else if ((revealed += steps) == grid->maxSteps){
+                    result = REPLAY_WON;
+                }
+                break;
+
+            case REPLAY_FLAG:
+                if (BOX_IS_COVERED(box)){
+                    box->state = (BS_FLAG == box->state)?BS_INITIAL:BS_FLAG;
+                }
+                break;
+
+            case REPLAY_QUESTION:
+                if (BOX_IS_COVERED(box)){
+                    box->state = (BS_QUESTION == box->state)?BS_INITIAL:BS_QUESTION;
+                }
+                break;
+
+            default:
+                check->status = CHECK_ACTION;
+                return;
+        }
+    }
+
+    if (count != replay->count || offset != replay->size){
+        check->status = CHECK_ACTION;
+        return;
+    }
+
+    // Lost when time is over
+    if (REPLAY_CANCELLED == result && replay->time >= MAX_TIME){
+        result = REPLAY_LOST;
+        tick = replay->time;
+    }
+
+    if (result != replay->result){
+        check->status = CHECK_RESULT;
+        return;
+    }
+
+    // The game ends with its last action (or later if cancelled)
+    check->status = (tick > MAX_TIME ||
+                    (REPLAY_CANCELLED == result && tick > replay->time) ||
+                    (REPLAY_CANCELLED != result && tick != replay->time))?CHECK_TIME:CHECK_VALID;
+}
+
+// _checkScores() : Search a valid game for each recorded score
+//
+static void _checkScores(PCONTEXT const context, uint32_t count, const char* file){
+    SCORE records[SCORE_FILE_RECORDS];
+    uint16_t generation;
+    uint32_t index;
+    PCHECK check;
+    BOOL damaged;
+    char buffer[16];
+    int id, total, found = 0;
+
+    if ((total = scores_readFile(file, records, &generation, &damaged)) < 0){
+        printf("Unable to read the scores in '%s'\n", file);
+        return;
+    }
+
+    printf("\nScores journal - generation %u%s\n", generation, damaged?" (damaged)":"");
+    printf("%-6s %-6s %8s %5s %s\n", "record", "level", "time", "3BV", "game");
+    for (id = 0; id < total; id++){
+        for (index = 0, check = context->checks; index < count; index++, check++){
+            if (CHECK_VALID == check->status && REPLAY_WON == check->result &&
+                check->level == records[id].level && check->time == records[id].time / TIMER_TICK_DURATION &&
+                (!records[id].bbbv || check->bbbv == records[id].bbbv)){
+                break;
+            }
+        }
+
+        if (index < count){
+            found++;
+            sprintf(buffer, "%u", index + 1);
+        }
+        else{
+            strcpy(buffer, "not found");
+        }
+
+        printf("%-6d %-6u %4u.%03u %5u %s\n", id + 1, records[id].level,
+                records[id].time / 1000, records[id].time % 1000, records[id].bbbv, buffer);
+    }
+
+    printf("%d / %d score(s) verified\n", found, total);
+}
+
+// EOF
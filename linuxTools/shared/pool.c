@@ -0,0 +1,241 @@
+//----------------------------------------------------------------------
+//--
+//--    pool.c
+//--
+//--            Work-stealing thread pool (Linux tools only)
+//--
+//----------------------------------------------------------------------
+
+#include "pool.h"
+
+#include <string.h>
+#include <unistd.h>
+
+// Parameters of a thread
+//
+typedef struct __poolWorker{
+    PPOOL pool;
+    uint8_t id;
+    pthread_t thread;
+} POOL_WORKER, * PPOOL_WORKER;
+
+static void* _worker(void* param);
+static BOOL _pop(PPOOL const pool, uint8_t id, void* task);
+static BOOL _steal(PPOOL const pool, uint8_t id, void* task);
+
+//  pool_create() : Create a pool
+//
+//  @workers : Count of threads (0 => count of CPUs)
+//  @capacity : Max. count of tasks per worker
+//  @taskSize : Size of a task in bytes
+//  @run : Function called for each task
+//  @param : Parameter given to the function
+//
+//  @return : pointer to the new pool or NULL
+//
+PPOOL pool_create(uint8_t workers, uint32_t capacity, size_t taskSize, POOL_TASK run, void* param){
+    PPOOL pool;
+    uint8_t id;
+
+    if (!capacity || !taskSize || !run){
+        return NULL;
+    }
+
+    if (!(pool = (PPOOL)malloc(sizeof(POOL)))){
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(POOL));
+    pool->workers = SET_IN_RANGE((workers?workers:pool_cpuCount()), 1, POOL_MAX_WORKERS);
+    pool->capacity = capacity;
+    pool->taskSize = taskSize;
+    pool->run = run;
+    pool->param = param;
+
+    if (!(pool->queues = (PPOOL_QUEUE)malloc(pool->workers * sizeof(POOL_QUEUE)))){
+        return pool_free(pool, TRUE);
+    }
+
+    memset(pool->queues, 0, pool->workers * sizeof(POOL_QUEUE));
+    for (id = 0; id < pool->workers; id++){
+        pthread_mutex_init(&pool->queues[id].lock, NULL);
+        if (!(pool->queues[id].tasks = (uint8_t*)malloc(capacity * taskSize))){
+            return pool_free(pool, TRUE);
+        }
+    }
+
+    return pool;
+}
+
+//  pool_push() : Add a task to the queue of a worker
+//
+//  @pool : Pointer to the pool
+//  @worker : ID of the worker
+//  @task : Task to copy
+//
+//  @return : TRUE if added
+//
+BOOL pool_push(PPOOL const pool, uint8_t worker, const void* task){
+    PPOOL_QUEUE queue;
+    BOOL done = FALSE;
+
+    if (pool && task && worker < pool->workers){
+        queue = &pool->queues[worker];
+        pthread_mutex_lock(&queue->lock);
+        if (queue->tail < pool->capacity){
+            memcpy(queue->tasks + queue->tail * pool->taskSize, task, pool->taskSize);
+            queue->tail++;
+            done = TRUE;
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    return done;
+}
+
+//  pool_run() : Run all the tasks
+//
+//  @pool : Pointer to the pool
+//
+//  @return : TRUE if all threads have been started
+//
+BOOL pool_run(PPOOL const pool){
+    POOL_WORKER workers[POOL_MAX_WORKERS];
+    uint8_t id, started = 0;
+
+    if (!pool){
+        return FALSE;
+    }
+
+    for (id = 0; id < pool->workers; id++){
+        workers[id].pool = pool;
+        workers[id].id = id;
+        if (0 == pthread_create(&workers[id].thread, NULL, _worker, &workers[id])){
+            started++;
+        }
+        else{
+            break;
+        }
+    }
+
+    // Tasks of a worker that couldn't start will be stolen
+    if (!started){
+        workers[0].pool = pool;
+        workers[0].id = 0;
+        _worker(&workers[0]);
+    }
+
+    for (id = 0; id < started; id++){
+        pthread_join(workers[id].thread, NULL);
+    }
+
+    return (started == pool->workers);
+}
+
+//  pool_cpuCount() : Count of online CPUs
+//
+//  @return : count of CPUs (at least 1)
+//
+uint8_t pool_cpuCount(){
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return (uint8_t)SET_IN_RANGE(count, 1, POOL_MAX_WORKERS);
+}
+
+//  pool_free() : Free memory used by a pool
+//
+//  @pool : Pointer to the pool
+//  @freeAll : if FALSE only the queues are freed. If TRUE pool memory
+//              will also be freed
+//
+//  @return : pointer to pool or NULL if freed
+//
+PPOOL pool_free(PPOOL const pool, BOOL freeAll){
+    uint8_t id;
+
+    if (pool){
+        if (pool->queues){
+            for (id = 0; id < pool->workers; id++){
+                pthread_mutex_destroy(&pool->queues[id].lock);
+                if (pool->queues[id].tasks){
+                    free(pool->queues[id].tasks);
+                }
+            }
+
+            free(pool->queues);
+            pool->queues = NULL;
+        }
+
+        if (freeAll){
+            free(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+//
+// Internal functions
+//
+
+// _worker() : A thread of the pool
+//
+static void* _worker(void* param){
+    PPOOL_WORKER worker = (PPOOL_WORKER)param;
+    PPOOL pool = worker->pool;
+    void* task = malloc(pool->taskSize);
+
+    if (task){
+        while (_pop(pool, worker->id, task) || _steal(pool, worker->id, task)){
+            pool->run(task, worker->id, pool->param);
+        }
+
+        free(task);
+    }
+
+    return NULL;
+}
+
+// _pop() : Newest task of the worker's own queue
+//
+static BOOL _pop(PPOOL const pool, uint8_t id, void* task){
+    PPOOL_QUEUE queue = &pool->queues[id];
+    BOOL found = FALSE;
+
+    pthread_mutex_lock(&queue->lock);
+    if (queue->tail > queue->head){
+        queue->tail--;
+        memcpy(task, queue->tasks + queue->tail * pool->taskSize, pool->taskSize);
+        found = TRUE;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    return found;
+}
+
+// _steal() : Oldest task of another queue
+//
+static BOOL _steal(PPOOL const pool, uint8_t id, void* task){
+    PPOOL_QUEUE queue;
+    uint8_t index;
+    BOOL found = FALSE;
+
+    for (index = 1; index < pool->workers && !found; index++){
+        queue = &pool->queues[(id + index) % pool->workers];
+        pthread_mutex_lock(&queue->lock);
+        if (queue->tail > queue->head){
+            memcpy(task, queue->tasks + queue->head * pool->taskSize, pool->taskSize);
+            queue->head++;
+            found = TRUE;
+        }
+        pthread_mutex_unlock(&queue->lock);
+    }
+
+    if (found){
+        __atomic_add_fetch(&pool->steals, 1, __ATOMIC_RELAXED);
+    }
+
+    return found;
+}
+
+// EOF
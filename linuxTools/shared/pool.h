@@ -0,0 +1,113 @@
+//----------------------------------------------------------------------
+//--
+//--    pool.h
+//--
+//--            Work-stealing thread pool (Linux tools only)
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_POOL_h__
+#define __GEE_MINES_POOL_h__    1
+
+#include "../../src/shared/casioCalcs.h"
+
+#include <pthread.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// Each worker owns a queue of tasks. A worker runs the tasks of its own
+// queue (newest first) and, when it's empty, steals the oldest task of
+// another queue. Tasks taking very different times (ie. expert vs
+// beginner games) are therefore spread across all the workers.
+//
+// All tasks are pushed before pool_run() : the pool ends when all the
+// queues are empty.
+//
+
+#define POOL_MAX_WORKERS    64
+
+// Function called for each task
+//
+//  @task : Pointer to a copy of the task
+//  @worker : ID of the worker running the task
+//  @param : Pool's parameter
+//
+typedef void (*POOL_TASK)(void* task, uint8_t worker, void* param);
+
+// A worker's queue
+//
+typedef struct __poolQueue{
+    pthread_mutex_t lock;
+    uint32_t head;          // Oldest task (stolen by others)
+    uint32_t tail;          // Newest task (run by the owner)
+    uint8_t* tasks;
+} POOL_QUEUE, * PPOOL_QUEUE;
+
+// The pool
+//
+typedef struct __pool{
+    uint8_t workers;
+    uint32_t capacity;      // Max. tasks per queue
+    size_t taskSize;
+    POOL_TASK run;
+    void* param;
+    PPOOL_QUEUE queues;
+    uint32_t steals;        // # of stolen tasks
+} POOL, * PPOOL;
+
+//  pool_create() : Create a pool
+//
+//  @workers : Count of threads (0 => count of CPUs)
+//  @capacity : Max. count of tasks per worker
+//  @taskSize : Size of a task in bytes
+//  @run : Function called for each task
+//  @param : Parameter given to the function
+//
+//  @return : pointer to the new pool or NULL
+//
+PPOOL pool_create(uint8_t workers, uint32_t capacity, size_t taskSize, POOL_TASK run, void* param);
+
+//  pool_push() : Add a task to the queue of a worker
+//
+//  @pool : Pointer to the pool
+//  @worker : ID of the worker
+//  @task : Task to copy
+//
+//  @return : TRUE if added
+//
+BOOL pool_push(PPOOL const pool, uint8_t worker, const void* task);
+
+//  pool_run() : Run all the tasks
+//
+//  @pool : Pointer to the pool
+//
+//  @return : TRUE if all threads have been started
+//
+BOOL pool_run(PPOOL const pool);
+
+//  pool_cpuCount() : Count of online CPUs
+//
+//  @return : count of CPUs (at least 1)
+//
+uint8_t pool_cpuCount();
+
+//  pool_free() : Free memory used by a pool
+//
+//  @pool : Pointer to the pool
+//  @freeAll : if FALSE only the queues are freed. If TRUE pool memory
+//              will also be freed
+//
+//  @return : pointer to pool or NULL if freed
+//
+PPOOL pool_free(PPOOL const pool, BOOL freeAll);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_POOL_h__
+
+// EOF
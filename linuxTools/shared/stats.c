@@ -0,0 +1,85 @@
+//----------------------------------------------------------------------
+//--
+//--    stats.c
+//--
+//--            Basic statistics for the Linux tools
+//--
+//----------------------------------------------------------------------
+
+#include "stats.h"
+
+#include <math.h>
+
+//  stats_add() : Add a value to a series
+//
+//  @stats : Pointer to the series
+//  @value : Value to add
+//
+void stats_add(PSTATS const stats, double value){
+    stats->count++;
+    stats->sum += value;
+    stats->sumSq += value * value;
+}
+
+//  stats_merge() : Merge two series
+//
+//  @dest : Destination series
+//  @src : Series to add
+//
+void stats_merge(PSTATS const dest, const STATS* src){
+    dest->count += src->count;
+    dest->sum += src->sum;
+    dest->sumSq += src->sumSq;
+}
+
+//  stats_mean() : Mean of a series with its 95% confidence interval
+//
+//  @stats : Pointer to the series
+//  @interval : Mean and interval
+//
+void stats_mean(const STATS* stats, PINTERVAL const interval){
+    double variance, half = 0.0;
+
+    if (!stats->count){
+        interval->value = interval->low = interval->high = 0.0;
+        return;
+    }
+
+    interval->value = stats->sum / stats->count;
+    if (stats->count > 1){
+        variance = (stats->sumSq - stats->sum * interval->value) / (stats->count - 1);
+        half = STATS_Z95 * sqrt((variance > 0.0?variance:0.0) / stats->count);
+    }
+
+    interval->low = interval->value - half;
+    interval->high = interval->value + half;
+}
+
+//  stats_wilson() : Wilson score interval of a ratio (95%)
+//
+//  The interval stays valid for small counts and ratios close to 0 or 1
+//
+//  @success : Count of successes
+//  @count : Count of trials
+//  @interval : Ratio and interval
+//
+void stats_wilson(uint32_t success, uint32_t count, PINTERVAL const interval){
+    double p, z2n, center, half;
+
+    if (!count){
+        interval->value = interval->low = 0.0;
+        interval->high = 1.0;
+        return;
+    }
+
+    p = (double)success / count;
+    z2n = STATS_Z95 * STATS_Z95 / count;
+    center = (p + z2n / 2.0) / (1.0 + z2n);
+    half = STATS_Z95 * sqrt(p * (1.0 - p) / count + z2n / (4.0 * count)) / (1.0 + z2n);
+
+    interval->value = p;
+    interval->low = center - half;
+    interval->high = center + half;
+}
+
+// EOF
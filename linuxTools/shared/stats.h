@@ -0,0 +1,74 @@
+//----------------------------------------------------------------------
+//--
+//--    stats.h
+//--
+//--            Basic statistics for the Linux tools
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_STATS_h__
+#define __GEE_MINES_STATS_h__    1
+
+#include "../../src/shared/casioCalcs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+// z value of a 95% confidence interval
+#define STATS_Z95       1.959964
+
+// A series of values
+//
+typedef struct __stats{
+    uint32_t count;
+    double sum;
+    double sumSq;
+} STATS, * PSTATS;
+
+// An interval
+//
+typedef struct __interval{
+    double value;
+    double low;
+    double high;
+} INTERVAL, * PINTERVAL;
+
+//  stats_add() : Add a value to a series
+//
+//  @stats : Pointer to the series
+//  @value : Value to add
+//
+void stats_add(PSTATS const stats, double value);
+
+//  stats_merge() : Merge two series
+//
+//  @dest : Destination series
+//  @src : Series to add
+//
+void stats_merge(PSTATS const dest, const STATS* src);
+
+//  stats_mean() : Mean of a series with its 95% confidence interval
+//
+//  @stats : Pointer to the series
+//  @interval : Mean and interval
+//
+void stats_mean(const STATS* stats, PINTERVAL const interval);
+
+//  stats_wilson() : Wilson score interval of a ratio (95%)
+//
+//  The interval stays valid for small counts and ratios close to 0 or 1
+//
+//  @success : Count of successes
+//  @count : Count of trials
+//  @interval : Ratio and interval
+//
+void stats_wilson(uint32_t success, uint32_t count, PINTERVAL const interval);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_STATS_h__
+
+// EOF
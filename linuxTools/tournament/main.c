@@ -0,0 +1,346 @@
+//----------------------------------------------------------------------
+//--
+//--    tournament - main.c
+//--
+//--            Strategies of the bots on identical grids
+//--
+//----------------------------------------------------------------------
+//
+//  usage : tournament [-n games] [-t threads] [-l levels] [-s strategies]
+//                     [-b seed] [-c shard] [-o file]
+//
+//  All the strategies play the same seeded grids : the differences only
+//  come from the strategies. Games are split in shards, each shard is a
+//  task of the work-stealing pool and is played by all the strategies.
+//
+//  Results are written as CSV (one line per (level, strategy) pair).
+//  "better" and "worse" count the grids won (lost) by a strategy and
+//  lost (won) by the first one.
+//
+
+#include "../../src/bot.h"
+#include "../shared/pool.h"
+#include "../shared/stats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Default values
+//
+#define DEF_GAMES           10000
+#define DEF_SHARD           32
+#define DEF_SEED            0x6765654Du
+
+#define LEVEL_COUNT         (LEVEL_EXPERT + 1)
+#define MAX_STRATEGIES      8
+
+// Results of a (level, strategy) pair
+//
+typedef struct __result{
+    uint32_t wins;
+    uint32_t better;        // Won, first strategy lost
+    uint32_t worse;         // Lost, first strategy won
+    STATS moves;
+    STATS revealed;         // Ratio of revealed boxes
+    STATS efficiency;       // 3BV / moves of won games
+} RESULT, * PRESULT;
+
+// A task : a shard of grids
+//
+typedef struct __shard{
+    GAME_LEVEL level;
+    uint32_t first;         // Index of the first grid
+    uint32_t count;
+} SHARD, * PSHARD;
+
+// Shared context
+//
+typedef struct __context{
+    const BOT_STRATEGY* strategies[MAX_STRATEGIES];
+    uint8_t strategyCount;
+    RESULT results[LEVEL_COUNT][MAX_STRATEGIES];
+    pthread_mutex_t lock;
+    PBOT bots[POOL_MAX_WORKERS];    // One bot per worker
+    uint32_t seed;
+} CONTEXT, * PCONTEXT;
+
+static BOT_ACTION _playCorners(PBOT_VIEW const view, PCOORD pos, void* param);
+
+// Strategies of the tournament : built-in ones and local ones
+//
+static const BOT_STRATEGY _corners = {"corners", _playCorners, FALSE, NULL};
+
+static void _usage(const char* app);
+static const BOT_STRATEGY* _findStrategy(const char* name);
+static BOOL _parseStrategies(PCONTEXT const context, const char* list);
+static void _runShard(void* task, uint8_t worker, void* param);
+static void _writeResults(PCONTEXT const context, FILE* file, const char* levels);
+
+int main(int argc, char* argv[]){
+    static CONTEXT context;
+    const char* levels = "012";
+    const char* output = NULL;
+    uint32_t games = DEF_GAMES, shardSize = DEF_SHARD, index;
+    uint8_t threads = 0, id, worker = 0;
+    SHARD shard;
+    PPOOL pool;
+    FILE* file = stdout;
+    int opt;
+
+    context.seed = DEF_SEED;
+
+    while (-1 != (opt = getopt(argc, argv, "n:t:l:s:b:c:o:h"))){
+        switch (opt){
+            case 'n':
+                games = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                threads = (uint8_t)atoi(optarg);
+                break;
+
+            case 'l':
+                levels = optarg;
+                break;
+
+            case 's':
+                if (!_parseStrategies(&context, optarg)){
+                    _usage(argv[0]);
+                    return 1;
+                }
+                break;
+
+            case 'b':
+                context.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'c':
+                shardSize = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'o':
+                output = optarg;
+                break;
+
+            default:
+                _usage(argv[0]);
+                return 1;
+        }
+    }
+
+    // All strategies by default
+    if (!context.strategyCount){
+        for (id = 0; id < BOT_STRATEGY_COUNT; id++){
+            context.strategies[context.strategyCount++] = bot_getStrategy(id);
+        }
+        context.strategies[context.strategyCount++] = &_corners;
+    }
+
+    for (const char* level = levels; *level; level++){
+        if (*level < '0' || *level >= '0' + LEVEL_COUNT){
+            _usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (!games || !shardSize || !*levels){
+        _usage(argv[0]);
+        return 1;
+    }
+
+    if (!(pool = pool_create(threads, (games / shardSize + 1) * strlen(levels), sizeof(SHARD), _runShard, &context))){
+        printf("Unable to create the pool\n");
+        return 1;
+    }
+
+    pthread_mutex_init(&context.lock, NULL);
+    for (id = 0; id < pool->workers; id++){
+        if (!(context.bots[id] = bot_create())){
+            printf("Unable to create the bots\n");
+            return 1;
+        }
+    }
+
+    for (const char* level = levels; *level; level++){
+        for (index = 0; index < games; index += shardSize){
+            shard.level = (GAME_LEVEL)(*level - '0');
+            shard.first = index;
+            shard.count = MIN_VAL(shardSize, games - index);
+            pool_push(pool, worker, &shard);
+            worker = (worker + 1) % pool->workers;
+        }
+    }
+
+    pool_run(pool);
+
+    if (output && !(file = fopen(output, "w"))){
+        printf("Unable to create '%s'\n", output);
+        file = stdout;
+    }
+
+    _writeResults(&context, file, levels);
+    if (file != stdout){
+        fclose(file);
+    }
+
+    // Free
+    for (id = 0; id < pool->workers; id++){
+        bot_free(context.bots[id], TRUE);
+    }
+    pthread_mutex_destroy(&context.lock);
+    pool_free(pool, TRUE);
+
+    return 0;
+}
+
+// _usage() : Show command-line options
+//
+static void _usage(const char* app){
+    printf("usage : %s [-n games] [-t threads] [-l levels] [-s strategies]\n", app);
+    printf("\t\t[-b seed] [-c shard] [-o file]\n\n");
+    printf("\t-n : grids per level (%d)\n", DEF_GAMES);
+    printf("\t-t : count of threads (count of CPUs)\n");
+    printf("\t-l : levels, 0 = beginner, 1 = medium, 2 = expert (012)\n");
+    printf("\t-s : comma-separated list of strategies (");
+    for (uint8_t id = 0; id < BOT_STRATEGY_COUNT; id++){
+        printf("%s,", bot_getStrategy(id)->name);
+    }
+    printf("%s)\n", _corners.name);
+    printf("\t-b : seed of the series (0x%08X)\n", DEF_SEED);
+    printf("\t-c : grids per task (%d)\n", DEF_SHARD);
+    printf("\t-o : CSV file (stdout)\n");
+}
+
+// _findStrategy() : Find a strategy by its name
+//
+static const BOT_STRATEGY* _findStrategy(const char* name){
+    return strcmp(name, _corners.name)?bot_findStrategy(name):&_corners;
+}
+
+// _parseStrategies() : Read a list of strategies
+//
+static BOOL _parseStrategies(PCONTEXT const context, const char* list){
+    const BOT_STRATEGY* strategy;
+    char buffer[128];
+    char* name;
+
+    strncpy(buffer, list, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    context->strategyCount = 0;
+
+    for (name = strtok(buffer, ","); name; name = strtok(NULL, ",")){
+        if (!(strategy = _findStrategy(name)) || context->strategyCount >= MAX_STRATEGIES){
+            return FALSE;
+        }
+        context->strategies[context->strategyCount++] = strategy;
+    }
+
+    return (context->strategyCount > 0);
+}
+
+// _runShard() : All the strategies play a shard of grids
+//
+static void _runShard(void* task, uint8_t worker, void* param){
+    PCONTEXT context = (PCONTEXT)param;
+    PSHARD shard = (PSHARD)task;
+    RESULT results[MAX_STRATEGIES];
+    PRESULT result;
+    BOT_GAME game;
+    BOOL firstWon = FALSE;
+    uint32_t index, seed;
+    uint8_t id;
+
+    memset(results, 0, sizeof(results));
+
+    for (index = shard->first; index < shard->first + shard->count; index++){
+        seed = bot_gameSeed(context->seed, shard->level, index);
+        for (id = 0; id < context->strategyCount; id++){
+            if (!bot_play(context->bots[worker], shard->level, seed, context->strategies[id], &game)){
+                continue;
+            }
+
+            result = &results[id];
+            stats_add(&result->moves, game.moves);
+            stats_add(&result->revealed, (double)game.revealed / context->bots[worker]->grid->maxSteps);
+            if (game.won){
+                result->wins++;
+                stats_add(&result->efficiency, (double)game.bbbv / game.moves);
+            }
+
+            if (!id){
+                firstWon = game.won;
+            }
+            else{
+                result->better += (game.won && !firstWon);
+                result->worse += (!game.won && firstWon);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&context->lock);
+    for (id = 0; id < context->strategyCount; id++){
+        result = &context->results[shard->level][id];
+        result->wins += results[id].wins;
+        result->better += results[id].better;
+        result->worse += results[id].worse;
+        stats_merge(&result->moves, &results[id].moves);
+        stats_merge(&result->revealed, &results[id].revealed);
+        stats_merge(&result->efficiency, &results[id].efficiency);
+    }
+    pthread_mutex_unlock(&context->lock);
+}
+
+// _writeResults() : Aggregated results as CSV
+//
+static void _writeResults(PCONTEXT const context, FILE* file, const char* levels){
+    const char* names[LEVEL_COUNT] = {"beginner", "medium", "expert"};
+    INTERVAL rate, moves, revealed, efficiency;
+    PRESULT result;
+    GAME_LEVEL level;
+
+    fprintf(file, "level,strategy,games,wins,win_rate,win_low,win_high,moves,moves_ci,revealed,bbbv_per_move,better,worse\n");
+    for (; *levels; levels++){
+        level = (GAME_LEVEL)(*levels - '0');
+        for (uint8_t id = 0; id < context->strategyCount; id++){
+            result = &context->results[level][id];
+            stats_wilson(result->wins, result->moves.count, &rate);
+            stats_mean(&result->moves, &moves);
+            stats_mean(&result->revealed, &revealed);
+            stats_mean(&result->efficiency, &efficiency);
+            fprintf(file, "%s,%s,%u,%u,%.4f,%.4f,%.4f,%.2f,%.2f,%.4f,%.4f,%u,%u\n",
+                names[level], context->strategies[id]->name, result->moves.count, result->wins,
+                rate.value, rate.low, rate.high, moves.value, moves.high - moves.value,
+                revealed.value, efficiency.value, result->better, result->worse);
+        }
+    }
+}
+
+// _playCorners() : Solved boxes, then unsolved corners, then the lowest risk
+//
+//  Corners have less neighbours : they are more likely to open an area
+//
+static BOT_ACTION _playCorners(PBOT_VIEW const view, PCOORD pos, void* param){
+    COORD corners[4] = {
+        {0, 0}, {view->grid->size.col - 1, 0},
+        {0, view->grid->size.row - 1}, {view->grid->size.col - 1, view->grid->size.row - 1}
+    };
+    (void)param;    // No parameter
+
+    solver_solve(view->solver);
+    if (SOLVER_SAFE == solver_getHint(view->solver, pos)){
+        return BOT_ACTION_STEP;
+    }
+
+    for (uint8_t id = 0; id < 4; id++){
+        if (BOX_IS_COVERED(BOX_AT_POS(view->grid, &corners[id])) &&
+            SOLVER_UNKNOWN == solver_getBox(view->solver, &corners[id])){
+            *pos = corners[id];
+            return BOT_ACTION_STEP;
+        }
+    }
+
+    return (SOLVER_MINE != solver_getHint(view->solver, pos))?BOT_ACTION_STEP:BOT_ACTION_NONE;
+}
+
+// EOF
@@ -0,0 +1,294 @@
+//----------------------------------------------------------------------
+//--
+//--    winRate - main.c
+//--
+//--            Monte Carlo estimation of the win rate of the bots
+//--
+//----------------------------------------------------------------------
+//
+//  usage : winRate [-n games] [-t threads] [-l levels] [-s strategies]
+//                  [-p precision] [-m min. games] [-b seed]
+//
+//  Each (level, strategy) pair plays up to "games" games. The games are
+//  split in batches spread across the threads of a work-stealing pool.
+//  A pair stops as soon as the 95% interval of its win rate is tight
+//  enough.
+//
+
+#include "../../src/bot.h"
+#include "../shared/pool.h"
+#include "../shared/stats.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Default values
+//
+#define DEF_GAMES           100000
+#define DEF_MIN_GAMES       1000
+#define DEF_PRECISION       0.005   // Half-width of the win rate interval
+#define DEF_SEED            0x6765654Du
+
+#define BATCH_SIZE          64      // Games per task
+
+#define LEVEL_COUNT         (LEVEL_EXPERT + 1)
+#define MAX_PAIRS           (LEVEL_COUNT * BOT_STRATEGY_COUNT)
+
+// Results of a (level, strategy) pair
+//
+typedef struct __pair{
+    GAME_LEVEL level;
+    const BOT_STRATEGY* strategy;
+    pthread_mutex_t lock;
+    uint32_t wins;
+    STATS moves;            // All games
+    STATS efficiency;       // 3BV / moves of won games
+    BOOL done;              // Interval is tight enough
+} PAIR, * PPAIR;
+
+// A task : a batch of games of a pair
+//
+typedef struct __batch{
+    uint8_t pair;
+    uint32_t first;         // Index of the first game
+    uint32_t count;
+} BATCH, * PBATCH;
+
+// Shared context
+//
+typedef struct __context{
+    PAIR pairs[MAX_PAIRS];
+    uint8_t pairCount;
+    PBOT bots[POOL_MAX_WORKERS];    // One bot per worker
+    uint32_t seed;
+    uint32_t minGames;
+    double precision;
+} CONTEXT, * PCONTEXT;
+
+static void _usage(const char* app);
+static BOOL _parseStrategies(const char* list, BOOL* strategies);
+static void _runBatch(void* task, uint8_t worker, void* param);
+static void _showResults(PCONTEXT const context);
+
+int main(int argc, char* argv[]){
+    static CONTEXT context;
+    const char* levels = "012";
+    BOOL strategies[BOT_STRATEGY_COUNT] = {TRUE, TRUE, TRUE};
+    uint32_t games = DEF_GAMES, index, batches = 0;
+    uint8_t threads = 0, id, worker = 0;
+    BATCH batch;
+    PPOOL pool;
+    int opt;
+
+    context.seed = DEF_SEED;
+    context.minGames = DEF_MIN_GAMES;
+    context.precision = DEF_PRECISION;
+
+    while (-1 != (opt = getopt(argc, argv, "n:t:l:s:p:m:b:h"))){
+        switch (opt){
+            case 'n':
+                games = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 't':
+                threads = (uint8_t)atoi(optarg);
+                break;
+
+            case 'l':
+                levels = optarg;
+                break;
+
+            case 's':
+                if (!_parseStrategies(optarg, strategies)){
+                    _usage(argv[0]);
+                    return 1;
+                }
+                break;
+
+            case 'p':
+                context.precision = atof(optarg);
+                break;
+
+            case 'm':
+                context.minGames = (uint32_t)strtoul(optarg, NULL, 10);
+                break;
+
+            case 'b':
+                context.seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            default:
+                _usage(argv[0]);
+                return 1;
+        }
+    }
+
+    // Pairs
+    for (const char* level = levels; *level; level++){
+        if (*level < '0' || *level >= '0' + LEVEL_COUNT){
+            _usage(argv[0]);
+            return 1;
+        }
+
+        for (id = 0; id < BOT_STRATEGY_COUNT; id++){
+            if (strategies[id] && context.pairCount < MAX_PAIRS){
+                PPAIR pair = &context.pairs[context.pairCount++];
+                pair->level = (GAME_LEVEL)(*level - '0');
+                pair->strategy = bot_getStrategy(id);
+                pthread_mutex_init(&pair->lock, NULL);
+            }
+        }
+    }
+
+    if (!games || !context.pairCount){
+        _usage(argv[0]);
+        return 1;
+    }
+
+    batches = (games + BATCH_SIZE - 1) / BATCH_SIZE;
+    if (!(pool = pool_create(threads, batches * context.pairCount, sizeof(BATCH), _runBatch, &context))){
+        printf("Unable to create the pool\n");
+        return 1;
+    }
+
+    for (id = 0; id < pool->workers; id++){
+        if (!(context.bots[id] = bot_create())){
+            printf("Unable to create the bots\n");
+            return 1;
+        }
+    }
+
+    // Batches of all pairs are interleaved so that early stops
+    // free the workers as soon as possible
+    for (index = 0; index < games; index += BATCH_SIZE){
+        for (id = 0; id < context.pairCount; id++){
+            batch.pair = id;
+            batch.first = index;
+            batch.count = MIN_VAL(BATCH_SIZE, games - index);
+            pool_push(pool, worker, &batch);
+            worker = (worker + 1) % pool->workers;
+        }
+    }
+
+    printf("%d thread(s), up to %u games per pair, seed 0x%08X\n\n", pool->workers, games, context.seed);
+    pool_run(pool);
+    _showResults(&context);
+    printf("\n%u stolen batches\n", pool->steals);
+
+    // Free
+    for (id = 0; id < pool->workers; id++){
+        bot_free(context.bots[id], TRUE);
+    }
+    for (id = 0; id < context.pairCount; id++){
+        pthread_mutex_destroy(&context.pairs[id].lock);
+    }
+    pool_free(pool, TRUE);
+
+    return 0;
+}
+
+// _usage() : Show command-line options
+//
+static void _usage(const char* app){
+    printf("usage : %s [-n games] [-t threads] [-l levels] [-s strategies]\n", app);
+    printf("\t\t[-p precision] [-m min. games] [-b seed]\n\n");
+    printf("\t-n : max. games per (level, strategy) pair (%d)\n", DEF_GAMES);
+    printf("\t-t : count of threads (count of CPUs)\n");
+    printf("\t-l : levels, 0 = beginner, 1 = medium, 2 = expert (012)\n");
+    printf("\t-s : comma-separated list of strategies (");
+    for (uint8_t id = 0; id < BOT_STRATEGY_COUNT; id++){
+        printf("%s%s", id?",":"", bot_getStrategy(id)->name);
+    }
+    printf(")\n");
+    printf("\t-p : stop when the win rate is known within +/- precision (%.3f)\n", DEF_PRECISION);
+    printf("\t-m : min. games before an early stop (%d)\n", DEF_MIN_GAMES);
+    printf("\t-b : seed of the series (0x%08X)\n", DEF_SEED);
+}
+
+// _parseStrategies() : Read a list of strategies
+//
+static BOOL _parseStrategies(const char* list, BOOL* strategies){
+    char buffer[128];
+    char* name;
+    uint8_t id;
+
+    strncpy(buffer, list, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    memset(strategies, 0, BOT_STRATEGY_COUNT * sizeof(BOOL));
+
+    for (name = strtok(buffer, ","); name; name = strtok(NULL, ",")){
+        for (id = 0; id < BOT_STRATEGY_COUNT && strcmp(name, bot_getStrategy(id)->name); id++);
+        if (id == BOT_STRATEGY_COUNT){
+            return FALSE;
+        }
+        strategies[id] = TRUE;
+    }
+
+    return TRUE;
+}
+
+// _runBatch() : Play a batch of games
+//
+static void _runBatch(void* task, uint8_t worker, void* param){
+    PCONTEXT context = (PCONTEXT)param;
+    PBATCH batch = (PBATCH)task;
+    PPAIR pair = &context->pairs[batch->pair];
+    STATS moves = {0}, efficiency = {0};
+    uint32_t wins = 0, index;
+    INTERVAL rate;
+    BOT_GAME game;
+
+    if (__atomic_load_n(&pair->done, __ATOMIC_RELAXED)){
+        return;     // Early stop
+    }
+
+    for (index = batch->first; index < batch->first + batch->count; index++){
+        if (bot_play(context->bots[worker], pair->level,
+                bot_gameSeed(context->seed, pair->level, index), pair->strategy, &game)){
+            stats_add(&moves, game.moves);
+            if (game.won){
+                wins++;
+                stats_add(&efficiency, (double)game.bbbv / game.moves);
+            }
+        }
+    }
+
+    pthread_mutex_lock(&pair->lock);
+    pair->wins += wins;
+    stats_merge(&pair->moves, &moves);
+    stats_merge(&pair->efficiency, &efficiency);
+    stats_wilson(pair->wins, pair->moves.count, &rate);
+    if (pair->moves.count >= context->minGames &&
+        (rate.high - rate.low) / 2.0 <= context->precision){
+        __atomic_store_n(&pair->done, TRUE, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&pair->lock);
+}
+
+// _showResults() : Results of all the pairs
+//
+static void _showResults(PCONTEXT const context){
+    const char* levels[LEVEL_COUNT] = {"beginner", "medium", "expert"};
+    INTERVAL rate, moves, efficiency;
+    PPAIR pair;
+
+    printf("%-9s %-8s %8s %7s %17s %14s %14s\n",
+            "level", "strategy", "games", "win %", "95% interval", "moves", "3BV/move");
+    for (uint8_t id = 0; id < context->pairCount; id++){
+        pair = &context->pairs[id];
+        stats_wilson(pair->wins, pair->moves.count, &rate);
+        stats_mean(&pair->moves, &moves);
+        stats_mean(&pair->efficiency, &efficiency);
+        printf("%-9s %-8s %8u %7.2f  [%6.2f - %6.2f] %7.1f +/-%4.1f %7.3f +/-%4.3f%s\n",
+                levels[pair->level], pair->strategy->name, pair->moves.count,
+                100.0 * rate.value, 100.0 * rate.low, 100.0 * rate.high,
+                moves.value, moves.high - moves.value,
+                efficiency.value, efficiency.high - efficiency.value,
+                pair->done?"":" *");
+    }
+
+    printf("\n* : interval is wider than expected\n");
+}
+
+// EOF
@@ -10,22 +10,40 @@
 #include "grid.h"
 #include <stdint.h>
 
-#ifdef DEST_CASIO_CALC
 #include "consts.h"
 #include "shared/menu.h"
-#else
+
+#ifndef DEST_CASIO_CALC
 #include <stdio.h>
-#endif // #ifdef DEST_CASIO_CALC
+#endif // #ifndef DEST_CASIO_CALC
 
 #include <string.h>
 
+static void _drawChrome(PBOARD const board);
+static uint16_t _setChromeStrips(PRECT const strips, CALC_ORIENTATION orientation, PRECT const rect, uint8_t thickness);
+static uint16_t _setStrip(PRECT const strip, int x, int y, int w, int h);
+static void _copyChrome(PBOARD const board, BOOL save);
+
+// Images
 #ifdef DEST_CASIO_CALC
-    // Images
     extern bopti_image_t g_boxes;
+    extern bopti_image_t g_boxes12;
+    extern bopti_image_t g_boxes8;
     extern bopti_image_t g_smileys;
     extern bopti_image_t g_leds;
     extern bopti_image_t g_scroll;
-#endif // #ifndef DEST_CASIO_CALC
+#else
+    bopti_image_t g_boxes = RENDER_IMAGE("boxes.png");
+    bopti_image_t g_boxes12 = RENDER_IMAGE("boxes-12.png");
+    bopti_image_t g_boxes8 = RENDER_IMAGE("boxes-8.png");
+    bopti_image_t g_smileys = RENDER_IMAGE("smileys.png");
+    bopti_image_t g_leds = RENDER_IMAGE("leds.png");
+    bopti_image_t g_scroll = RENDER_IMAGE("scroll.png");
+#endif // #ifdef DEST_CASIO_CALC
+
+// Boxes for each zoom
+static const uint8_t _boxSizes[ZOOM_COUNT] = {BOX_WIDTH, 12, 8};
+static bopti_image_t* const _boxImages[ZOOM_COUNT] = {&g_boxes, &g_boxes12, &g_boxes8};
 
 //  board_create() : Create an empty board
 //
@@ -41,6 +59,13 @@ PBOARD board_create(){
     // Board is empty !
     memset(board, 0, size);
     board->grid = grid_create();
+    board->solver = solver_create();
+    board->replay = replay_create();
+    board->journal = journal_create();
+    board->minimap = minimap_create();
+#ifdef _DEBUG_
+    board->heatmap = heatmap_create();
+#endif // #ifdef _DEBUG_
     board_setGameStateEx(board, STATE_WAITING, TRUE);
     return board;
 }
@@ -58,15 +83,32 @@ BOOL board_init(PBOARD const board, GAME_LEVEL level){
     }
 
     grid_layMines(board->grid); // Put mines
+    board_reset(board);
+    return TRUE;
+}
+
+//  board_reset() : Start a game with the current grid
+//
+//  @board : Pointer to the board (mines must be laid)
+//
+void board_reset(PBOARD const board){
+    solver_init(board->solver, board->grid);
+    replay_init(board->replay, board->grid);
+    journal_clear(board->journal);
+    minimap_init(board->minimap, board->grid);
+#ifdef _DEBUG_
+    heatmap_init(board->heatmap, board->grid, board->solver);
+#endif // #ifdef _DEBUG_
     board_setOrientation(board, board->orientation);
 
     // New game !
     board_setGameStateEx(board, STATE_WAITING, TRUE);
     board->minesLeft = (int8_t)board->grid->mines;
     board->time = 0;
+    chrono_reset(&board->chrono, 0);
     board->steps = 0;
-
-    return TRUE;
+    board->cursor = (COORD){.col = 0, .row = 0};
+    board->practice = FALSE;
 }
 
 //  board_setSmileyEx() : Change the state of a game
@@ -93,6 +135,7 @@ void board_setGameStateEx(PBOARD const board, GAME_STATE state, BOOL redraw){
     BOOL redrawGrid = FALSE;
     PBOX box = NULL;
 
+    TRACE(TRACE_STATE, state, redraw);
     board->gameState = state;
 
     switch (state){
@@ -137,9 +180,14 @@ void board_setGameStateEx(PBOARD const board, GAME_STATE state, BOOL redraw){
         case STATE_PLAYING:
             board_setSmileyEx(board, SMILEY_HAPPY, redraw);
             break;
+
+        case STATE_SUSPENDED:
+            break;  // Nothing has changed
     } // switch
 
     if (redrawGrid){
+        minimap_invalidate(board->minimap);     // Many boxes have changed
+        board_drawMinimap(board);
         board_drawGridEx(board, redraw);
     }
 }
@@ -153,6 +201,19 @@ void board_setGameStateEx(PBOARD const board, GAME_STATE state, BOOL redraw){
 void board_free(PBOARD const board, BOOL freeAll){
     if (board){
         board->grid = grid_free(board->grid, TRUE);
+        board->solver = solver_free(board->solver, TRUE);
+        replay_free(board->replay);
+        board->replay = NULL;
+        journal_free(board->journal);
+        board->journal = NULL;
+        board->minimap = minimap_free(board->minimap);
+#ifdef _DEBUG_
+        board->heatmap = heatmap_free(board->heatmap, TRUE);
+#endif // #ifdef _DEBUG_
+        if (board->chrome){
+            free(board->chrome);
+            board->chrome = NULL;
+        }
 
         if (freeAll){
             free(board);
@@ -174,8 +235,8 @@ void board_free(PBOARD const board, BOOL freeAll){
 //
 BOOL board_Pos2Point(PBOARD const board, PCOORD const pos, PPOINT pt){
     if (board && pos && pt){
-        pt->x = board->gridRect.x + BOX_WIDTH * (pos->col - board->viewPort.visibleFrame.x);
-        pt->y = board->gridRect.y + BOX_HEIGHT * (pos->row - board->viewPort.visibleFrame.y);
+        pt->x = board->gridRect.x + board->boxSize * (pos->col - board->viewPort.visibleFrame.x);
+        pt->y = board->gridRect.y + board->boxSize * (pos->row - board->viewPort.visibleFrame.y);
         return TRUE;
     }
 
@@ -198,6 +259,40 @@ BOOL board_isBoxVisible(PBOARD const board, PCOORD const pos){
             pos->row < (board->viewPort.visibleFrame.y + board->viewPort.visibleFrame.h));
 }
 
+// board_showBox() : Scroll the viewport to make a box visible
+//
+//  @board : pointer to the board
+//  @pos : Coordindate of the box in the grid
+//
+//  @return TRUE if the viewport has moved
+//
+BOOL board_showBox(PBOARD const board, PCOORD const pos){
+    PRECT frame = &board->viewPort.visibleFrame;
+    RECT old;
+
+    copyRect(&old, frame);
+
+    if (pos->col < frame->x){
+        frame->x = pos->col;
+    }
+    else{
+        if (pos->col >= frame->x + frame->w){
+            frame->x = pos->col - frame->w + 1;
+        }
+    }
+
+    if (pos->row < frame->y){
+        frame->y = pos->row;
+    }
+    else{
+        if (pos->row >= frame->y + frame->h){
+            frame->y = pos->row - frame->h + 1;
+        }
+    }
+
+    return (old.x != frame->x || old.y != frame->y);
+}
+
 //  board_drawEx() : Draw the whole board
 //
 //  @board : Pointer to the board
@@ -206,18 +301,28 @@ BOOL board_isBoxVisible(PBOARD const board, PCOORD const pos){
 //
 void board_drawEx(PBOARD const board, BOOL menu, BOOL update){
     if (board->grid && board->grid->boxes){
-#ifdef DEST_CASIO_CALC
-        drect(0, 0, CASIO_WIDTH - 1, CASIO_HEIGHT - 1 - (menu?MENUBAR_DEF_HEIGHT:0), BKGROUND_COLOUR);
-#endif // #ifdef DEST_CASIO_CALC
+        uint16_t rows = CASIO_HEIGHT - (menu?MENUBAR_DEF_HEIGHT:0);
 
-        // Stats
-        board_drawBorder(board->orientation, &board->statRect, STAT_BORDER);
+        // Background and borders
+        drect(0, 0, CASIO_WIDTH - 1, rows - 1, BKGROUND_COLOUR);
+        if (board->chrome && board->chromeKey == BOARD_CHROME_KEY(board)){
+            _copyChrome(board, FALSE);
+        }
+        else{
+            _drawChrome(board);
+        }
+
+        // Stats (the background has erased the digits)
+        board_invalidateCounter(&board->minesCounter);
+        board_invalidateCounter(&board->timeCounter);
         board_drawMinesLeftEx(board, FALSE);
         board_drawSmileyEx(board, FALSE);
         board_drawTimeEx(board, FALSE);
 
+        minimap_invalidate(board->minimap);
+        board_drawMinimap(board);
+
         // Grid
-        board_drawBorder(board->orientation, &board->gridRect, GRID_BORDER);
         board_drawGridEx(board, update);  // + update
     }
 }
@@ -228,9 +333,7 @@ void board_drawEx(PBOARD const board, BOOL menu, BOOL update){
 //  @update : if TRUE screen will be updated after drawing
 //
 void board_drawGridEx(PBOARD const board, BOOL update){
-    uint16_t origin;
-    RECT rect;
-    POINT offsetCol, offsetRow;
+    PPOINT slot;
     COORD pos;
     uint8_t r, c;
 
@@ -238,58 +341,104 @@ void board_drawGridEx(PBOARD const board, BOOL update){
         return;
     }
 
-    setRect(&rect, board->gridRect.x, board->gridRect.y, BOX_WIDTH, BOX_HEIGHT);
+    TRACE(TRACE_GRID, board->viewPort.visibleFrame.x, board->viewPort.visibleFrame.y);
 
-    if (CALC_HORIZONTAL == board->orientation){
-        rotateRect(&rect);
+#ifdef _DEBUG_
+    // All visible boxes will be drawn
+    if (board->debug){
+        heatmap_update(board->heatmap);
+        heatmap_clearChanged(board->heatmap);
+    }
+#endif // #ifdef _DEBUG_
 
-        offsetCol.x = 0;
-        offsetCol.y = -1 * BOX_HEIGHT;
+    slot = board->layout.slots;
+    for (r = 0; r < board->viewPort.visibleFrame.h; r++){
+        for (c = 0; c < board->viewPort.visibleFrame.w; c++, slot++){
+            pos = (COORD){.col = c + board->viewPort.visibleFrame.x , .row = r + board->viewPort.visibleFrame.y};
+            board_directDrawBox(board, &pos, slot->x, slot->y);
+        }
+    }
 
-        offsetRow.x = BOX_WIDTH;
-        offsetRow.y = 0;
+    board->viewPort.drawn.x = board->viewPort.visibleFrame.x;
+    board->viewPort.drawn.y = board->viewPort.visibleFrame.y;
 
-        origin = rect.y;
+    if (board->viewPort.scrolls != NO_SCROLL){
+        board_drawScrollBars(board, FALSE);
+    }
+
+    if (update){
+        dupdate();
+    }
+}
+
+//  board_scrollGridEx() : Show the visible grid after the viewport has moved
+//
+//  The boxes still visible are moved on screen : only the boxes that were
+//  not shown are drawn. The whole grid is drawn if the frames don't
+//  overlap
+//
+//  @board : Pointer to the board
+//  @update : if TRUE screen will be updated after drawing
+//
+void board_scrollGridEx(PBOARD const board, BOOL update){
+    PRECT frame, rect;
+    PPOINT slot;
+    POINT old;
+    COORD pos;
+    int dx, dy;
+
+    if (!board || !board->grid || !board->grid->boxes){
+        return;
     }
-    else{
-        offsetCol.x = BOX_WIDTH;
-        offsetCol.y = 0;
 
-        offsetRow.x = 0;
-        offsetRow.y = BOX_HEIGHT;
+    frame = &board->viewPort.visibleFrame;
+    old = board->viewPort.drawn;
 
-        origin = rect.x;
+    // Translation of the boxes (in boxes)
+    dx = old.x - frame->x;
+    dy = old.y - frame->y;
+    if (old.x < 0 || dx <= -frame->w || dx >= frame->w ||
+        dy <= -frame->h || dy >= frame->h){
+        board_drawGridEx(board, update);    // Nothing to keep
+        return;
     }
 
-    for (r = 0; r < board->viewPort.visibleFrame.h; r++){
-        // aligned with first "col"
-        if (CALC_HORIZONTAL == board->orientation){
-            rect.y = origin;
-        }
-        else{
-            rect.x = origin;
-        }
+    if (!dx && !dy){
+        return;
+    }
 
-        for (c = 0; c < board->viewPort.visibleFrame.w; c++){
-            pos = (COORD){.col = c + board->viewPort.visibleFrame.x , .row = r + board->viewPort.visibleFrame.y};
-            board_directDrawBox(board, &pos, rect.x, rect.y);
-            offsetRect(&rect, offsetCol.x, offsetCol.y);
+    // Move the pixels
+    rect = &board->layout.grid;
+    dx *= board->boxSize;
+    dy *= board->boxSize;
+    if (CALC_HORIZONTAL == board->orientation){
+        int ndy = -dx;
+        dx = dy;
+        dy = ndy;
+    }
+    TRACE(TRACE_SCROLL, dx, dy);
+    render_scroll(rect->x, rect->y, rect->w, rect->h, dx, dy);
+
+    // Boxes that were not visible
+    slot = board->layout.slots;
+    for (pos.row = frame->y; pos.row < frame->y + frame->h; pos.row++){
+        for (pos.col = frame->x; pos.col < frame->x + frame->w; pos.col++, slot++){
+            if (pos.col < old.x || pos.col >= old.x + frame->w ||
+                pos.row < old.y || pos.row >= old.y + frame->h){
+                board_directDrawBox(board, &pos, slot->x, slot->y);
+            }
         }
-
-        offsetRect(&rect, offsetRow.x, offsetRow.y);
-#ifndef DEST_CASIO_CALC
-        printf("|\n");       // EOL
-#endif // #ifndef DEST_CASIO_CALC
     }
 
+    board->viewPort.drawn.x = frame->x;
+    board->viewPort.drawn.y = frame->y;
+
     if (board->viewPort.scrolls != NO_SCROLL){
         board_drawScrollBars(board, FALSE);
     }
 
     if (update){
-#ifdef DEST_CASIO_CALC
         dupdate();
-#endif // #ifdef DEST_CASIO_CALC
     }
 }
 
@@ -302,10 +451,8 @@ void board_drawGridEx(PBOARD const board, BOOL update){
 //
 void board_drawMinesLeftEx(PBOARD const board, BOOL update){
     int8_t value = board->minesLeft;
-    uint8_t ids[3];
+    uint8_t ids[LED_DIGITS];
     BOOL negative = FALSE;
-    RECT rect;
-    int ox, oy;
 
     if (value < 0){
         value = -1 * value;
@@ -316,18 +463,6 @@ void board_drawMinesLeftEx(PBOARD const board, BOOL update){
         value = 99; // Should never be executed
     }
 
-    setRect(&rect, board->statRect.x, board->statRect.y, LED_WIDTH, LED_HEIGHT);
-
-    if (CALC_HORIZONTAL == board->orientation){
-        rotateRect(&rect);
-        ox = 0;
-        oy = -1 * LED_WIDTH;
-    }
-    else{
-        ox = LED_WIDTH;
-        oy = 0;
-    }
-
     // up to 3 digits - total in ]-100, 100[
     ids[0] = LED_EMPTY_ID;
     ids[1] = value / 10;  // dec.
@@ -338,16 +473,47 @@ void board_drawMinesLeftEx(PBOARD const board, BOOL update){
         ids[ids[1]?0:1] = LED_MINUS_ID;
     }
 
-    for (uint8_t id = 0; id < 3; id++){
-        board_drawLed(board, (uint8_t)ids[id], &rect);
-        offsetRect(&rect, ox, oy);  // next pos
+    if (board_drawCounter(board, &board->minesCounter, ids) && update){
+        dupdate();
     }
+}
 
-    if (update){
-#ifdef DEST_CASIO_CALC
-        dupdate();
-#endif // #ifdef DEST_CASIO_CALC
+//  board_initCounter() : Attach a LED counter to its digits
+//
+//  All the digits will be drawn next time
+//
+//  @counter : Pointer to the counter
+//  @leds : Screen positions of the LED_DIGITS digits
+//
+void board_initCounter(PLED_COUNTER const counter, PRECT const leds){
+    counter->leds = leds;
+    memset(counter->digits, LED_UNKNOWN_ID, LED_DIGITS);
+}
+
+//  board_drawCounter() : Draw the digits of a counter that have changed
+//
+//  @board : Pointer to the board
+//  @counter : Pointer to the counter
+//  @ids : IDs of the LED_DIGITS digits to show
+//
+//  @return : # of digits drawn
+//
+uint8_t board_drawCounter(PBOARD const board, PLED_COUNTER const counter, const uint8_t* ids){
+    uint8_t drawn = 0;
+
+    if (!counter->leds){
+        return 0;   // Not attached yet
     }
+
+    for (uint8_t id = 0; id < LED_DIGITS; id++){
+        if (ids[id] != counter->digits[id]){
+            board_drawLed(board, ids[id], &counter->leds[id]);
+            counter->digits[id] = ids[id];
+            drawn++;
+        }
+    }
+
+    return drawn;
 }
 
 //  board_drawTimeEx() : Draw elapsed time
@@ -357,32 +523,15 @@ void board_drawMinesLeftEx(PBOARD const board, BOOL update){
 //
 void board_drawTimeEx(PBOARD const board, BOOL update){
     uint16_t value = board->time;
-    RECT rect;
-    int ox, oy;
-
-    setRect(&rect, board->statRect.x + TIMER_OFFSET_V, board->statRect.y, LED_WIDTH, LED_HEIGHT);
-
-    if (CALC_HORIZONTAL == board->orientation){
-        rotateRect(&rect);
-        ox = 0;
-        oy = -1 * LED_WIDTH;
-    }
-    else{
-        ox = LED_WIDTH;
-        oy = 0;
-    }
+    uint8_t ids[LED_DIGITS];
 
     // 3 digits - total in [0, 1000[
-    board_drawLed(board, (uint8_t)(value/100), &rect);
-    offsetRect(&rect, ox, oy);
-    board_drawLed(board, (value %= 100)/10, &rect);
-    offsetRect(&rect, ox, oy);
-    board_drawLed(board,value % 10, &rect);
+    ids[0] = (uint8_t)(value/100);
+    ids[1] = (value %= 100)/10;
+    ids[2] = value % 10;
 
-    if (update){
-#ifdef DEST_CASIO_CALC
+    if (board_drawCounter(board, &board->timeCounter, ids) && update){
         dupdate();
-#endif // #ifdef DEST_CASIO_CALC
     }
 }
 
@@ -392,68 +541,59 @@ void board_drawTimeEx(PBOARD const board, BOOL update){
 //  @update : if TRUE screen will be updated after drawing
 //
 void board_drawSmileyEx(PBOARD const board, BOOL update){
-    if (CALC_HORIZONTAL == board->orientation){
-        RECT rect;
-        setRect(&rect, board->statRect.x + SMILEY_OFFSET_V, board->statRect.y, SMILEY_WIDTH, SMILEY_WIDTH);
-        rotateRect(&rect);
-
-#ifdef DEST_CASIO_CALC
-        dsubimage(rect.x, rect.y, &g_smileys, SMILEY_WIDTH, board->smileyState * SMILEY_HEIGHT, SMILEY_WIDTH, SMILEY_HEIGHT, DIMAGE_NOCLIP);
-#endif // #ifdef DEST_CASIO_CALC
-    }
-    else{
-#ifdef DEST_CASIO_CALC
-        dsubimage(board->statRect.x + SMILEY_OFFSET_V, board->statRect.y, &g_smileys, 0, board->smileyState * SMILEY_HEIGHT, SMILEY_WIDTH, SMILEY_HEIGHT, DIMAGE_NOCLIP);
-#endif // #ifdef DEST_CASIO_CALC
-    }
+    dsubimage(board->layout.smiley.x, board->layout.smiley.y, &g_smileys, board->orientation * SMILEY_WIDTH, board->smileyState * SMILEY_HEIGHT, SMILEY_WIDTH, SMILEY_HEIGHT, DIMAGE_NOCLIP);
 
     if (update){
-#ifdef DEST_CASIO_CALC
         dupdate();
-#endif // #ifdef DEST_CASIO_CALC
     }
 }
 
-///  board_drawBox() : Draw a single box
+//  board_drawMinimap() : Draw the changes of the minimap
 //
-//      These 2 functions draw a given box.
-//      board_drawBox checks wether a rotation needs to be done
-//      whereas board_directDrawBox assumes rotation has been done by the calling function
+//  The minimap is only drawn if it is shown and the grid is larger
+//  than the viewport
 //
 //  @board : Pointer to the board
-//  @pos : Box coordinates in the grid
-//  @dx, @dy : Screen coordinates of the top-left corner
 //
-void board_drawBox(PBOARD const board, PCOORD const pos, uint16_t dx, uint16_t dy){
-    if (CALC_HORIZONTAL == board->orientation){
-        RECT rect = {dx, dy, BOX_WIDTH, BOX_HEIGHT};
-        rotateRect(&rect);
-        board_directDrawBox(board, pos, rect.x, rect.y);
-    }
-    else{
-        board_directDrawBox(board, pos, dx, dy);
+//  @return : TRUE if something has been drawn
+//
+BOOL board_drawMinimap(PBOARD const board){
+    if (board->showMinimap && NO_SCROLL != board->viewPort.scrolls){
+        return minimap_draw(board->minimap, &board->viewPort.visibleFrame);
     }
+
+    return FALSE;
 }
 
+//  board_directDrawBox() : Draw a single box
+//
+//      The screen coordinates are the ones of the layout (rotation
+//      has been done)
+//
+//  @board : Pointer to the board
+//  @pos : Box coordinates in the grid
+//  @dx, @dy : Screen coordinates of the top-left corner
+//
 void board_directDrawBox(PBOARD const board, PCOORD const pos, uint16_t dx, uint16_t dy){
     PBOX box = BOX_AT_POS(board->grid, pos);
+    uint8_t size = board->boxSize;
 
-#ifdef DEST_CASIO_CALC
 #ifdef _DEBUG_
+    frameStats_add(FRAME_BOXES, 1);
+
     int ID = ((board->debug && box->mine && (box->state==BS_INITIAL || box->state>=BS_MINE ))?BS_MINE:box->state);  // Always show mines in DEBUG mode
-    dsubimage(dx, dy, &g_boxes, board->orientation * BOX_WIDTH, ID * BOX_HEIGHT, BOX_WIDTH, BOX_HEIGHT, DIMAGE_NOCLIP);
+    dsubimage(dx, dy, _boxImages[board->zoom], board->orientation * size, ID * size, size, size, DIMAGE_NOCLIP);
+
+    // Mine probability
+    if (board->debug && BOX_IS_COVERED(box)){
+        uint8_t level = HEATMAP_LEVEL(heatmap_getProb(board->heatmap, pos));
+        drect(dx + HEATMAP_MARGIN(size), dy + HEATMAP_MARGIN(size),
+                dx + size - 1 - HEATMAP_MARGIN(size), dy + size - 1 - HEATMAP_MARGIN(size),
+                HEATMAP_COLOUR(level));
+    }
 #else
-    dsubimage(dx, dy, &g_boxes, board->orientation * BOX_WIDTH, box->state * BOX_HEIGHT, BOX_WIDTH, BOX_HEIGHT, DIMAGE_NOCLIP);
+    dsubimage(dx, dy, _boxImages[board->zoom], board->orientation * size, box->state * size, size, size, DIMAGE_NOCLIP);
 #endif // #ifdef _DEBUG_
-#else
-    //printf("| %c ", box->mine?'x':'0' + grid_countMines(board->grid, pos));
-    if (box->mine){
-        printf("| x ");
-    }
-    else{
-        printf("| %c ", box->state>BS_DICEY_DOWN?'0' + (BS_DOWN - box->state):'A' + box->state);
-    }
-#endif // #ifdef DEST_CASIO_CALC
 }
 
 //  board_drawBoxAtPos() : Draw the box at a given position
@@ -462,9 +602,12 @@ void board_directDrawBox(PBOARD const board, PCOORD const pos, uint16_t dx, uint
 //  @pos : Box coordinates in the grid
 //
 void board_drawBoxAtPos(PBOARD const board, PCOORD const pos){
-    POINT scrPos; // Position in screen coordinates
-    board_Pos2Point(board, pos, &scrPos);
-    board_drawBox(board, pos, scrPos.x, scrPos.y);
+    PPOINT slot;
+
+    if (board_isBoxVisible(board, pos)){
+        slot = BOARD_SLOT(board, pos);
+        board_directDrawBox(board, pos, slot->x, slot->y);
+    }
 }
 
 // board_drawScrollBar() : Draw a viewport's scrollbar
@@ -479,9 +622,7 @@ void board_drawScrollBar(PBOARD board, uint8_t scrollID, BOOL blink){
         RECT rectBk, rectBar;
         POINT ptBegin, ptEnd;
         uint16_t dimension;
-#ifdef DEST_CASIO_CALC
         int colour = (blink?SCROLL_COLOUR_BLINK:SCROLL_COLOUR);
-#endif // #ifdef DEST_CASIO_CALC
 
         copyRect(&rectBk, &board->viewPort.scrollBars[scrollID - 1]);
         copyRect(&rectBar, &board->viewPort.scrollBars[scrollID - 1]);
@@ -514,14 +655,12 @@ void board_drawScrollBar(PBOARD board, uint8_t scrollID, BOOL blink){
             rotatePoint(&ptEnd);
         }
 
-#ifdef DEST_CASIO_CALC
         drect(rectBk.x, rectBk.y, rectBk.x + rectBk.w -1, rectBk.y + rectBk.h -1, BKGROUND_COLOUR);     // Erase scroll. bckgrnd
 
         // Rounded rectangle
         dcircle(ptBegin.x, ptBegin.y, SCROLL_RADIUS, colour, colour);
         dcircle(ptEnd.x, ptEnd.y, SCROLL_RADIUS, colour, colour);
         drect(rectBar.x, rectBar.y , rectBar.x + rectBar.w - 1, rectBar.y + rectBar.h - 1, colour);
-#endif // #ifdef DEST_CASIO_CALC
     } // if (scrollID < SCROLL_BOTH){
 }
 
@@ -551,9 +690,7 @@ void board_drawScrollBars(PBOARD board, BOOL blink){
 //  @pos : Position in screen coordinates
 //
 void board_drawLed(PBOARD board, uint8_t digit, PRECT pos){
-#ifdef DEST_CASIO_CALC
     dsubimage(pos->x, pos->y, &g_leds, board->orientation * LED_WIDTH, (11-digit)*pos->h, pos->w, pos->h, DIMAGE_NOCLIP);
-#endif // #ifdef DEST_CASIO_CALC
 }
 
 // board_drawBorder() : Draw a 3D border
@@ -569,11 +706,9 @@ void board_drawBorder(CALC_ORIENTATION orientation, PRECT const rect, uint8_t th
     RECT rc;
     BOOL vertical = (orientation == CALC_VERTICAL);
 
-#ifdef DEST_CASIO_CALC
     int light, dark;
     light = COLOUR_LT_GREY;
     dark = COLOUR_GREY;
-#endif // #ifdef DEST_CASIO_CALC
 
     copyRect(&rc, rect);
 
@@ -583,7 +718,6 @@ void board_drawBorder(CALC_ORIENTATION orientation, PRECT const rect, uint8_t th
 
     for (uint8_t count = 0; count < thickness; count++){
         inflateRect(&rc, 1, 1);
-#ifdef DEST_CASIO_CALC
         // top (if CALC_VERTICAL)
         dline(rc.x, rc.y, rc.x + rc.w - 1, rc.y, vertical?light:dark);
 
@@ -595,7 +729,6 @@ void board_drawBorder(CALC_ORIENTATION orientation, PRECT const rect, uint8_t th
 
         // right
         dline(rc.x + rc.w - 1, rc.y, rc.x + rc.w - 1, rc.y + rc.h - 1, dark);
-#endif // #ifdef DEST_CASIO_CALC
     }
 }
 
@@ -613,27 +746,22 @@ void board_setOrientation(PBOARD const board, CALC_ORIENTATION orientation){
         board->viewPort.dimensions.col = board->grid->size.col;     // Real dims of the grid
         board->viewPort.dimensions.row = board->grid->size.row;
 
-        // Count of visible boxes
-        switch (board->grid->level){
-            case LEVEL_BEGINNER:
-                board->viewPort.scrolls = NO_SCROLL;    // no scroll buttons on 'beginner' mode
-                setRect(&board->viewPort.visibleFrame, 0, 0, BEGINNER_COLS, BEGINNER_ROWS);
-                break;
-
-            case LEVEL_MEDIUM:
-                board->viewPort.scrolls = (board->orientation==CALC_HORIZONTAL?SCROLL_HORIZONTAL:SCROLL_VERTICAL);
-                setRect(&board->viewPort.visibleFrame, 0, 0,
-                    MIN_VAL(board->grid->size.col, (board->orientation==CALC_HORIZONTAL?BUTTON_HORZ_COL_MAX:BUTTON_VERT_COL_MAX)),
-                    MIN_VAL(board->grid->size.row, (board->orientation==CALC_HORIZONTAL?BUTTON_HORZ_ROW_MAX:BUTTON_VERT_ROW_MAX)));
-                break;
-
-            case LEVEL_EXPERT:
-                board->viewPort.scrolls = SCROLL_BOTH;
-                setRect(&board->viewPort.visibleFrame, 0, 0,
-                    MIN_VAL(board->grid->size.col, (board->orientation==CALC_HORIZONTAL?BUTTON_HORZ_COL_MAX:BUTTON_VERT_COL_MAX)),
-                    MIN_VAL(board->grid->size.row, (board->orientation==CALC_HORIZONTAL?BUTTON_HORZ_ROW_MAX:BUTTON_VERT_ROW_MAX)));
-                break;
+        // Count of visible boxes (depends on their size)
+        board->boxSize = _boxSizes[board->zoom];
+        setRect(&board->viewPort.visibleFrame, 0, 0,
+            MIN_VAL(board->grid->size.col, (board->orientation==CALC_HORIZONTAL?GRID_HORZ_WIDTH_MAX:GRID_VERT_WIDTH_MAX) / board->boxSize),
+            MIN_VAL(board->grid->size.row, (board->orientation==CALC_HORIZONTAL?GRID_HORZ_HEIGHT_MAX:GRID_VERT_HEIGHT_MAX) / board->boxSize));
+
+        // Scrollbars for the hidden boxes
+        board->viewPort.scrolls = NO_SCROLL;
+        if (board->viewPort.visibleFrame.w < board->grid->size.col){
+            board->viewPort.scrolls |= SCROLL_HORIZONTAL;
         }
+        if (board->viewPort.visibleFrame.h < board->grid->size.row){
+            board->viewPort.scrolls |= SCROLL_VERTICAL;
+        }
+
+        board->viewPort.drawn.x = -1;   // Nothing on screen yet
 
         // Rectangles positions
         //
@@ -646,8 +774,8 @@ void board_setOrientation(PBOARD const board, CALC_ORIENTATION orientation){
             STAT_WIDTH, STAT_HEIGHT);
 
         // 2 - Dimensions of grid rect
-        gridWidth = BOX_WIDTH * board->viewPort.visibleFrame.w;
-        gridHeight = BOX_HEIGHT * board->viewPort.visibleFrame.h;
+        gridWidth = board->boxSize * board->viewPort.visibleFrame.w;
+        gridHeight = board->boxSize * board->viewPort.visibleFrame.h;
         setRect(&board->gridRect,
             ((board->orientation==CALC_VERTICAL?CASIO_WIDTH:CASIO_HEIGHT)
                - gridWidth -2*GRID_BORDER) / 2,
@@ -670,9 +798,64 @@ void board_setOrientation(PBOARD const board, CALC_ORIENTATION orientation){
                 SCROLL_WIDTH,
                 board->gridRect.h + 2 * GRID_BORDER);
         }
+
+        // 4 - Screen positions of the boxes, the leds and the smiley
+        PPOINT slot = board->layout.slots;
+        RECT rect;
+        uint8_t r, c;
+        for (r = 0; r < board->viewPort.visibleFrame.h; r++){
+            for (c = 0; c < board->viewPort.visibleFrame.w; c++, slot++){
+                setRect(&rect, board->gridRect.x + c * board->boxSize, board->gridRect.y + r * board->boxSize, board->boxSize, board->boxSize);
+                if (CALC_HORIZONTAL == board->orientation){
+                    rotateRect(&rect);
+                }
+                slot->x = rect.x;
+                slot->y = rect.y;
+            }
+        }
+
+        copyRect(&board->layout.grid, &board->gridRect);
+        for (c = 0; c < 2 * LED_DIGITS; c++){
+            setRect(&board->layout.leds[c],
+                board->statRect.x + ((c < LED_DIGITS)?(c * LED_WIDTH):(TIMER_OFFSET_V + (c - LED_DIGITS) * LED_WIDTH)),
+                board->statRect.y, LED_WIDTH, LED_HEIGHT);
+        }
+        setRect(&board->layout.smiley, board->statRect.x + SMILEY_OFFSET_V, board->statRect.y, SMILEY_WIDTH, SMILEY_HEIGHT);
+
+        if (CALC_HORIZONTAL == board->orientation){
+            rotateRect(&board->layout.grid);
+            for (c = 0; c < 2 * LED_DIGITS; c++){
+                rotateRect(&board->layout.leds[c]);
+            }
+            rotateRect(&board->layout.smiley);
+        }
+
+        board_initCounter(&board->minesCounter, board->layout.leds);
+        board_initCounter(&board->timeCounter, board->layout.leds + LED_DIGITS);
+
+        // 5 - Minimap on the left of the stats
+        setRect(&rect, EMPTY_SPACE, EMPTY_SPACE,
+            board->statRect.x - STAT_BORDER - 2 * EMPTY_SPACE,
+            board->gridRect.y - GRID_BORDER - 2 * EMPTY_SPACE);
+        minimap_setArea(board->minimap, (NO_SCROLL == board->viewPort.scrolls)?NULL:&rect,
+            CALC_HORIZONTAL == board->orientation);
     } // if (grid)
 }
 
+//  board_setZoom() : Set the size of the boxes
+//
+//  The viewport is moved back to the top-left corner of the grid
+//
+//  @board : Pointer to the board
+//  @zoom : ZOOM_16, ZOOM_12 or ZOOM_8
+//
+void board_setZoom(PBOARD const board, uint8_t zoom){
+    if (board && zoom < ZOOM_COUNT){
+        board->zoom = zoom;
+        board_setOrientation(board, board->orientation);
+    }
+}
+
 //  board_selectBoxEx() : Select a box
 //
 //  @board : Pointer to the board
@@ -680,30 +863,185 @@ void board_setOrientation(PBOARD const board, CALC_ORIENTATION orientation){
 //  @select : TRUE if box is selected, FALSE if unselected
 //
 void board_selectBoxEx(PBOARD const board, PCOORD const pos, BOOL select){
-    POINT base;
-    board_Pos2Point(board, pos, &base);
+    PPOINT base;
 
+    if (!board_isBoxVisible(board, pos)){
+        return;
+    }
+
+    base = BOARD_SLOT(board, pos);
     if (select){
-#ifdef DEST_CASIO_CALC
-        if (CALC_HORIZONTAL == board->orientation){
-            RECT rect = {base.x, base.y, BOX_WIDTH, BOX_HEIGHT};
-            rotateRect(&rect);
-            drect(rect.x + 2, rect.y + 2, rect.x + BOX_WIDTH - 3, rect.y + BOX_HEIGHT - 3, C_INVERT);
+        drect(base->x + 2, base->y + 2, base->x + board->boxSize - 3, base->y + board->boxSize - 3, C_INVERT);
+    }
+    else{
+        board_directDrawBox(board, pos, base->x, base->y);
+    }
+
+    TRACE(select?TRACE_SELECT:TRACE_UNSELECT, pos->col, pos->row);
+}
+
+//  board_drawHint() : Highlight a box given as a hint
+//
+//  @board : Pointer to the board
+//  @pos : Box coordinates of the box in the grid
+//  @safe : TRUE if the box is known to be safe, FALSE for a guess
+//
+void board_drawHint(PBOARD const board, PCOORD const pos, BOOL safe){
+    PPOINT base;
+
+    if (!board_isBoxVisible(board, pos)){
+        return;
+    }
+
+    base = BOARD_SLOT(board, pos);
+
+    // A frame between the box border and the selection
+    drect_border(base->x + 1, base->y + 1, base->x + board->boxSize - 2, base->y + board->boxSize - 2,
+            C_NONE, 1, safe?HINT_COLOUR_SAFE:HINT_COLOUR_GUESS);
+}
+
+#ifdef _DEBUG_
+//  board_drawHeatmap() : Draw the visible boxes whose probability has changed
+//
+//  @board : pointer to the board
+//
+//  @return : TRUE if boxes have been drawn
+//
+BOOL board_drawHeatmap(PBOARD const board){
+    PHEATMAP heatmap = board->heatmap;
+    COORD pos;
+    BOOL drawn = FALSE;
+
+    if (!board->debug || !heatmap_update(heatmap)){
+        return FALSE;
+    }
+
+    for (uint16_t i = 0; i < heatmap->changedCount; i++){
+        pos.col = heatmap->changed[i] % board->grid->size.col;
+        pos.row = heatmap->changed[i] / board->grid->size.col;
+        if (board_isBoxVisible(board, &pos)){
+            board_drawBoxAtPos(board, &pos);
+            drawn = TRUE;
         }
-        else{
-            drect(base.x + 2, base.y + 2, base.x + BOX_WIDTH - 3, base.y + BOX_HEIGHT - 3, C_INVERT);
+    }
+
+    heatmap_clearChanged(heatmap);
+    return drawn;
+}
+#endif // #ifdef _DEBUG_
+
+//
+// Internal functions
+//
+
+// _drawChrome() : Draw the borders and keep a copy of their strips
+//
+//  Scrollbar tracks use the background colour
+//
+//  @board : Pointer to the board
+//
+static void _drawChrome(PBOARD const board){
+    uint16_t size;
+
+#ifdef _DEBUG_
+    frameStats_add(FRAME_CHROMES, 1);
+#endif // #ifdef _DEBUG_
+
+    board_drawBorder(board->orientation, &board->statRect, STAT_BORDER);
+    board_drawBorder(board->orientation, &board->gridRect, GRID_BORDER);
+
+    size = _setChromeStrips(board->chromeStrips, board->orientation, &board->statRect, STAT_BORDER);
+    size += _setChromeStrips(board->chromeStrips + 4, board->orientation, &board->gridRect, GRID_BORDER);
+
+    if (board->chrome && size > board->chromeSize){
+        free(board->chrome);
+        board->chrome = NULL;
+    }
+
+    // Without memory, the borders will be drawn every time
+    if (!board->chrome){
+        if (!(board->chrome = (uint16_t*)malloc(size * sizeof(uint16_t)))){
+            TRACE(TRACE_CHROME, size, 0);
+            return;
         }
-#endif // #ifdef DEST_CASIO_CALC
+        board->chromeSize = size;
     }
-    else{
-        board_drawBox(board, pos, base.x, base.y);
+
+    _copyChrome(board, TRUE);
+    board->chromeKey = BOARD_CHROME_KEY(board);
+}
+
+// _setChromeStrips() : Screen areas of the 4 sides of a border
+//
+//  @strips : Pointer to the 4 areas
+//  @orientation : Rectangle's orientation
+//  @rect : Rect. inside the border
+//  @thickness : Border thickness
+//
+//  @return : # of pixels of the areas
+//
+static uint16_t _setChromeStrips(PRECT const strips, CALC_ORIENTATION orientation, PRECT const rect, uint8_t thickness){
+    RECT rc;
+
+    copyRect(&rc, rect);
+    if (CALC_VERTICAL != orientation){
+        rotateRect(&rc);
     }
 
-#ifdef TRACE_MODE
-        char trace[250];
-        __coordtoa(select?"Sel : ":"Uns : ", base.x, base.y, trace);
-        TRACE(trace, C_BLACK, BKGROUND_COLOUR);
-#endif // TRACE_MODE
+    return _setStrip(strips, rc.x - thickness, rc.y - thickness, rc.w + 2 * thickness, thickness)         // top
+            + _setStrip(strips + 1, rc.x - thickness, rc.y + rc.h, rc.w + 2 * thickness, thickness)    // bottom
+            + _setStrip(strips + 2, rc.x - thickness, rc.y, thickness, rc.h)                           // left
+            + _setStrip(strips + 3, rc.x + rc.w, rc.y, thickness, rc.h);                               // right
+}
+
+// _setStrip() : A strip clipped to the screen
+//
+//  @return : # of pixels of the strip
+//
+static uint16_t _setStrip(PRECT const strip, int x, int y, int w, int h){
+    if (x < 0){
+        w += x;
+        x = 0;
+    }
+    if (y < 0){
+        h += y;
+        y = 0;
+    }
+    w = MIN_VAL(w, CASIO_WIDTH - x);
+    h = MIN_VAL(h, CASIO_HEIGHT - y);
+    if (w <= 0 || h <= 0){
+        w = h = 0;
+    }
+
+    strip->x = x;
+    strip->y = y;
+    strip->w = w;
+    strip->h = h;
+    return (uint16_t)(w * h);
+}
+
+// _copyChrome() : Copy the border strips from or to the VRAM
+//
+//  @board : Pointer to the board
+//  @save : TRUE to copy the VRAM in the buffer
+//
+static void _copyChrome(PBOARD const board, BOOL save){
+    uint16_t* vram = render_vram();
+    uint16_t* copy = board->chrome;
+    PRECT strip;
+    int y;
+
+    for (strip = board->chromeStrips; strip < board->chromeStrips + BOARD_CHROME_STRIPS; strip++){
+        for (y = strip->y; y < strip->y + strip->h; y++){
+            if (save){
+                memcpy(copy, vram + y * CASIO_WIDTH + strip->x, strip->w * sizeof(uint16_t));
+            }
+            else{
+                memcpy(vram + y * CASIO_WIDTH + strip->x, copy, strip->w * sizeof(uint16_t));
+            }
+            copy += strip->w;
+        }
+    }
 }
 
 // EOF
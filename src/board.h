@@ -12,10 +12,18 @@
 #include "shared/casioCalcs.h"
 #include "consts.h"
 #include "grid.h"
+#include "solver.h"
+#include "replay.h"
+#include "journal.h"
+#include "minimap.h"
+#include "shared/chrono.h"
 
-#ifdef TRACE_MODE
-#include "shared/trace.h"
-#endif // TRACE_MODE
+#ifdef _DEBUG_
+#include "heatmap.h"
+#include "shared/frameStats.h"
+#endif // #ifdef _DEBUG_
+
+#include "shared/trace.h"    // TRACE() does nothing without TRACE_MODE
 
 #ifdef DEST_CASIO_CALC
 #include <gint/timer.h>
@@ -35,6 +43,13 @@ extern "C" {
 #define BOX_WIDTH           0x0010  // 16
 #define BOX_HEIGHT          BOX_WIDTH
 
+// Zoom : size of the boxes
+//
+#define ZOOM_16             0       // BOX_WIDTH
+#define ZOOM_12             1
+#define ZOOM_8              2
+#define ZOOM_COUNT          3
+
 #define LED_WIDTH           0x000D  // 13
 #define LED_HEIGHT          0x0017  // 23
 #define LED_ZONE_WIDTH      3 * LED_WIDTH
@@ -51,6 +66,15 @@ extern "C" {
 #define BUTTON_HORZ_COL_MAX    12     // # max of button in horz. mode
 #define BUTTON_HORZ_ROW_MAX    21
 
+// Max. size of the grid in pixels (smaller boxes => more boxes)
+#define GRID_VERT_WIDTH_MAX     (BUTTON_VERT_COL_MAX * BOX_WIDTH)
+#define GRID_VERT_HEIGHT_MAX    (BUTTON_VERT_ROW_MAX * BOX_HEIGHT)
+#define GRID_HORZ_WIDTH_MAX     (BUTTON_HORZ_COL_MAX * BOX_WIDTH)
+#define GRID_HORZ_HEIGHT_MAX    (BUTTON_HORZ_ROW_MAX * BOX_HEIGHT)
+
+// Max. count of visible boxes (the whole grid with small boxes)
+#define BOARD_MAX_SLOTS         GRID_MAX_BOXES
+
 // LED images
 //
 #define SMILEY_OFFSET_V     LED_ZONE_WIDTH
@@ -60,6 +84,9 @@ extern "C" {
 // LED digits IDs in the leds bitmap in reverse order
 #define LED_MINUS_ID        11
 #define LED_EMPTY_ID        10
+#define LED_UNKNOWN_ID      0xFF    // Digit not on screen
+
+#define LED_DIGITS          3       // Digits of a counter
 
 // Time
 //
@@ -70,7 +97,8 @@ extern "C" {
 // Game state
 //
 typedef enum {
-    STATE_WAITING, STATE_PLAYING, STATE_WON, STATE_LOST, STATE_CANCELLED
+    STATE_WAITING, STATE_PLAYING, STATE_WON, STATE_LOST, STATE_CANCELLED,
+    STATE_SUSPENDED     // Left by the player, can be resumed
 } GAME_STATE;
 
 // Orientation
@@ -100,30 +128,93 @@ typedef enum {
 #define SCROLL_COLOUR           C_RGB(19,24,27)
 #define SCROLL_COLOUR_BLINK     C_RGB(23, 29, 31)
 
+// Hints
+//
+#define HINT_COLOUR_SAFE        C_RGB(0, 24, 0)
+#define HINT_COLOUR_GUESS       COLOUR_ORANGE
+
+#ifdef _DEBUG_
+// Probability heatmap (debug mode)
+//
+#define HEATMAP_MARGIN(size)    ((size) * 5 / BOX_WIDTH)   // Tint is drawn inside the box
+#define HEATMAP_COLOUR(level)   C_RGB((level) * 31 / (HEATMAP_LEVELS - 1), (HEATMAP_LEVELS - 1 - (level)) * 31 / (HEATMAP_LEVELS - 1), 0)
+#endif // #ifdef _DEBUG_
+
 // A viewport - defines visible part of the grid
 //
 typedef struct __viewPort{
     DIMS dimensions;        // max. box count (w x h)
     RECT visibleFrame;      // current visible boxes IDs
+    POINT drawn;            // Origin of the frame shown on screen (x < 0 if none)
     uint8_t scrolls:2;
     RECT scrollBars[2];     // 0=>horz , 1=>vert
 }VIEWPORT, * PVIEWPORT;
 
+// Screen positions of the board's items
+//
+//  Computed when the orientation changes : the drawing functions get
+//  the (rotated) screen coordinates without any computation
+//
+typedef struct __boardLayout{
+    POINT slots[BOARD_MAX_SLOTS];   // Top-left corners of the visible boxes (row by row)
+    RECT grid;                      // The grid
+    RECT leds[2 * LED_DIGITS];      // Mines left and time digits
+    RECT smiley;
+}BOARD_LAYOUT, * PBOARD_LAYOUT;
+
+// A counter made of LED digits
+//
+//  Only the digits that have changed since the last drawing are drawn
+//
+typedef struct __ledCounter{
+    PRECT leds;                     // Screen positions of the digits
+    uint8_t digits[LED_DIGITS];     // IDs of the digits on screen
+}LED_COUNTER, * PLED_COUNTER;
+
+// Static parts of the screen : the background is a single colour and
+// the borders are drawn once and kept in an off-screen copy of their
+// strips of the VRAM
+//
+#define BOARD_CHROME_STRIPS     8       // 4 sides of the stat and grid borders
+#define BOARD_CHROME_KEY(board) ((uint8_t)((board)->orientation | ((board)->grid->level << 1) | ((board)->zoom << 3)))
+
+// Position of a visible box in the layout
+#define BOARD_SLOT(board, pos)  (&(board)->layout.slots[((pos)->row - (board)->viewPort.visibleFrame.y) * (board)->viewPort.visibleFrame.w + (pos)->col - (board)->viewPort.visibleFrame.x])
+
 // Game board
 //
 typedef struct __board{
     PGRID grid;
+    PSOLVER solver;     // Hints
+    PREPLAY replay;     // Actions of the current game
+    PJOURNAL journal;   // Undo / redo
+    PMINIMAP minimap;   // Overview of the grid
+    BOOL showMinimap;
+    BOOL practice;      // Undo has been used : no score
     VIEWPORT viewPort;
     CALC_ORIENTATION orientation;
+    uint8_t zoom;       // ZOOM_16, ZOOM_12 or ZOOM_8
+    uint8_t boxSize;    // Size of the boxes in pixels (zoom)
     GAME_STATE gameState;
     SMILEY_STATE smileyState;
     int8_t minesLeft;   // could be < 0 !
-    uint8_t steps;
-    uint16_t time;
+    uint16_t steps;
+    uint16_t time;      // Displayed time in sec.
+    LED_COUNTER minesCounter;
+    LED_COUNTER timeCounter;
+    CHRONO chrono;      // Duration of the game
+    COORD cursor;       // Position of the cursor when the game is left
+    BOOL saved;         // The game is in the save file
     RECT gridRect;
     RECT statRect;
+    BOARD_LAYOUT layout;    // Screen positions
+    uint16_t* chrome;       // Copy of the border strips (NULL if none)
+    uint16_t chromeSize;    // # of pixels of the copy
+    uint8_t chromeKey;      // Orientation, level and zoom of the copy
+    RECT chromeStrips[BOARD_CHROME_STRIPS]; // Screen areas of the copy
 #ifdef _DEBUG_
     BOOL debug;
+    PHEATMAP heatmap;   // Probabilities in debug mode
 #endif // #ifdef _DEBUG_
 } BOARD, * PBOARD;
 
@@ -146,6 +237,12 @@ PBOARD board_create();
 //
 BOOL board_init(PBOARD const board, GAME_LEVEL level);
 
+//  board_reset() : Start a game with the current grid
+//
+//  @board : Pointer to the board (mines must be laid)
+//
+void board_reset(PBOARD const board);
+
 //  board_draw() : Draw the whole board
 //
 //  @board : Pointer to the board
@@ -207,6 +304,15 @@ BOOL board_Pos2Point(PBOARD const board, PCOORD const pos, PPOINT pt);
 //
 BOOL board_isBoxVisible(PBOARD const board, PCOORD const pos);
 
+// board_showBox() : Scroll the viewport to make a box visible
+//
+//  @board : pointer to the board
+//  @pos : Coordindate of the box in the grid
+//
+//  @return TRUE if the viewport has moved
+//
+BOOL board_showBox(PBOARD const board, PCOORD const pos);
+
 //  board_drawGridEx() : Draw the visible grid
 //
 //  @board : Pointer to the board
@@ -215,6 +321,18 @@ BOOL board_isBoxVisible(PBOARD const board, PCOORD const pos);
 void board_drawGridEx(PBOARD const board, BOOL update);
 #define board_drawGrid(board) board_drawGridEx(board, TRUE)
 
+//  board_scrollGridEx() : Show the visible grid after the viewport has moved
+//
+//  The boxes still visible are moved on screen : only the boxes that were
+//  not shown are drawn. The whole grid is drawn if the frames don't
+//  overlap
+//
+//  @board : Pointer to the board
+//  @update : if TRUE screen will be updated after drawing
+//
+void board_scrollGridEx(PBOARD const board, BOOL update);
+#define board_scrollGrid(board) board_scrollGridEx(board, TRUE)
+
 //  board_DrawMinesLeftEx() : Draw the number of mines left
 //
 //  This number can be negative when the user 'puts' to many flags
@@ -225,6 +343,26 @@ void board_drawGridEx(PBOARD const board, BOOL update);
 void board_drawMinesLeftEx(PBOARD const board, BOOL update);
 #define board_drawMinesLeft(board) board_drawMinesLeftEx(board, TRUE)
 
+//  board_initCounter() : Attach a LED counter to its digits
+//
+//  All the digits will be drawn next time
+//
+//  @counter : Pointer to the counter
+//  @leds : Screen positions of the LED_DIGITS digits
+//
+void board_initCounter(PLED_COUNTER const counter, PRECT const leds);
+#define board_invalidateCounter(counter) board_initCounter(counter, (counter)->leds)
+
+//  board_drawCounter() : Draw the digits of a counter that have changed
+//
+//  @board : Pointer to the board
+//  @counter : Pointer to the counter
+//  @ids : IDs of the LED_DIGITS digits to show
+//
+//  @return : # of digits drawn
+//
+uint8_t board_drawCounter(PBOARD const board, PLED_COUNTER const counter, const uint8_t* ids);
+
 //  board_drawTimeEx() : Draw elapsed time
 //
 //  @board : Pointer to the board
@@ -241,17 +379,26 @@ void board_drawTimeEx(PBOARD const board, BOOL update);
 void board_drawSmileyEx(PBOARD const board, BOOL update);
 #define board_drawSmiley(board) board_drawSmileyEx(board, TRUE)
 
-//  board_drawBox() : Draw a single box
+//  board_drawMinimap() : Draw the changes of the minimap
+//
+//  The minimap is only drawn if it is shown and the grid is larger
+//  than the viewport
+//
+//  @board : Pointer to the board
+//
+//  @return : TRUE if something has been drawn
+//
+BOOL board_drawMinimap(PBOARD const board);
+
+//  board_directDrawBox() : Draw a single box
 //
-//      These 2 functions draw a given box.
-//      board_drawBox checks wether a rotation needs to be done
-//      whereas board_directDrawBox assumes rotation has been done by the calling function
+//      The screen coordinates are the ones of the layout (rotation
+//      has been done)
 //
 //  @board : Pointer to the board
 //  @pos : Box coordinates in the grid
 //  @dx, @dy : Screen coordinates of the top-left corner
 //
-void board_drawBox(PBOARD const board, PCOORD const pos, uint16_t dx, uint16_t dy);
 void board_directDrawBox(PBOARD const board, PCOORD const pos, uint16_t dx, uint16_t dy);
 
 //  board_drawBoxAtPos() : Draw the box at a given position
@@ -305,6 +452,15 @@ void board_drawBorder(CALC_ORIENTATION orientation, PRECT const rect, uint8_t th
 //
 void board_setOrientation(PBOARD const board, CALC_ORIENTATION orientation);
 
+//  board_setZoom() : Set the size of the boxes
+//
+//  The viewport is moved back to the top-left corner of the grid
+//
+//  @board : Pointer to the board
+//  @zoom : ZOOM_16, ZOOM_12 or ZOOM_8
+//
+void board_setZoom(PBOARD const board, uint8_t zoom);
+
 //  board_selectBoxEx() : Select a box
 //
 //  @board : Pointer to the board
@@ -315,6 +471,24 @@ void board_selectBoxEx(PBOARD const board, PCOORD const pos, BOOL select);
 #define  board_selectBox(board, pos) board_selectBoxEx(board, pos, TRUE)
 #define  board_unselectBox(board, pos) board_selectBoxEx(board, pos, FALSE)
 
+//  board_drawHint() : Highlight a box given as a hint
+//
+//  @board : Pointer to the board
+//  @pos : Box coordinates of the box in the grid
+//  @safe : TRUE if the box is known to be safe, FALSE for a guess
+//
+void board_drawHint(PBOARD const board, PCOORD const pos, BOOL safe);
+
+#ifdef _DEBUG_
+//  board_drawHeatmap() : Draw the visible boxes whose probability has changed
+//
+//  @board : pointer to the board
+//
+//  @return : TRUE if boxes have been drawn
+//
+BOOL board_drawHeatmap(PBOARD const board);
+#endif // #ifdef _DEBUG_
+
 #ifdef __cplusplus
 }
 #endif // #ifdef __cplusplus
@@ -0,0 +1,288 @@
+//----------------------------------------------------------------------
+//--
+//--    bot.c
+//--
+//--            Headless games played by a bot
+//--
+//----------------------------------------------------------------------
+
+#include "bot.h"
+
+#include <string.h>
+
+static void _onReveal(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param);
+static BOT_ACTION _playRandom(PBOT_VIEW const view, PCOORD pos, void* param);
+static BOT_ACTION _playSolver(PBOT_VIEW const view, PCOORD pos, void* param);
+static BOT_ACTION _playHeatmap(PBOT_VIEW const view, PCOORD pos, void* param);
+
+// Built-in strategies
+//
+static const BOT_STRATEGY _strategies[BOT_STRATEGY_COUNT] = {
+    {"random", _playRandom, FALSE, NULL},
+    {"solver", _playSolver, FALSE, NULL},
+    {"heatmap", _playHeatmap, TRUE, NULL}
+};
+
+//  bot_create() : Create a bot
+//
+//  @return : pointer to the new bot or NULL
+//
+PBOT bot_create(){
+    PBOT bot = (PBOT)malloc(sizeof(BOT));
+    if (bot){
+        memset(bot, 0, sizeof(BOT));
+        bot->grid = grid_create();
+        bot->view.grid = grid_create();
+        bot->view.solver = solver_create();
+        bot->view.heatmap = heatmap_create();
+        if (!bot->grid || !bot->view.grid || !bot->view.solver || !bot->view.heatmap){
+            return bot_free(bot, TRUE);
+        }
+    }
+
+    return bot;
+}
+
+//  bot_play() : Play a whole game
+//
+//  @bot : Pointer to the bot
+//  @level : Level of the game
+//  @seed : Seed of the grid
+//  @strategy : Strategy of the bot
+//  @game : Result of the game
+//
+//  @return : TRUE if the game has been played
+//
+BOOL bot_play(PBOT const bot, GAME_LEVEL level, uint32_t seed, const BOT_STRATEGY* strategy, PBOT_GAME game){
+    PBOT_VIEW view;
+    GRID_STATS stats;
+    uint32_t actions;
+    COORD pos;
+    PBOX box;
+
+    if (!bot || !game || !strategy || !strategy->play ||
+        !grid_init(bot->grid, level) || !grid_layMinesEx(bot->grid, seed) ||
+        !grid_init(bot->view.grid, level)){
+        return FALSE;
+    }
+
+    view = &bot->view;
+    if (!solver_init(view->solver, view->grid) ||
+        (strategy->heatmap && !heatmap_init(view->heatmap, view->grid, view->solver))){
+        return FALSE;
+    }
+
+    if (!strategy->heatmap){
+        heatmap_free(view->heatmap, FALSE);  // Not used
+    }
+
+    memset(game, 0, sizeof(BOT_GAME));
+    if (grid_analyse(bot->grid, &stats)){
+        game->bbbv = stats.bbbv;
+    }
+    view->random = seed ^ 0x5DEECE66u;
+    view->covered = bot->grid->size.col * bot->grid->size.row;
+    view->flags = 0;
+    bot->revealed = 0;
+
+    for (actions = BOT_MAX_ACTIONS * view->covered;
+        bot->revealed < bot->grid->maxSteps && actions; actions--){
+        switch (strategy->play(view, &pos, strategy->param)){
+            case BOT_ACTION_STEP:
+                if (pos.col >= bot->grid->size.col || pos.row >= bot->grid->size.row){
+                    actions = 1;    // Invalid position => game over
+                    break;
+                }
+
+                game->moves++;
+                if (GRID_STEP_MINE == grid_step(bot->grid, &pos, _onReveal, bot)){
+                    actions = 1;    // Lost
+                }
+                break;
+
+            case BOT_ACTION_FLAG:
+                if (pos.col >= bot->grid->size.col || pos.row >= bot->grid->size.row){
+                    actions = 1;
+                    break;
+                }
+
+                game->flags++;
+                box = BOX_AT_POS(bot->grid, &pos);
+                if (BOX_IS_COVERED(box)){
+                    view->flags += (BS_FLAG == box->state)?-1:+1;
+                    box->state = (BS_FLAG == box->state)?BS_INITIAL:BS_FLAG;
+                    BOX_AT_POS(view->grid, &pos)->state = box->state;
+                }
+                break;
+
+            // Give up
+            default:
+                actions = 1;
+                break;
+        }
+
+        solver_update(view->solver);
+    }
+
+    game->revealed = bot->revealed;
+    game->won = (bot->revealed == bot->grid->maxSteps);
+    return TRUE;
+}
+
+//  bot_gameSeed() : Seed of a game in a series
+//
+//  All the strategies get the same grids for the same series
+//
+//  @base : Seed of the series
+//  @level : Level of the game
+//  @index : Index of the game in the series
+//
+//  @return : seed of the grid (never 0)
+//
+uint32_t bot_gameSeed(uint32_t base, GAME_LEVEL level, uint32_t index){
+    // Avalanche (murmur3 finalizer)
+    uint32_t h = base ^ ((uint32_t)level << 28) ^ (index * 0x9E3779B9u);
+    h ^= h >> 16;
+    h *= 0x85EBCA6Bu;
+    h ^= h >> 13;
+    h *= 0xC2B2AE35u;
+    h ^= h >> 16;
+    return (h?h:1);
+}
+
+//  bot_getStrategy() : Get a built-in strategy
+//
+//  @id : ID of the strategy (BOT_RANDOM ... BOT_HEATMAP)
+//
+//  @return : pointer to the strategy or NULL if invalid
+//
+const BOT_STRATEGY* bot_getStrategy(uint8_t id){
+    return (id < BOT_STRATEGY_COUNT)?&_strategies[id]:NULL;
+}
+
+//  bot_findStrategy() : Find a built-in strategy by its name
+//
+//  @name : Name of the strategy
+//
+//  @return : pointer to the strategy or NULL if not found
+//
+const BOT_STRATEGY* bot_findStrategy(const char* name){
+    for (uint8_t id = 0; id < BOT_STRATEGY_COUNT; id++){
+        if (!strcmp(name, _strategies[id].name)){
+            return &_strategies[id];
+        }
+    }
+
+    return NULL;
+}
+
+//  bot_free() : Free memory used by a bot
+//
+//  @bot : Pointer to the bot
+//  @freeAll : if FALSE only the objects are freed. If TRUE bot memory
+//              will also be freed
+//
+//  @return : pointer to bot or NULL if freed
+//
+PBOT bot_free(PBOT const bot, BOOL freeAll){
+    if (bot){
+        bot->grid = grid_free(bot->grid, TRUE);
+        bot->view.grid = grid_free(bot->view.grid, TRUE);
+        bot->view.solver = solver_free(bot->view.solver, TRUE);
+        bot->view.heatmap = heatmap_free(bot->view.heatmap, TRUE);
+
+        if (freeAll){
+            free(bot);
+            return NULL;
+        }
+    }
+
+    return bot;
+}
+
+//
+// Internal functions
+//
+
+// _onReveal() : A box has been revealed
+//
+//  The visible board is updated
+//
+static void _onReveal(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param){
+    PBOT bot = (PBOT)param;
+    PBOX box = BOX_AT_POS(bot->view.grid, pos);
+
+    if (BS_FLAG == previous){
+        bot->view.flags--;
+    }
+
+    box->state = BOX_AT_POS(grid, pos)->state;
+    bot->view.covered--;
+    bot->revealed++;
+
+    if (bot->view.heatmap->flags){
+        heatmap_touch(bot->view.heatmap, pos);
+    }
+}
+
+// _playRandom() : Step on any covered box
+//
+static BOT_ACTION _playRandom(PBOT_VIEW const view, PCOORD pos, void* param){
+    uint16_t count = view->grid->size.col * view->grid->size.row, id;
+    uint16_t index = (uint16_t)(grid_random(&view->random) % view->covered);
+    (void)param;    // No parameter
+
+    for (id = 0; id < count; id++){
+        if (BOX_IS_COVERED(&view->grid->boxes[id]) && !index--){
+            pos->col = id % view->grid->size.col;
+            pos->row = id / view->grid->size.col;
+            return BOT_ACTION_STEP;
+        }
+    }
+
+    return BOT_ACTION_NONE;
+}
+
+// _playSolver() : Step on a solved box or on the box with the lowest risk
+//
+static BOT_ACTION _playSolver(PBOT_VIEW const view, PCOORD pos, void* param){
+    (void)param;    // No parameter
+    solver_solve(view->solver);
+    return (SOLVER_MINE != solver_getHint(view->solver, pos))?BOT_ACTION_STEP:BOT_ACTION_NONE;
+}
+
+// _playHeatmap() : Step on a solved box or on the box with the lowest
+//                  probability
+//
+static BOT_ACTION _playHeatmap(PBOT_VIEW const view, PCOORD pos, void* param){
+    uint16_t count = view->grid->size.col * view->grid->size.row, id;
+    uint16_t best = HEATMAP_PROB_MAX + 1;
+    uint8_t prob;
+    COORD cur;
+    (void)param;    // No parameter
+
+    solver_solve(view->solver);
+    if (SOLVER_SAFE == solver_getHint(view->solver, pos)){
+        return BOT_ACTION_STEP;
+    }
+
+    heatmap_update(view->heatmap);
+    heatmap_clearChanged(view->heatmap);
+
+    for (id = 0; id < count; id++){
+        if (BOX_IS_COVERED(&view->grid->boxes[id]) &&
+            SOLVER_UNKNOWN == view->solver->boxes[id]){
+            cur.col = id % view->grid->size.col;
+            cur.row = id / view->grid->size.col;
+            prob = heatmap_getProb(view->heatmap, &cur);
+            if (prob < best){
+                best = prob;
+                *pos = cur;
+            }
+        }
+    }
+
+    return (best <= HEATMAP_PROB_MAX)?BOT_ACTION_STEP:BOT_ACTION_NONE;
+}
+
+// EOF
@@ -0,0 +1,160 @@
+//----------------------------------------------------------------------
+//--
+//--    bot.h
+//--
+//--            Headless games played by a bot
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_BOT_h__
+#define __GEE_MINES_BOT_h__    1
+
+#include "grid.h"
+#include "solver.h"
+#include "heatmap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// A bot plays a whole game without any drawing : mines are laid with a
+// given seed and the bot applies the actions of a strategy (using
+// grid_step) until the game is won or lost.
+//
+// A strategy is a callback. It only gets the visible board : a copy of
+// the grid with no mine and the states of the boxes as seen by the
+// player. The solver and the heatmap of the bot are attached to this
+// visible grid.
+//
+// A bot owns all its objects. Many bots can play in different threads,
+// strategies must therefore not modify their parameter.
+//
+
+// Actions of a strategy
+//
+typedef enum{
+    BOT_ACTION_NONE,    // Give up
+    BOT_ACTION_STEP,
+    BOT_ACTION_FLAG     // Put / remove a flag
+} BOT_ACTION;
+
+// Max. count of actions in a game (for each box)
+#define BOT_MAX_ACTIONS     4
+
+// What a strategy can see and use
+//
+typedef struct __botView{
+    PGRID grid;         // Visible board (no mine is set)
+    PSOLVER solver;     // Solver attached to the visible board
+    PHEATMAP heatmap;   // Probabilities (only if the strategy needs them)
+    uint32_t random;    // Random generator of the game
+    uint16_t covered;   // # of covered boxes
+    uint16_t flags;     // # of flags
+} BOT_VIEW, * PBOT_VIEW;
+
+// A strategy
+//
+//  @view : Visible board
+//  @pos : Position of the box
+//  @param : Strategy's parameter
+//
+//  @return : Action to perform at the given position
+//
+typedef BOT_ACTION (*BOT_PLAY)(PBOT_VIEW const view, PCOORD pos, void* param);
+
+typedef struct __botStrategy{
+    const char* name;
+    BOT_PLAY play;
+    BOOL heatmap;       // view->heatmap is used ?
+    void* param;
+} BOT_STRATEGY, * PBOT_STRATEGY;
+
+// Built-in strategies
+//
+#define BOT_RANDOM          0   // Any covered box
+#define BOT_SOLVER          1   // Solved boxes, then lowest local risk
+#define BOT_HEATMAP         2   // Solved boxes, then lowest probability
+#define BOT_STRATEGY_COUNT  3
+
+// Result of a game
+//
+typedef struct __botGame{
+    BOOL won;
+    uint16_t moves;     // # of steps (ie. clicks)
+    uint16_t flags;     // # of flag actions
+    uint16_t revealed;  // # of revealed boxes
+    uint16_t bbbv;      // 3BV of the grid
+} BOT_GAME, * PBOT_GAME;
+
+// A bot
+//
+typedef struct __bot{
+    PGRID grid;         // Real grid (with mines)
+    BOT_VIEW view;
+    uint16_t revealed;
+} BOT, * PBOT;
+
+//  bot_create() : Create a bot
+//
+//  @return : pointer to the new bot or NULL
+//
+PBOT bot_create();
+
+//  bot_play() : Play a whole game
+//
+//  @bot : Pointer to the bot
+//  @level : Level of the game
+//  @seed : Seed of the grid
+//  @strategy : Strategy of the bot
+//  @game : Result of the game
+//
+//  @return : TRUE if the game has been played
+//
+BOOL bot_play(PBOT const bot, GAME_LEVEL level, uint32_t seed, const BOT_STRATEGY* strategy, PBOT_GAME game);
+
+//  bot_gameSeed() : Seed of a game in a series
+//
+//  All the strategies get the same grids for the same series
+//
+//  @base : Seed of the series
+//  @level : Level of the game
+//  @index : Index of the game in the series
+//
+//  @return : seed of the grid (never 0)
+//
+uint32_t bot_gameSeed(uint32_t base, GAME_LEVEL level, uint32_t index);
+
+//  bot_getStrategy() : Get a built-in strategy
+//
+//  @id : ID of the strategy (BOT_RANDOM ... BOT_HEATMAP)
+//
+//  @return : pointer to the strategy or NULL if invalid
+//
+const BOT_STRATEGY* bot_getStrategy(uint8_t id);
+
+//  bot_findStrategy() : Find a built-in strategy by its name
+//
+//  @name : Name of the strategy
+//
+//  @return : pointer to the strategy or NULL if not found
+//
+const BOT_STRATEGY* bot_findStrategy(const char* name);
+
+//  bot_free() : Free memory used by a bot
+//
+//  @bot : Pointer to the bot
+//  @freeAll : if FALSE only the objects are freed. If TRUE bot memory
+//              will also be freed
+//
+//  @return : pointer to bot or NULL if freed
+//
+PBOT bot_free(PBOT const bot, BOOL freeAll);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_BOT_h__
+
+// EOF
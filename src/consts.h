@@ -35,6 +35,9 @@
 #ifdef _DEBUG_
 #define IDM_DEBUG           3
 #define IDS_DEBUG           "Debug"
+
+#define IDM_FRAMES          4
+#define IDS_FRAMES          "Frames"
 #endif // #ifdef _DEBUG_
 
 #define IDM_SCORES          5
@@ -69,12 +72,36 @@
 
 // "pause" image
 //
-#ifdef DEST_CASIO_CALC
-    #define IMG_PAUSE_W         CASIO_WIDTH
-    #define IMG_PAUSE_H         70
-    #define IMG_PAUSE_COPY_Y    46
-    #define IMG_PAUSE_LINES     (CASIO_HEIGHT - IMG_PAUSE_H)
-#endif // #ifdef DEST_CASIO_CALC
+#define IMG_PAUSE_W         CASIO_WIDTH
+#define IMG_PAUSE_H         70
+#define IMG_PAUSE_COPY_Y    46
+#define IMG_PAUSE_LINES     (CASIO_HEIGHT - IMG_PAUSE_H)
+
+#ifdef _DEBUG_
+// Drawing statistics (debug mode)
+//
+#define FRAMES_TITLE_Y      20
+#define FRAMES_TOP          45
+#define FRAMES_HEIGHT       18
+#define FRAMES_COL_NAME     40
+#define FRAMES_COL_VALUES   150     // Right of the first column
+#define FRAMES_COL_WIDTH    60
+#endif // #ifdef _DEBUG_
+
+#ifdef TRACE_MODE
+// Trace events (TRACE_MODE)
+//
+#define TRACE_KEY           0       // Key pressed in a game : code
+#define TRACE_STATE         1       // board_setGameStateEx() : state, redraw
+#define TRACE_GRID          2       // board_drawGridEx() : first visible col, row
+#define TRACE_SCROLL        3       // board_scrollGridEx() : dx, dy in pixels
+#define TRACE_SELECT        4       // board_selectBoxEx() : col, row
+#define TRACE_UNSELECT      5
+#define TRACE_CHROME        6       // Copy of the borders not allocated : size in pixels
+#define TRACE_EVENTS        7
+
+#define TRACE_NAMES         {"Key", "State", "Grid", "Scroll", "Select", "Unselect", "Chrome"}
+#endif // #ifdef TRACE_MODE
 
 // Key codes
 //
@@ -89,11 +116,17 @@ enum GAME_KEY{
     KEY_CODE_RIGHT = KEY_RIGHT,
     KEY_CODE_CAPTURE = KEY_7,
     KEY_CODE_ROTATE_DISPLAY = KEY_XOT,
+    KEY_CODE_ZOOM = KEY_DIV,
+    KEY_CODE_MINIMAP = KEY_VARS,
     KEY_CODE_PAUSE = KEY_OPTN,
     KEY_CODE_EXIT = KEY_EXIT,
     KEY_CODE_STEP = KEY_EXE,
     KEY_CODE_FLAG = KEY_ADD,
-    KEY_CODE_QUESTION = KEY_SUB
+    KEY_CODE_QUESTION = KEY_SUB,
+    KEY_CODE_HINT = KEY_MUL,
+    KEY_CODE_UNDO = KEY_DEL,
+    KEY_CODE_REDO = KEY_ARROW,
+    KEY_CODE_TRACE = KEY_9
 };
 #else
 enum GAME_KEY{
@@ -105,11 +138,17 @@ enum GAME_KEY{
     KEY_CODE_RIGHT = '6',
     KEY_CODE_CAPTURE = '7',
     KEY_CODE_ROTATE_DISPLAY = 'r',
+    KEY_CODE_ZOOM = 'z',
+    KEY_CODE_MINIMAP = 'm',
     KEY_CODE_PAUSE = 'p',
     KEY_CODE_EXIT = 'q',
     KEY_CODE_STEP = 13,
     KEY_CODE_FLAG = '+',
-    KEY_CODE_QUESTION = '-'
+    KEY_CODE_QUESTION = '-',
+    KEY_CODE_HINT = 'h',
+    KEY_CODE_UNDO = 'u',
+    KEY_CODE_REDO = 'y',
+    KEY_CODE_TRACE = 't'
 };
 #endif // #ifdef DEST_CASIO_CALC
 
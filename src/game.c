@@ -10,18 +10,21 @@
 #include "board.h"
 #include "consts.h"
 #include "scores.h"
+#include "save.h"
 #include "shared/keys.h"
 #include "shared/menu.h"
 
 #include <stdint.h>
+#include <string.h>
 
 #ifdef DEST_CASIO_CALC
-    #include "shared/menu.h"
     #include <gint/clock.h>
-    #include <string.h>
 
     extern bopti_image_t g_mine;   // "about" image
     extern bopti_image_t g_pause;
+#else
+    bopti_image_t g_mine = RENDER_IMAGE("mine.png");
+    bopti_image_t g_pause = RENDER_IMAGE("pause.png");
 #endif // #ifdef DEST_CASIO_CALC
 
 // _onNewGame() : Create a new game
@@ -30,6 +33,7 @@
 //  @level : game difficulty level
 //
 void _onNewGame(PBOARD const board, uint8_t level){
+    save_remove(board);     // The suspended game is lost
     if (board_init(board, level)){
         board_update(board, TRUE);
     }
@@ -38,7 +42,6 @@ void _onNewGame(PBOARD const board, uint8_t level){
 // _onAbout() : Show "about" informations
 //
 void _onAbout(){
-#ifdef DEST_CASIO_CALC
     int w, h;
     char copyright[255];    // Should be enough !
     drect(0, 0, CASIO_WIDTH - 1, CASIO_HEIGHT - MENUBAR_DEF_HEIGHT - 1, C_WHITE);
@@ -61,14 +64,11 @@ void _onAbout(){
             COLOUR_BLACK, copyright);
 
     dupdate();
-#endif // #ifdef DEST_CASIO_CALC
 }
 
 // _onPause() : Show pause screen
 //
 void _onPause(){
-#ifdef DEST_CASIO_CALC
-    uint car = KEY_NONE;
     uint16_t y;
 
     // Top of image
@@ -92,6 +92,8 @@ void _onPause(){
 
     dupdate();
 
+#ifdef DEST_CASIO_CALC
+    uint car = KEY_NONE;
     do{
         car = getKey();
     }while (KEY_CODE_PAUSE != car && KEY_CODE_EXIT != car);
@@ -105,11 +107,11 @@ void _onPause(){
 
 // _onShowScores() : Show best scores
 //
-//  @scores : Array of scores
+//  @history : History of the games
 //  @level : Category of scores
 //
-void _onShowScores(PSCORE scores, uint8_t level){
-    if (!scores || level > LEVEL_EXPERT){
+void _onShowScores(PHISTORY history, uint8_t level){
+    if (!history || level > LEVEL_EXPERT){
         return;
     }
 
@@ -128,7 +130,7 @@ void _onShowScores(PSCORE scores, uint8_t level){
 
         menu_update(menu);
 
-        _showScores(scores, level);
+        _showScores(history, level);
 
         while (!end){
             if (menu_handleKeyboard(menu, &action)){
@@ -138,7 +140,7 @@ void _onShowScores(PSCORE scores, uint8_t level){
                     case IDM_NEW_MEDIUM :
                     case IDM_NEW_EXPERT:
                         menubar_activateItem(bar, action.value, SEARCH_BY_ID, TRUE);
-                        _showScores(scores, action.value - IDM_NEW_BEGINNER);
+                        _showScores(history, action.value - IDM_NEW_BEGINNER);
                         menu_update(menu);
                         break;
 
@@ -153,16 +155,18 @@ void _onShowScores(PSCORE scores, uint8_t level){
     }
 }
 
-// _showScores() : Show best scores for the given level
+// _showScores() : Show best scores and statistics for the given level
 //
-//  @scores : Array of scores
+//  @history : History of the games
 //  @level : Category of scores
 //
-void _showScores(PSCORE scores, uint8_t level){
-    if (scores){
-#ifdef DEST_CASIO_CALC
+void _showScores(PHISTORY history, uint8_t level){
+    if (history){
         int y, w, h;
-        char line[255];
+        char line[255], value[16];
+        const HISTORY_WIN* best;
+        uint32_t median;
+        uint16_t rate;
         RECT rect;
 
         strcpy(line, "Best scores - '");
@@ -170,7 +174,7 @@ void _showScores(PSCORE scores, uint8_t level){
         strcat(line,"'");
         dsize(line, NULL, &w, &h);
 
-        setRect(&rect, 70, 15, 250, SCORES_HEIGHT * SCORE_LEVEL_COUNT + 2 * SCORES_TITLE_Y);
+        setRect(&rect, 70, 15, 250, SCORES_HEIGHT * (SCORE_LEVEL_COUNT + 1) + 2 * SCORES_TITLE_Y);
         drect_border(rect.x, rect.y, rect.x + rect.w - 1,  rect.y + rect.h - 1,
                 BKGROUND_COLOUR, 2, COLOUR_RED);
 
@@ -185,18 +189,94 @@ void _showScores(PSCORE scores, uint8_t level){
             line[0] = '1' + id;
             line[1] = 0;
             dtext(SCORES_COL_ID, y, COLOUR_BLACK, line);
-            scores_time2a(scores[level*SCORE_LEVEL_COUNT + id].time, line);
-            strcat(line, " s");
-            dtext(SCORES_COL_SCORE, y, COLOUR_BLACK, line);
+            if ((best = history_best(history, level, id))){
+                scores_time2a(best->time, line);
+                strcat(line, " s");
+                dtext(SCORES_COL_SCORE, y, COLOUR_BLACK, line);
+                scores_efficiency2a(scores_efficiency(best->bbbv, best->time), line);
+                strcat(line, " 3BV/s");
+                dtext(SCORES_COL_BBBV, y, COLOUR_BLACK, line);
+            }
 
             y += SCORES_HEIGHT;
         }
 
+        // Games of the level
+        rate = history_winRate(history, level);
+        __itoa(history->levels[level].played, FALSE, line);
+        strcat(line, " games - ");
+        strcat(line, __itoa(rate / 10, FALSE, value));
+        value[0] = '.';
+        value[1] = '0' + rate % 10;
+        value[2] = 0;
+        strcat(line, value);
+        strcat(line, "% won");
+        if (HISTORY_NO_TIME != (median = history_median(history, level))){
+            strcat(line, " - median ");
+            strcat(line, scores_time2a(median, value));
+            strcat(line, " s");
+        }
+        dtext(SCORES_COL_STATS, y, COLOUR_BLACK, line);
+
         dupdate();
-#endif // DEST_CASIO_CALC
     }
 }
 
+#ifdef _DEBUG_
+// _onShowFrameStats() : Show the drawing statistics of the last frames
+//
+void _onShowFrameStats(){
+    static const char* titles[] = {"last", "min", "mean", "max"};
+    FRAME_SUMMARY summary;
+    uint32_t* values[4];
+    char line[64], value[16];
+    int x, y, w, h;
+    uint8_t counter, col;
+
+    // Values before this screen is drawn
+    frameStats_summary(&summary);
+    values[0] = summary.last;
+    values[1] = summary.min;
+    values[2] = summary.mean;
+    values[3] = summary.max;
+
+#ifndef DEST_CASIO_CALC
+    frameStats_print(&summary);
+#endif // #ifndef DEST_CASIO_CALC
+
+    drect(0, 0, CASIO_WIDTH - 1, CASIO_HEIGHT - MENUBAR_DEF_HEIGHT - 1, C_WHITE);
+
+    __itoa(summary.updates, FALSE, line);
+    strcat(line, " frames - last ");
+    strcat(line, __itoa(summary.frames, FALSE, value));
+    dsize(line, NULL, &w, &h);
+    dtext((CASIO_WIDTH - w) / 2, FRAMES_TITLE_Y, COLOUR_BLACK, line);
+
+    // Values are right-aligned in their column
+    y = FRAMES_TOP;
+    for (col = 0; col < 4; col++){
+        x = FRAMES_COL_VALUES + col * FRAMES_COL_WIDTH;
+        dtext_opt(x, y, COLOUR_BLUE, C_NONE, DTEXT_RIGHT, DTEXT_TOP, titles[col], -1);
+    }
+
+    for (counter = 0; counter < FRAME_COUNTERS; counter++){
+        y += FRAMES_HEIGHT;
+        dtext(FRAMES_COL_NAME, y, COLOUR_BLACK, frameStats_name((FRAME_COUNTER)counter));
+        for (col = 0; col < 4; col++){
+            x = FRAMES_COL_VALUES + col * FRAMES_COL_WIDTH;
+            __itoa(values[col][counter], FALSE, value);
+            dtext_opt(x, y, COLOUR_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, value, -1);
+        }
+    }
+
+    dupdate();
+
+#ifdef DEST_CASIO_CALC
+    getKey();
+#endif // #ifdef DEST_CASIO_CALC
+}
+#endif // #ifdef _DEBUG_
+
 // __callbackTick() : Callback function for timer
 //
 //  This function is used during game to make selected box blink
@@ -216,35 +296,44 @@ static int __callbackTick(volatile int *pTick){
 //
 //  @board : pointer to the game board
 //  @scores : Array of scores
+//  @history : History of the games
 //
 //  @return : FALSE on error
 //
 #ifdef SCREEN_CAPTURE
-BOOL _onStartGame(PBOARD const board, PSCORE scores, BOOL capture){
+BOOL _onStartGame(PBOARD const board, PSCORE scores, PHISTORY history, BOOL capture){
 #else
-BOOL _onStartGame(PBOARD const board, PSCORE scores){
+BOOL _onStartGame(PBOARD const board, PSCORE scores, PHISTORY history){
 #endif // #ifdef SCREEN_CAPTURE
     if (!board){
         return FALSE;
     }
 
     uint key = KEY_NONE;
-    COORD pos = {0,0}, oPos = {0, 0};
+    COORD pos = board->cursor, oPos = board->cursor;
     //BOOL blinkScroll = FALSE;
     BOOL hightLighted = FALSE;
+    BOOL hintPending = FALSE;
+    uint8_t hintStatus = SOLVER_UNKNOWN;
     uint16_t redraw = REDRAW_SELECTION;
 
 #ifdef SCREEN_CAPTURE
     BOOL captureOn = capture;
 #endif // #ifdef SCREEN_CAPTURE
 
+    SMILEY_STATE smiley = board->smileyState;
     board_setGameStateEx(board, STATE_PLAYING, FALSE);
+    if (board->practice){
+        board_setSmileyEx(board, smiley, FALSE);    // Resumed practice game
+    }
+
     board_drawEx(board, FALSE, FALSE);
     board_selectBox(board, &pos);
 
     // Timer for blinking effect
     int tickCount = 0;
     static volatile int tick = 1;
+    uint32_t ms = chrono_ms(&board->chrono);   // Game duration
 
 #ifdef DEST_CASIO_CALC
     int timerID = timer_configure(TIMER_ANY, TIMER_TICK_DURATION * 1000,
@@ -257,6 +346,10 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
     }
 #endif // #ifdef DEST_CASIO_CALC
 
+    if (!chrono_start(&board->chrono)){
+        board->gameState = STATE_CANCELLED;   // No clock => no game
+    }
+
     while (board->gameState == STATE_PLAYING){
         // Time management
 #ifdef DEST_CASIO_CALC
@@ -271,7 +364,9 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
             redraw |= REDRAW_SELECTION; // Time to blink ?
         }
 
-        if (0 == (tickCount % TIMER_SECOND)){
+        // The clock doesn't depend on the loop's duration
+        ms = chrono_ms(&board->chrono);
+        if (ms / 1000 != board->time){
             redraw |= REDRAW_TIME;  // One more second
         }
 
@@ -283,6 +378,10 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
 
         // A keyboard event ?
         key = getKeyEx(NULL);
+        if (KEY_NONE != key){
+            TRACE(TRACE_KEY, key, 0);
+        }
+
         switch (key){
             // Change cursor pos
             //
@@ -305,11 +404,20 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
             // User actions
             //
             case KEY_CODE_STEP:
+                if (SMILEY_LOSE == board->smileyState){
+                    break;  // Practice : the mine must be "unstepped"
+                }
+
+                replay_add(board->replay, (uint16_t)(ms / TIMER_TICK_DURATION), pos.row * board->grid->size.col + pos.col, REPLAY_STEP);
+                solver_update(board->solver);   // Results have to be updated
                 if (_onStep(board, &pos, &redraw)){
                     if (board->steps == board->grid->maxSteps){
                         board_setGameState(board, STATE_WON);
                     }
                 }
+                else if (board->practice){
+                    board_setSmileyEx(board, SMILEY_LOSE, FALSE);
+                }
                 else{
                     board_setGameState(board, STATE_LOST);
                 }
@@ -317,15 +425,35 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
                 break;
 
             case KEY_CODE_FLAG:
-                redraw = _onFlag(board, &pos);
+                if (SMILEY_LOSE != board->smileyState){
+                    replay_add(board->replay, (uint16_t)(ms / TIMER_TICK_DURATION), pos.row * board->grid->size.col + pos.col, REPLAY_FLAG);
+                    redraw = _onFlag(board, &pos);
+                }
                 break;
 
             case KEY_CODE_QUESTION:
-                redraw = _onQuestion(board, &pos);
+                if (SMILEY_LOSE != board->smileyState){
+                    replay_add(board->replay, (uint16_t)(ms / TIMER_TICK_DURATION), pos.row * board->grid->size.col + pos.col, REPLAY_QUESTION);
+                    redraw = _onQuestion(board, &pos);
+                }
+                break;
+
+            case KEY_CODE_HINT:
+                hintPending = TRUE;
+                break;
+
+            case KEY_CODE_UNDO:
+            case KEY_CODE_REDO:
+                redraw = _onUndo(board, KEY_CODE_REDO == key);
+                if (board->steps == board->grid->maxSteps){
+                    board_setGameState(board, STATE_WON);
+                }
                 break;
 
             case KEY_CODE_PAUSE:
+                chrono_stop(&board->chrono);
                 _onPause();
+                chrono_start(&board->chrono);
                 board_update(board, FALSE);    // update screen
                 break;
 
@@ -336,6 +464,23 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
                 redraw = REDRAW_UPDATE | REDRAW_SELECTION /*| REDRAW_SCROLLBARS*/;
                 break;
 
+            // Show / hide the minimap
+            case KEY_CODE_MINIMAP:
+                board->showMinimap = !board->showMinimap;
+                board_drawEx(board, FALSE, FALSE);
+                oPos = pos;
+                redraw = REDRAW_UPDATE | REDRAW_SELECTION;
+                break;
+
+            // Next box size, the cursor stays visible
+            case KEY_CODE_ZOOM:
+                board_setZoom(board, (board->zoom + 1) % ZOOM_COUNT);
+                board_showBox(board, &pos);
+                board_drawEx(board, FALSE, FALSE);
+                oPos = pos;
+                redraw = REDRAW_UPDATE | REDRAW_SELECTION;
+                break;
+
 #ifdef SCREEN_CAPTURE
             case KEY_CODE_CAPTURE:
                 if (captureOn){
@@ -350,20 +495,54 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
                 break;
 #endif // #ifdef SCREEN_CAPTURE
 
-            // Cancel (end) the game
+#ifdef TRACE_MODE
+            // Events of the trace
+            case KEY_CODE_TRACE:
+            {
+                static const char* names[] = TRACE_NAMES;
+#ifdef DEST_CASIO_CALC
+                chrono_stop(&board->chrono);
+                trace_show(names, TRACE_EVENTS);
+                chrono_start(&board->chrono);
+                board_update(board, FALSE);
+#else
+                trace_dump(NULL, names, TRACE_EVENTS);
+#endif // #ifdef DEST_CASIO_CALC
+                break;
+            }
+#endif // #ifdef TRACE_MODE
+
+            // Leave the game (it can be resumed)
             case KEY_CODE_EXIT:
-                board_setGameStateEx(board, STATE_CANCELLED, TRUE);
+                board_setGameState(board, STATE_SUSPENDED);
                 break;
 
             default:
                 break;
         } // switch (key)
 
+        // Solver runs by small steps until the hint is ready
+        if (hintPending && board->gameState == STATE_PLAYING &&
+            solver_step(board->solver)){
+            hintPending = FALSE;
+            redraw |= _onHint(board, &pos, &hintStatus);
+        }
+
+#ifdef _DEBUG_
+        // Boxes whose mine probability has changed
+        if (board_drawHeatmap(board)){
+            redraw |= REDRAW_UPDATE;
+        }
+#endif // #ifdef _DEBUG_
+
         if (redraw != NO_REDRAW){
 
             if (redraw & REDRAW_GRID){
                 board_drawGridEx(board, FALSE); // no screen update
             }
+            else if (redraw & REDRAW_SCROLL){
+                board_scrollGridEx(board, FALSE);   // only the new boxes
+            }
 
             if (redraw & REDRAW_BOX){
                 board_drawBoxAtPos(board, &pos);
@@ -380,6 +559,10 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
                 board_selectBoxEx(board, &pos, hightLighted);
             }
 
+            if (redraw & REDRAW_HINT){
+                board_drawHint(board, &pos, SOLVER_SAFE == hintStatus);
+            }
+
             /*
             if (redraw & REDRAW_SCROLLBARS){
                 blinkScroll = !blinkScroll;
@@ -392,16 +575,16 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
             }
 
             if (redraw & REDRAW_TIME){
-                if (++board->time >= TIMER_MAX_VALUE){
+                if ((board->time = (uint16_t)(ms / 1000)) >= TIMER_MAX_VALUE){
                     board_setGameState(board, STATE_LOST);
                 }
 
                 board_drawTimeEx(board, FALSE);     // Time has changed
             }
 
-#ifdef DEST_CASIO_CALC
+            board_drawMinimap(board);   // Changed boxes and viewport
+
             dupdate();      // (redraw & REDRAW_UPDATE)
-#endif // #ifdef DEST_CASIO_CALC
             redraw = NO_REDRAW;
         } // if (reDraw)
     } // while (board->gameState == STATE_PLAYING)
@@ -412,8 +595,41 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
     }
 #endif // #ifdef DEST_CASIO_CALC
 
+    chrono_stop(&board->chrono);
+
+    // A won or lost game ends with the tick of its last action, not after
+    // the final redraw
+    if (STATE_WON != board->gameState && STATE_LOST != board->gameState){
+        ms = chrono_ms(&board->chrono);
+    }
+
+    if (STATE_SUSPENDED == board->gameState){
+        board->cursor = pos;
+        save_write(board);
+        return TRUE;
+    }
+
+    save_remove(board);
+
+    // The game is over : time to write the replay
+    // (practice games can't be played again without the undos)
+    if (!board->practice){
+        replay_end(board->replay,
+                    (STATE_WON == board->gameState)?REPLAY_WON:((STATE_LOST == board->gameState)?REPLAY_LOST:REPLAY_CANCELLED),
+                    (uint16_t)(ms / TIMER_TICK_DURATION));
+        replay_save(board->replay);
+
+        if (STATE_WON == board->gameState || STATE_LOST == board->gameState){
+            GRID_STATS stats = {0};
+            grid_analyse(board->grid, &stats);
+            history_add(history, board->grid->level,
+                        (STATE_WON == board->gameState)?HISTORY_WON:HISTORY_LOST,
+                        ms, stats.bbbv);
+        }
+    }
+
     if (board->gameState == STATE_WON){
-        _gameWon(board, scores, board->grid->level, tickCount);
+        _gameWon(board, board->practice?NULL:scores, board->grid->level, ms);
     }
 
     return TRUE;
@@ -428,7 +644,6 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores){
 //  @return : FALSE if stepped on a mine
 //
 BOOL _onStep(PBOARD const board, PCOORD const pos, uint16_t* redraw){
-    uint8_t minesAround = 0;
     PBOX box = BOX_AT_POS(board->grid, pos);
 
     // Already stepped ???
@@ -439,38 +654,41 @@ BOOL _onStep(PBOARD const board, PCOORD const pos, uint16_t* redraw){
 
     (*redraw) = REDRAW_UPDATE;
 
-    if (box->mine){
+    BOX_STATE previous = box->state;
+    int16_t count;
+    journal_begin(board->journal);
+    if (GRID_STEP_MINE == (count = grid_step(board->grid, pos, _onReveal, board))){
         // stepped on a mine!
-        box->state =  BS_BLAST;
+        journal_add(board->journal, board->grid, pos, previous);
+        journal_end(board->journal, 0, 0);
+        minimap_touch(board->minimap, pos);
         board_drawBoxAtPos(board, pos);
         return FALSE;
     }
 
-    minesAround = grid_countMines(board->grid, pos);
-    board->steps++;
-    box->state =  BS_DOWN - minesAround;
+    journal_end(board->journal, 0, (uint16_t)count);
+    return TRUE;    // No mine at this pos
+}
+
+//  _onReveal : A box has been revealed by grid_step()
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @param : Pointer to the board
+//
+void _onReveal(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param){
+    PBOARD board = (PBOARD)param;
 
+    journal_add(board->journal, grid, pos, previous);
+    board->steps++;
     if (board_isBoxVisible(board, pos)){
         board_drawBoxAtPos(board, pos);
     }
+    minimap_touch(board->minimap, pos);
 
-    // Auto step surrounding boxes
-    if (!minesAround){
-        COORD nPos;
-        int8_t r,c;
-        for (r=-1; r<=1; r++){
-            for (c=-1; c<=1; c++){
-                nPos = (COORD){.col = pos->col + c, .row = pos->row + r};
-                if ((r || c) &&
-                    nPos.col < board->grid->size.col &&
-                    nPos.row < board->grid->size.row){
-                        _onStep(board, &nPos, redraw);
-                }
-            }
-        }
-    }
-
-    return TRUE;    // No mine at this pos
+#ifdef _DEBUG_
+    heatmap_touch(board->heatmap, pos);
+#endif // #ifdef _DEBUG_
 }
 
 // _onFlag() : Put / remove a flag
@@ -486,8 +704,12 @@ uint16_t _onFlag(PBOARD const board, PCOORD const pos){
 
     if (box->state <= BS_QUESTION){
         flagPresent = (box->state == BS_FLAG);
+        journal_begin(board->journal);
+        journal_add(board->journal, board->grid, pos, box->state);
         box->state = (flagPresent?BS_INITIAL:BS_FLAG);
         board->minesLeft += flagPresent?+1:-1;    // mines left !!
+        journal_end(board->journal, flagPresent?+1:-1, 0);
+        minimap_touch(board->minimap, pos);
         return REDRAW_BOX | REDRAW_MINES_LEFT;
     }
 
@@ -507,13 +729,108 @@ uint16_t _onQuestion(PBOARD const board, PCOORD const pos){
 
     if (box->state <= BS_QUESTION){
         questionPresent = (box->state == BS_QUESTION);
+        journal_begin(board->journal);
+        journal_add(board->journal, board->grid, pos, box->state);
         box->state = (questionPresent?BS_INITIAL:BS_QUESTION);
+        journal_end(board->journal, 0, 0);
+        minimap_touch(board->minimap, pos);
         return REDRAW_BOX;
     }
 
     return NO_REDRAW;
 }
 
+// _onUndo() : Undo or redo the last action
+//
+//  The game becomes a practice game : a mine can be "unstepped" but
+//  the score won't be kept
+//
+//  @board : pointer to the current board
+//  @redo : TRUE to redo the last undone action
+//
+//  @return drawing action to perform or NO_DRAWING
+//
+uint16_t _onUndo(PBOARD const board, BOOL redo){
+    uint16_t redraw = NO_REDRAW;
+
+    if (!board->practice){
+        board->practice = TRUE;
+        board_setSmileyEx(board, SMILEY_CAUTION, FALSE);
+        redraw = REDRAW_UPDATE;
+    }
+
+    if (redo?journal_redo(board->journal, board->grid, &board->minesLeft, &board->steps, _onRestore, board):
+            journal_undo(board->journal, board->grid, &board->minesLeft, &board->steps, _onRestore, board)){
+        // Deductions may rely on boxes that are covered again
+        solver_init(board->solver, board->grid);
+        redraw = REDRAW_UPDATE | REDRAW_MINES_LEFT;
+
+#ifdef _DEBUG_
+        // ... and so do all the cached probabilities
+        heatmap_init(board->heatmap, board->grid, board->solver);
+        if (board->debug){
+            redraw |= REDRAW_GRID | REDRAW_MOVE;
+        }
+#endif // #ifdef _DEBUG_
+    }
+
+    return redraw;
+}
+
+//  _onRestore : A box has been changed by an undo or a redo
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @previous : State of the box before the change
+//  @param : Pointer to the board
+//
+void _onRestore(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param){
+    PBOARD board = (PBOARD)param;
+
+    // Mine (un)stepped
+    if (BS_BLAST == BOX_AT_POS(grid, pos)->state){
+        board_setSmileyEx(board, SMILEY_LOSE, FALSE);
+    }
+    else if (BS_BLAST == previous){
+        board_setSmileyEx(board, SMILEY_CAUTION, FALSE);
+    }
+
+    if (board_isBoxVisible(board, pos)){
+        board_drawBoxAtPos(board, pos);
+    }
+    minimap_touch(board->minimap, pos);
+
+#ifdef _DEBUG_
+    heatmap_touch(board->heatmap, pos);
+#endif // #ifdef _DEBUG_
+}
+
+// _onHint() : Move the cursor to the hint box
+//
+//  The solver must be up to date
+//
+//  @board : pointer to the current board
+//  @pos : Current position in the grid, updated with the hint position
+//  @status : pointer to the hint status (SOLVER_SAFE or SOLVER_UNKNOWN)
+//
+//  @return drawing action to perform or NO_DRAWING
+//
+uint16_t _onHint(PBOARD const board, PCOORD const pos, uint8_t* status){
+    COORD hint;
+    uint16_t action = REDRAW_MOVE | REDRAW_HINT;
+
+    if (SOLVER_MINE == (*status = solver_getHint(board->solver, &hint))){
+        return NO_REDRAW;   // No covered box
+    }
+
+    if (board_showBox(board, &hint)){
+        action |= REDRAW_SCROLL;
+    }
+
+    *pos = hint;
+    return action;
+}
+
 // _onKeyLeftEx() : User press "left" key
 //
 //  @board : pointer to the game board
@@ -522,18 +839,18 @@ uint16_t _onQuestion(PBOARD const board, PCOORD const pos){
 //
 //  @return : TDrawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyLeftEx(PBOARD const board, PCOORD pos, BOOL check){
+uint16_t _onKeyLeftEx(PBOARD const board, PCOORD pos, BOOL check){
 
     if (check && CALC_HORIZONTAL == board->orientation){
         return _onKeyUpEx(board, pos, FALSE);
     }
 
-    uint8_t action = NO_REDRAW;
+    uint16_t action = NO_REDRAW;
 
     if (pos->col){
         if (board->viewPort.visibleFrame.x == pos->col){
             board->viewPort.visibleFrame.x--;
-            action = REDRAW_GRID;
+            action = REDRAW_SCROLL;
         }
 
         pos->col--;
@@ -551,18 +868,18 @@ uint8_t _onKeyLeftEx(PBOARD const board, PCOORD pos, BOOL check){
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyDownEx(PBOARD const board, PCOORD pos, BOOL check){
+uint16_t _onKeyDownEx(PBOARD const board, PCOORD pos, BOOL check){
 
     if (check && CALC_HORIZONTAL == board->orientation){
         return _onKeyLeftEx(board, pos, FALSE);
     }
 
-    uint8_t action = NO_REDRAW;
+    uint16_t action = NO_REDRAW;
 
     if (pos->row < (board->viewPort.dimensions.row - 1)){
         if ((board->viewPort.visibleFrame.y + board->viewPort.visibleFrame.h - 1) == pos->row){
             board->viewPort.visibleFrame.y++;
-            action = REDRAW_GRID;
+            action = REDRAW_SCROLL;
         }
 
         pos->row++;
@@ -580,17 +897,17 @@ uint8_t _onKeyDownEx(PBOARD const board, PCOORD pos, BOOL check){
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyRightEx(PBOARD const board, PCOORD pos, BOOL check){
+uint16_t _onKeyRightEx(PBOARD const board, PCOORD pos, BOOL check){
     if (check && CALC_HORIZONTAL == board->orientation){
         return _onKeyDownEx(board, pos, FALSE);
     }
 
-    uint8_t action = NO_REDRAW;
+    uint16_t action = NO_REDRAW;
 
     if (pos->col < (board->viewPort.dimensions.col - 1)){
         if ((board->viewPort.visibleFrame.x + board->viewPort.visibleFrame.w - 1) == pos->col){
             board->viewPort.visibleFrame.x++;
-            action = REDRAW_GRID;
+            action = REDRAW_SCROLL;
         }
 
         pos->col++;
@@ -608,17 +925,17 @@ uint8_t _onKeyRightEx(PBOARD const board, PCOORD pos, BOOL check){
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyUpEx(PBOARD const board, PCOORD pos, BOOL check){
+uint16_t _onKeyUpEx(PBOARD const board, PCOORD pos, BOOL check){
     if (check && CALC_HORIZONTAL == board->orientation){
         return _onKeyRightEx(board, pos, FALSE);
     }
 
-    uint8_t action = NO_REDRAW;
+    uint16_t action = NO_REDRAW;
 
     if (pos->row){
         if (board->viewPort.visibleFrame.y == pos->row){
             board->viewPort.visibleFrame.y--;
-            action = REDRAW_GRID;
+            action = REDRAW_SCROLL;
         }
 
         pos->row--;
@@ -634,8 +951,10 @@ uint8_t _onKeyUpEx(PBOARD const board, PCOORD pos, BOOL check){
 //  @scores : Array of scores
 //  @level, @time : new score
 //
-void _gameWon(PBOARD const board, PSCORE scores, uint8_t level, int time){
-    BOOL added = scores_add(scores, level, time);
+void _gameWon(PBOARD const board, PSCORE scores, uint8_t level, uint32_t time){
+    GRID_STATS stats = {0};
+    grid_analyse(board->grid, &stats);
+    BOOL added = scores_add(scores, level, time, stats.bbbv);
 
     uint car = KEY_NONE;
     RECT rect = {0,0,280,94};
@@ -655,7 +974,9 @@ void _gameWon(PBOARD const board, PSCORE scores, uint8_t level, int time){
         char out[100], score[10];
         strcpy(out, "New score : ");
         strcat(out, scores_time2a(time, score));
-        strcat(out,"s");
+        strcat(out,"s - ");
+        strcat(out, scores_efficiency2a(scores_efficiency(stats.bbbv, time), score));
+        strcat(out," 3BV/s");
         dtext(rect.x + APP_LOGO_WIDTH + 20 , rect.y + 60, COLOUR_RED, out);
     }
 
@@ -12,6 +12,7 @@
 #include "consts.h"
 #include "board.h"
 #include "scores.h"
+#include "history.h"
 
 #ifdef DEST_CASIO_CALC
 #include <gint/timer.h>
@@ -38,6 +39,8 @@
 #define REDRAW_GRID             64
 
 #define REDRAW_UPDATE           128     // Just update
+#define REDRAW_HINT             256     // Highlight the hint
+#define REDRAW_SCROLL           512     // The viewport has moved
 
 #ifdef __cplusplus
 extern "C" {
@@ -60,29 +63,36 @@ void _onPause();
 
 // _onShowScores() : Show best scores
 //
-//  @scores : Array of scores
+//  @history : History of the games
 //  @level : Category of scores
 //
-void _onShowScores(PSCORE scores, uint8_t level);
+void _onShowScores(PHISTORY history, uint8_t level);
 
-// _showScores() : Show best scores for the given level
+// _showScores() : Show best scores and statistics for the given level
 //
-//  @scores : Array of scores
+//  @history : History of the games
 //  @level : Category of scores to display
 //
-void _showScores(PSCORE scores, uint8_t level);
+void _showScores(PHISTORY history, uint8_t level);
+
+#ifdef _DEBUG_
+// _onShowFrameStats() : Show the drawing statistics of the last frames
+//
+void _onShowFrameStats();
+#endif // #ifdef _DEBUG_
 
 // _onStartGame() : Start a new game
 //
 //  @board : pointer to the game board
 //  @scores : Array of scores
+//  @history : History of the games
 //
 //  @return : FALSE on error
 //
 #ifdef SCREEN_CAPTURE
-BOOL _onStartGame(PBOARD const board, PSCORE scores, BOOL capture);
+BOOL _onStartGame(PBOARD const board, PSCORE scores, PHISTORY history, BOOL capture);
 #else
-BOOL _onStartGame(PBOARD const board, PSCORE scores);
+BOOL _onStartGame(PBOARD const board, PSCORE scores, PHISTORY history);
 #endif // #ifdef SCREEN_CAPTURE
 
 //  _onStep : User steps on a box
@@ -95,6 +105,36 @@ BOOL _onStartGame(PBOARD const board, PSCORE scores);
 //
 BOOL _onStep(PBOARD const board, PCOORD const pos, uint16_t* redraw);
 
+//  _onReveal : A box has been revealed by grid_step()
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @previous : State of the box before it was revealed
+//  @param : Pointer to the board
+//
+void _onReveal(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param);
+
+// _onUndo() : Undo or redo the last action
+//
+//  The game becomes a practice game : a mine can be "unstepped" but
+//  the score won't be kept
+//
+//  @board : pointer to the current board
+//  @redo : TRUE to redo the last undone action
+//
+//  @return drawing action to perform or NO_DRAWING
+//
+uint16_t _onUndo(PBOARD const board, BOOL redo);
+
+//  _onRestore : A box has been changed by an undo or a redo
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @previous : State of the box before the change
+//  @param : Pointer to the board
+//
+void _onRestore(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param);
+
 // _onFlag() : Put / remove a flag
 //
 //  @board : pointer to the current board
@@ -113,6 +153,18 @@ uint16_t _onFlag(PBOARD const board, PCOORD const pos);
 //
 uint16_t _onQuestion(PBOARD const board, PCOORD const pos);
 
+// _onHint() : Move the cursor to the hint box
+//
+//  The solver must be up to date
+//
+//  @board : pointer to the current board
+//  @pos : Current position in the grid, updated with the hint position
+//  @status : pointer to the hint status (SOLVER_SAFE or SOLVER_UNKNOWN)
+//
+//  @return drawing action to perform or NO_DRAWING
+//
+uint16_t _onHint(PBOARD const board, PCOORD const pos, uint8_t* status);
+
 // _onKeyLeftEx() : User press "left" key
 //
 //  @board : pointer to the game board
@@ -121,7 +173,7 @@ uint16_t _onQuestion(PBOARD const board, PCOORD const pos);
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyLeftEx(PBOARD const board, PCOORD pos, BOOL check);
+uint16_t _onKeyLeftEx(PBOARD const board, PCOORD pos, BOOL check);
 #define _onKeyLeft(board, pos) _onKeyLeftEx(board, pos, TRUE)
 
 // _onKeyDownEx() : User press "down" key
@@ -132,7 +184,7 @@ uint8_t _onKeyLeftEx(PBOARD const board, PCOORD pos, BOOL check);
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyDownEx(PBOARD const board, PCOORD pos, BOOL check);
+uint16_t _onKeyDownEx(PBOARD const board, PCOORD pos, BOOL check);
 #define _onKeyDown(board, pos) _onKeyDownEx(board, pos, TRUE)
 
 // _onKeyRightEx() : User press "right" key
@@ -143,7 +195,7 @@ uint8_t _onKeyDownEx(PBOARD const board, PCOORD pos, BOOL check);
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyRightEx(PBOARD const board, PCOORD pos, BOOL check);
+uint16_t _onKeyRightEx(PBOARD const board, PCOORD pos, BOOL check);
 #define _onKeyRight(board, pos) _onKeyRightEx(board, pos, TRUE)
 
 // _onKeyUpEx() : User press "up" key
@@ -154,7 +206,7 @@ uint8_t _onKeyRightEx(PBOARD const board, PCOORD pos, BOOL check);
 //
 //  @return : Drawing action(s) to perform or NO_REDRAW
 //
-uint8_t _onKeyUpEx(PBOARD const board, PCOORD pos, BOOL check);
+uint16_t _onKeyUpEx(PBOARD const board, PCOORD pos, BOOL check);
 #define _onKeyUp(board, pos) _onKeyUpEx(board, pos, TRUE)
 
 // _gameWon() : The user won the game
@@ -163,7 +215,7 @@ uint8_t _onKeyUpEx(PBOARD const board, PCOORD pos, BOOL check);
 //  @scores : Array of scores
 //  @level, @time : new score
 //
-void _gameWon(PBOARD const board, PSCORE scores, uint8_t level, int time);
+void _gameWon(PBOARD const board, PSCORE scores, uint8_t level, uint32_t time);
 
 #ifdef __cplusplus
 }
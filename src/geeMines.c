@@ -10,6 +10,7 @@
 #include "shared/menu.h"
 
 #include "game.h"
+#include "save.h"
 
 //
 // Functions
@@ -35,6 +36,7 @@ POWNMENU _createMenu(){
             menubar_appendItem(bar, IDM_START, IDS_START, ITEM_STATE_INACTIVE, ITEM_STATUS_DEFAULT);
 #ifdef _DEBUG_
             menubar_appendItem(bar, IDM_DEBUG, IDS_DEBUG, ITEM_STATE_UNCHECKED, ITEM_STATUS_CHECKBOX);
+            menubar_appendItem(bar, IDM_FRAMES, IDS_FRAMES, ITEM_STATE_DEFAULT, ITEM_STATUS_DEFAULT);
 #endif // #ifdef _DEBUG_
             menubar_addItem(bar, MENU_POS_RIGHT - 1, IDM_SCORES, IDS_SCORES, ITEM_STATE_DEFAULT, ITEM_STATUS_DEFAULT);
             menubar_addItem(bar, MENU_POS_RIGHT, IDM_QUIT, IDS_QUIT, ITEM_STATE_DEFAULT, ITEM_STATUS_DEFAULT);
@@ -56,16 +58,29 @@ int main(void){
         BOOL end = FALSE;
         MENUACTION action;
         PSCORE scores = NULL;
+        PHISTORY history = history_create();
 #ifdef SCREEN_CAPTURE
         BOOL captureOn = FALSE;
 #endif // #ifdef SCREEN_CAPTURE
 
         _onAbout();
 
-        if (NULL != (scores = scores_load())){
+        scores = scores_load();
+        if (history){
+            // First run : the history starts with the best scores
+            if (!history_load(history)){
+                history_import(history, scores);
+            }
+
             menubar_activateItem(menu_getMenuBar(menu), IDM_SCORES, SEARCH_BY_ID, TRUE);
         }
 
+        // A game has been left : it can be resumed
+        if (save_read(board)){
+            board_update(board, TRUE);
+            menubar_activateItem(menu_getMenuBar(menu), IDM_START, SEARCH_BY_ID, TRUE);
+        }
+
         menu_update(menu);
 
         while (!end){
@@ -85,11 +100,11 @@ int main(void){
                     // Start the game
                     case IDM_START:
 #ifdef SCREEN_CAPTURE
-                        _onStartGame(board, scores, captureOn);
+                        _onStartGame(board, scores, history, captureOn);
 #else
-                        _onStartGame(board, scores);
+                        _onStartGame(board, scores, history);
 #endif // #ifdef SCREEN_CAPTURE
-                        menubar_activateItem(menu_getMenuBar(menu), IDM_START, SEARCH_BY_ID, FALSE);
+                        menubar_activateItem(menu_getMenuBar(menu), IDM_START, SEARCH_BY_ID, STATE_SUSPENDED == board->gameState);
                         menu_update(menu);  // back to current menu
                         break;
 
@@ -101,6 +116,12 @@ int main(void){
                         menubar_checkMenuItem(menu_getMenuBar(menu), IDM_DEBUG, SEARCH_BY_ID, board->debug?ITEM_CHECKED:ITEM_UNCHECKED);
                         menu_update(menu);
                         break;
+
+                    case IDM_FRAMES:
+                        _onShowFrameStats();
+                        board_update(board, TRUE);
+                        menu_update(menu);
+                        break;
 #endif // #ifdef _DEBUG_
 
 #ifdef SCREEN_CAPTURE
@@ -129,9 +150,21 @@ int main(void){
                         menu_update(menu);
                         break;
 
+                    case KEY_CODE_MINIMAP:
+                        board->showMinimap = !board->showMinimap;
+                        board_drawEx(board, TRUE, FALSE);
+                        menu_update(menu);
+                        break;
+
+                    case KEY_CODE_ZOOM:
+                        board_setZoom(board, (board->zoom + 1) % ZOOM_COUNT);
+                        board_drawEx(board, TRUE, FALSE);
+                        menu_update(menu);
+                        break;
+
                     // Show high scores
                     case IDM_SCORES:
-                        _onShowScores(scores, LEVEL_BEGINNER);
+                        _onShowScores(history, LEVEL_BEGINNER);
                         _onAbout();
                         menu_update(menu);
                         break;
@@ -154,6 +187,8 @@ int main(void){
             scores_free(scores);
         }
 
+        history_free(history);
+
     }   // if (menu)
 
     if (board){
@@ -21,6 +21,8 @@
 // Internal consts
 //
 
+static void _freeRegions(PGRID const grid);
+
 //  grid_create() : Create a grid
 //
 //  @return : pointer to the new created grid
@@ -80,6 +82,7 @@ BOOL grid_init(PGRID const grid, GAME_LEVEL level){
                         box = BOX_AT(grid, r, c);
                         box->mine = FALSE;
                         box->state = BS_INITIAL;
+                        box->around = 0;
                     }
                 }
 
@@ -97,22 +100,38 @@ BOOL grid_init(PGRID const grid, GAME_LEVEL level){
 
 //  grid_layMines() : Put mines in the grid
 //
+//  A new seed is computed from the clock
+//
 //  @grid : Pointer to the grid
-//  @level : Difficulty of the new grid
 //
 //  @return : count of mines in the current grid (0 if error)
 //
 uint8_t grid_layMines(PGRID const grid){
+    uint32_t seed = (uint32_t)clock() * 2654435761u;    // Knuth's multiplier
+    return grid_layMinesEx(grid, seed?seed:1);
+}
+
+//  grid_layMinesEx() : Put mines in the grid using a given seed
+//
+//  The same seed always gives the same grid (for a given level)
+//
+//  @grid : Pointer to the grid
+//  @seed : Seed of the random generator (0 is not a valid seed)
+//
+//  @return : count of mines in the current grid (0 if error)
+//
+uint8_t grid_layMinesEx(PGRID const grid, uint32_t seed){
 
     uint8_t mines = 0;
     uint8_t r,c;
+    uint32_t state = seed;
     PBOX box;
 
-    if (grid && grid->mines){
-        srand((unsigned int)clock());
+    if (grid && grid->mines && seed){
+        grid->seed = seed;
         while (mines < grid->mines){
-            r = (uint8_t)(rand() % grid->size.row);
-            c = (uint8_t)(rand() % grid->size.col);
+            r = (uint8_t)(grid_random(&state) % grid->size.row);
+            c = (uint8_t)(grid_random(&state) % grid->size.col);
             box = BOX_AT(grid, r, c);
 
             if (!box->mine){
@@ -120,11 +139,187 @@ uint8_t grid_layMines(PGRID const grid){
                 mines++;
             }
         }
+
+        // Work done before the timer starts
+        grid_computeRegions(grid);
     }
 
     return mines;
 }
 
+//  grid_computeRegions() : Count the mines around each box and list
+//                          the empty areas
+//
+//  Must be called when the mines have been set (grid_layMinesEx calls it)
+//
+//  @grid : Pointer to the grid
+//
+//  @return : TRUE if done
+//
+BOOL grid_computeRegions(PGRID const grid){
+    uint16_t parent[GRID_MAX_BOXES];
+    uint16_t count, id, nId, root, nRoot, total, region, regions[8];
+    uint8_t r, c, nr, nc, pass, found, index;
+    int8_t dr, dc;
+    PBOX box;
+
+    if (!grid || !grid->boxes ||
+        (count = grid->size.col * grid->size.row) > GRID_MAX_BOXES){
+        return FALSE;
+    }
+
+    _freeRegions(grid);
+
+    // Mines around each box
+    for (id = 0; id < count; id++){
+        grid->boxes[id].around = 0;
+    }
+    for (id = 0; id < count; id++){
+        if (grid->boxes[id].mine){
+            r = id / grid->size.col;
+            c = id % grid->size.col;
+            for (dr = -1; dr <= 1; dr++){
+                for (dc = -1; dc <= 1; dc++){
+                    nr = r + dr;
+                    nc = c + dc;
+                    if ((dr || dc) && nr < grid->size.row && nc < grid->size.col){
+                        BOX_AT(grid, nr, nc)->around++;
+                    }
+                }
+            }
+        }
+    }
+
+    if (!(grid->boxRegion = (uint16_t*)malloc(count * sizeof(uint16_t)))){
+        return FALSE;
+    }
+
+    // Empty areas : union-find with the neighbours already seen (W, NW, N, NE)
+    for (id = 0; id < count; id++){
+        box = &grid->boxes[id];
+        grid->boxRegion[id] = GRID_NO_REGION;
+        if (box->mine || box->around){
+            continue;
+        }
+
+        parent[id] = id;
+        r = id / grid->size.col;
+        c = id % grid->size.col;
+        for (dr = -1; dr <= 0; dr++){
+            for (dc = -1; dc <= 1 && (dr || dc < 0); dc++){
+                nr = r + dr;
+                nc = c + dc;
+                if (nr < grid->size.row && nc < grid->size.col){
+                    nId = nr * grid->size.col + nc;
+                    if (!grid->boxes[nId].mine && !grid->boxes[nId].around){
+                        for (root = id; parent[root] != root; root = parent[root] = parent[parent[root]]);
+                        for (nRoot = nId; parent[nRoot] != nRoot; nRoot = parent[nRoot] = parent[parent[nRoot]]);
+                        if (root != nRoot){
+                            parent[root] = nRoot;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Area IDs : roots are found before the other boxes of their area
+    for (id = 0; id < count; id++){
+        if (!grid->boxes[id].mine && !grid->boxes[id].around){
+            for (root = id; parent[root] != root; root = parent[root]);
+            if (GRID_NO_REGION == grid->boxRegion[root]){
+                grid->boxRegion[root] = grid->regionCount++;
+            }
+            grid->boxRegion[id] = grid->boxRegion[root];
+        }
+    }
+
+    if (!(grid->regionStart = (uint16_t*)malloc((grid->regionCount + 1) * sizeof(uint16_t)))){
+        _freeRegions(grid);
+        return FALSE;
+    }
+    memset(grid->regionStart, 0, (grid->regionCount + 1) * sizeof(uint16_t));
+
+    // Pass 0 : size of each area, pass 1 : fill the lists
+    for (pass = 0; pass < 2; pass++){
+        for (id = 0; id < count; id++){
+            box = &grid->boxes[id];
+            if (box->mine){
+                continue;
+            }
+
+            // Areas the box belongs to
+            found = 0;
+            if (!box->around){
+                regions[found++] = grid->boxRegion[id];
+            }
+            else{
+                r = id / grid->size.col;
+                c = id % grid->size.col;
+                for (dr = -1; dr <= 1; dr++){
+                    for (dc = -1; dc <= 1; dc++){
+                        nr = r + dr;
+                        nc = c + dc;
+                        if ((dr || dc) && nr < grid->size.row && nc < grid->size.col &&
+                            GRID_NO_REGION != (root = grid->boxRegion[nr * grid->size.col + nc])){
+                            for (index = 0; index < found && regions[index] != root; index++);
+                            if (index == found){
+                                regions[found++] = root;
+                            }
+                        }
+                    }
+                }
+            }
+
+            for (index = 0; index < found; index++){
+                if (pass){
+                    grid->regionBoxes[grid->regionStart[regions[index]]++] = id;
+                }
+                else{
+                    grid->regionStart[regions[index] + 1]++;
+                }
+            }
+        }
+
+        if (!pass){
+            // Sizes => indexes
+            for (region = 0, total = 0; region <= grid->regionCount; region++){
+                total += grid->regionStart[region];
+                grid->regionStart[region] = total;
+            }
+
+            if (!(grid->regionBoxes = (uint16_t*)malloc((total?total:1) * sizeof(uint16_t)))){
+                _freeRegions(grid);
+                return FALSE;
+            }
+        }
+    }
+
+    // Each start has moved to the next area
+    for (id = grid->regionCount; id > 0; id--){
+        grid->regionStart[id] = grid->regionStart[id - 1];
+    }
+    grid->regionStart[0] = 0;
+
+    return TRUE;
+}
+
+//  grid_random() : Pseudo-random generator (xorshift32)
+//
+//  The generator has no global state and can be used by many threads
+//
+//  @state : Pointer to the generator state (must not be 0)
+//
+//  @return : next random value
+//
+uint32_t grid_random(uint32_t* state){
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return (*state = x);
+}
+
 #ifndef DEST_CASIO_CALC
 //  grid_display() : Display the grid (for tests on Linux)
 //
@@ -178,6 +373,230 @@ uint8_t grid_countMines(PGRID const grid, PCOORD const pos){
     return sMines;
 }
 
+//  grid_step() : Step on a box
+//
+//  Empty areas are recursively revealed. No drawing is done : the
+//  callback is called for each revealed box
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @onReveal : Callback function (can be NULL)
+//  @param : Parameter given to the callback
+//
+//  @return : count of revealed boxes or GRID_STEP_MINE
+//
+int16_t grid_step(PGRID const grid, PCOORD const pos, GRID_REVEAL_CB onReveal, void* param){
+    uint16_t id = pos->row * grid->size.col + pos->col, index;
+    int16_t count = 0;
+    PBOX box = &grid->boxes[id];
+    BOX_STATE previous;
+    COORD nPos;
+
+    // Already stepped ???
+    if (box->state > BS_QUESTION){
+        return 0;
+    }
+
+    if (box->mine){
+        // stepped on a mine!
+        box->state = BS_BLAST;
+        return GRID_STEP_MINE;
+    }
+
+    if (box->around || !grid->boxRegion){
+        previous = box->state;
+        box->state = BS_DOWN - (grid->boxRegion?box->around:grid_countMines(grid, pos));
+        if (onReveal){
+            onReveal(grid, pos, previous, param);
+        }
+
+        if (grid->boxRegion || BS_DOWN != box->state){
+            return 1;
+        }
+
+        // No list (not enough memory) => flood
+        int8_t r,c;
+        count = 1;
+        for (r=-1; r<=1; r++){
+            for (c=-1; c<=1; c++){
+                nPos = (COORD){.col = pos->col + c, .row = pos->row + r};
+                if ((r || c) &&
+                    nPos.col < grid->size.col &&
+                    nPos.row < grid->size.row){
+                        count += grid_step(grid, &nPos, onReveal, param);
+                }
+            }
+        }
+
+        return count;
+    }
+
+    // The whole area
+    for (index = grid->regionStart[grid->boxRegion[id]];
+        index < grid->regionStart[grid->boxRegion[id] + 1]; index++){
+        box = &grid->boxes[grid->regionBoxes[index]];
+        if (box->state <= BS_QUESTION){
+            previous = box->state;
+            box->state = BS_DOWN - box->around;
+            count++;
+            if (onReveal){
+                nPos.col = grid->regionBoxes[index] % grid->size.col;
+                nPos.row = grid->regionBoxes[index] / grid->size.col;
+                onReveal(grid, &nPos, previous, param);
+            }
+        }
+    }
+
+    return count;
+}
+
+//  grid_analyse() : Difficulty of a grid
+//
+//  Empty areas are found in a single pass (union-find on the empty boxes).
+//  The ZiNi estimate is a greedy pass on the isolated numbers : a number
+//  is chorded when it costs less than clicking its hidden neighbours
+//
+//  @grid : Pointer to the grid
+//  @stats : Difficulty of the grid
+//
+//  @return : TRUE if done
+//
+BOOL grid_analyse(PGRID const grid, PGRID_STATS stats){
+    uint8_t counts[GRID_MAX_BOXES];     // # of mines around each box
+    uint8_t flags[GRID_MAX_BOXES];
+    uint16_t parent[GRID_MAX_BOXES];    // Empty areas
+    uint16_t count, id, nId, root, nRoot, zeros = 0, unions = 0;
+    uint8_t r, c, nr, nc, hidden, missing;
+    int8_t dr, dc;
+
+    if (!grid || !grid->boxes || !stats ||
+        (count = grid->size.col * grid->size.row) > GRID_MAX_BOXES){
+        return FALSE;
+    }
+
+    memset(stats, 0, sizeof(GRID_STATS));
+    memset(counts, 0, count);
+    memset(flags, 0, count);
+
+    // Numbers : each mine increments its neighbours
+    for (id = 0; id < count; id++){
+        if (grid->boxes[id].mine){
+            r = id / grid->size.col;
+            c = id % grid->size.col;
+            for (dr = -1; dr <= 1; dr++){
+                for (dc = -1; dc <= 1; dc++){
+                    nr = r + dr;
+                    nc = c + dc;
+                    if ((dr || dc) && nr < grid->size.row && nc < grid->size.col){
+                        counts[nr * grid->size.col + nc]++;
+                    }
+                }
+            }
+        }
+    }
+
+    // Empty areas and isolated numbers
+    for (id = 0; id < count; id++){
+        if (grid->boxes[id].mine){
+            continue;
+        }
+
+        r = id / grid->size.col;
+        c = id % grid->size.col;
+
+        if (!counts[id]){
+            // Join the empty neighbours already seen (W, NW, N, NE)
+            zeros++;
+            parent[id] = id;
+            for (dr = -1; dr <= 0; dr++){
+                for (dc = -1; dc <= 1 && (dr || dc < 0); dc++){
+                    nr = r + dr;
+                    nc = c + dc;
+                    if (nr < grid->size.row && nc < grid->size.col){
+                        nId = nr * grid->size.col + nc;
+                        if (!grid->boxes[nId].mine && !counts[nId]){
+                            for (root = id; parent[root] != root; root = parent[root] = parent[parent[root]]);
+                            for (nRoot = nId; parent[nRoot] != nRoot; nRoot = parent[nRoot] = parent[parent[nRoot]]);
+                            if (root != nRoot){
+                                parent[root] = nRoot;
+                                unions++;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        else{
+            // A number is revealed by an empty neighbour
+            flags[id] = 1;  // Isolated
+            for (dr = -1; dr <= 1 && flags[id]; dr++){
+                for (dc = -1; dc <= 1; dc++){
+                    nr = r + dr;
+                    nc = c + dc;
+                    if ((dr || dc) && nr < grid->size.row && nc < grid->size.col &&
+                        !grid->boxes[nr * grid->size.col + nc].mine &&
+                        !counts[nr * grid->size.col + nc]){
+                        flags[id] = 0;
+                        break;
+                    }
+                }
+            }
+
+            stats->isolated += flags[id];
+        }
+    }
+
+    stats->openings = zeros - unions;
+    stats->bbbv = stats->openings + stats->isolated;
+
+    // ZiNi estimate : flags[] = 1 for hidden numbers, 2 for flagged mines
+    stats->zini = stats->openings;
+    for (id = 0; id < count; id++){
+        if (1 != flags[id]){
+            continue;
+        }
+
+        stats->zini++;  // Click
+        flags[id] = 0;
+
+        r = id / grid->size.col;
+        c = id % grid->size.col;
+        hidden = missing = 0;
+        for (dr = -1; dr <= 1; dr++){
+            for (dc = -1; dc <= 1; dc++){
+                nr = r + dr;
+                nc = c + dc;
+                if ((dr || dc) && nr < grid->size.row && nc < grid->size.col){
+                    nId = nr * grid->size.col + nc;
+                    if (grid->boxes[nId].mine){
+                        missing += (2 != flags[nId]);
+                    }
+                    else{
+                        hidden += (1 == flags[nId]);
+                    }
+                }
+            }
+        }
+
+        // Chord ?
+        if (missing + 1 < hidden){
+            stats->zini += missing + 1;
+            for (dr = -1; dr <= 1; dr++){
+                for (dc = -1; dc <= 1; dc++){
+                    nr = r + dr;
+                    nc = c + dc;
+                    if ((dr || dc) && nr < grid->size.row && nc < grid->size.col){
+                        nId = nr * grid->size.col + nc;
+                        flags[nId] = grid->boxes[nId].mine?2:0;
+                    }
+                }
+            }
+        }
+    }
+
+    return TRUE;
+}
+
 //  grid_free() : Free memory allocated for a grid
 //
 //  @grid : Pointer to the grid
@@ -193,6 +612,8 @@ PGRID grid_free(PGRID const grid, BOOL freeAll){
             grid->boxes = NULL;
         }
 
+        _freeRegions(grid);
+
         if (freeAll){
             free(grid);
             return NULL;
@@ -202,4 +623,29 @@ PGRID grid_free(PGRID const grid, BOOL freeAll){
     return grid;
 }
 
+//
+// Internal functions
+//
+
+// _freeRegions() : Free the lists of empty areas
+//
+static void _freeRegions(PGRID const grid){
+    if (grid->regionStart){
+        free(grid->regionStart);
+        grid->regionStart = NULL;
+    }
+
+    if (grid->regionBoxes){
+        free(grid->regionBoxes);
+        grid->regionBoxes = NULL;
+    }
+
+    if (grid->boxRegion){
+        free(grid->boxRegion);
+        grid->boxRegion = NULL;
+    }
+
+    grid->regionCount = 0;
+}
+
 // EOF
@@ -34,6 +34,7 @@ typedef enum{
 typedef struct __box{
     BOOL mine          : 1;
     BOX_STATE state    : 5;
+    uint8_t around     : 4;     // # of mines around the box
 } BOX, * PBOX;
 
 // Types of grids
@@ -50,6 +51,8 @@ typedef struct __box{
 #define EXPERT_COLS         30
 #define EXPERT_ROWS         16
 
+#define GRID_MAX_BOXES      (EXPERT_COLS * EXPERT_ROWS)
+
 // Box coordinates (in the grid)
 //
 typedef struct __coord{
@@ -74,13 +77,51 @@ typedef struct __grid{
     uint8_t     mines;     // count of mines
     DIMS        size;
     PBOX        boxes;
-    uint8_t     maxSteps;   // # of boxes free of mines
+    uint16_t    maxSteps;   // # of boxes free of mines
+    uint32_t    seed;       // Seed used to lay the mines
+
+    // Empty areas (computed when mines are laid)
+    uint16_t    regionCount;
+    uint16_t*   regionStart;    // Index of the first box of each area in regionBoxes
+                                // (regionCount + 1 values)
+    uint16_t*   regionBoxes;    // Boxes of the areas : empty boxes and their borders
+    uint16_t*   boxRegion;      // Area of each box (GRID_NO_REGION if not empty)
 } GRID, * PGRID;
 
+#define GRID_NO_REGION      0xFFFF
+
+// Difficulty of a grid
+//
+typedef struct __gridStats{
+    uint16_t bbbv;          // 3BV : min. count of clicks to clear the grid
+    uint16_t openings;      // # of empty areas
+    uint16_t isolated;      // # of numbers that don't border an empty area
+    uint16_t zini;          // Estimated clicks with flags and chords
+} GRID_STATS, * PGRID_STATS;
+
+// Result of grid_step() when stepping on a mine
+//
+#define GRID_STEP_MINE      -1
+
+// Called by grid_step() for each revealed box
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the revealed box
+//  @previous : State of the box before it was revealed
+//  @param : User's parameter
+//
+typedef void (*GRID_REVEAL_CB)(PGRID const grid, PCOORD const pos, BOX_STATE previous, void* param);
+
 // Helpers for box access in the grid
 //
-#define BOX_AT(grid, r, c) (&grid->boxes[(int)r * (int)grid->size.col + (int)c])
-#define BOX_AT_POS(grid, pos) (&grid->boxes[(int)pos->row * (int)grid->size.col + (int)pos->col])
+#define BOX_AT(grid, r, c) (&(grid)->boxes[(int)(r) * (int)(grid)->size.col + (int)(c)])
+#define BOX_AT_POS(grid, pos) (&(grid)->boxes[(int)(pos)->row * (int)(grid)->size.col + (int)(pos)->col])
+
+// Visible state of a box
+//
+#define BOX_IS_COVERED(box)     ((box)->state <= BS_QUESTION)
+#define BOX_IS_NUMBER(box)      ((box)->state >= BS_NUM8)     // BS_DOWN is a "0"
+#define BOX_NUMBER(box)         (BS_DOWN - (box)->state)
 
 //  grid_create() : Create a grid
 //
@@ -99,13 +140,46 @@ BOOL grid_init(PGRID const grid, GAME_LEVEL level);
 
 //  grid_layMines() : Put mines in the grid
 //
+//  A new seed is computed from the clock
+//
 //  @grid : Pointer to the grid
-//  @level : Difficulty of the new grid
 //
 //  @return : count of mines in the current grid (0 if error)
 //
 uint8_t grid_layMines(PGRID const grid);
 
+//  grid_layMinesEx() : Put mines in the grid using a given seed
+//
+//  The same seed always gives the same grid (for a given level)
+//
+//  @grid : Pointer to the grid
+//  @seed : Seed of the random generator (0 is not a valid seed)
+//
+//  @return : count of mines in the current grid (0 if error)
+//
+uint8_t grid_layMinesEx(PGRID const grid, uint32_t seed);
+
+//  grid_computeRegions() : Count the mines around each box and list
+//                          the empty areas
+//
+//  Must be called when the mines have been set (grid_layMinesEx calls it)
+//
+//  @grid : Pointer to the grid
+//
+//  @return : TRUE if done
+//
+BOOL grid_computeRegions(PGRID const grid);
+
+//  grid_random() : Pseudo-random generator (xorshift32)
+//
+//  The generator has no global state and can be used by many threads
+//
+//  @state : Pointer to the generator state (must not be 0)
+//
+//  @return : next random value
+//
+uint32_t grid_random(uint32_t* state);
+
 #ifndef DEST_CASIO_CALC
 //  grid_display() : Display the grid (for tests on Linux)
 //
@@ -123,6 +197,34 @@ void grid_display(PGRID const grid);
 //
 uint8_t grid_countMines(PGRID const grid, PCOORD const pos);
 
+//  grid_step() : Step on a box
+//
+//  Stepping on an empty box reveals its whole area (from the list computed
+//  by grid_computeRegions). No drawing is done : the callback is called
+//  for each revealed box
+//
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @onReveal : Callback function (can be NULL)
+//  @param : Parameter given to the callback
+//
+//  @return : count of revealed boxes or GRID_STEP_MINE
+//
+int16_t grid_step(PGRID const grid, PCOORD const pos, GRID_REVEAL_CB onReveal, void* param);
+
+//  grid_analyse() : Difficulty of a grid
+//
+//  Empty areas are found in a single pass (union-find on the empty boxes).
+//  The ZiNi estimate is a greedy pass on the isolated numbers : a number
+//  is chorded when it costs less than clicking its hidden neighbours
+//
+//  @grid : Pointer to the grid
+//  @stats : Difficulty of the grid
+//
+//  @return : TRUE if done
+//
+BOOL grid_analyse(PGRID const grid, PGRID_STATS stats);
+
 //  grid_free() : Free memory allocated for a grid
 //
 //  @grid : Pointer to the grid
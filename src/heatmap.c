@@ -0,0 +1,551 @@
+//----------------------------------------------------------------------
+//--
+//--    heatmap.c
+//--
+//--            Cached mine probabilities of the covered boxes
+//--
+//----------------------------------------------------------------------
+
+#include "heatmap.h"
+
+#include <string.h>
+
+// Enumeration of a component
+//
+typedef struct __enumContext{
+    uint8_t varCount;
+    uint8_t rowCount;
+    uint16_t vars[HEATMAP_MAX_VARS];        // box index of each var.
+    uint8_t varRows[HEATMAP_MAX_VARS][8];   // rows of each var.
+    uint8_t varRowCount[HEATMAP_MAX_VARS];
+    uint16_t rowBoxes[HEATMAP_MAX_ROWS];    // box index of each row (ie. number)
+    int8_t rowRhs[HEATMAP_MAX_ROWS];
+    int8_t rowMines[HEATMAP_MAX_ROWS];      // mines in the current assignment
+    int8_t rowLeft[HEATMAP_MAX_ROWS];       // unassigned vars.
+    uint32_t assignment;
+    uint32_t solutions;
+    uint32_t mines[HEATMAP_MAX_VARS];       // solutions with a mine for each var.
+    uint16_t nodes;
+    BOOL aborted;
+} ENUMCONTEXT, * PENUMCONTEXT;
+
+static void _markDirty(PHEATMAP const heatmap, uint16_t id);
+static void _setFrontier(PHEATMAP const heatmap, uint16_t id, BOOL frontier);
+static void _setProb(PHEATMAP const heatmap, uint16_t id, uint8_t prob);
+static BOOL _hasNumber(PHEATMAP const heatmap, uint16_t id);
+static uint16_t _component(PHEATMAP const heatmap, uint16_t id, uint16_t* list);
+static BOOL _enumerate(PHEATMAP const heatmap, uint16_t* list, uint16_t count);
+static void _assign(PENUMCONTEXT const ctx, uint8_t var);
+
+//  heatmap_create() : Create an empty cache
+//
+//  @return : pointer to the new cache or NULL
+//
+PHEATMAP heatmap_create(){
+    size_t size = sizeof(HEATMAP);
+    PHEATMAP heatmap = (PHEATMAP)malloc(size);
+    if (heatmap){
+        memset(heatmap, 0, size);
+    }
+    return heatmap;
+}
+
+//  heatmap_init() : Attach the cache to a new grid
+//
+//  All boxes are dirty
+//
+//  @heatmap : Pointer to the cache
+//  @grid : Grid to analyse (only boxes states are used)
+//  @solver : Known boxes
+//
+//  @return : TRUE if done
+//
+BOOL heatmap_init(PHEATMAP const heatmap, PGRID const grid, PSOLVER const solver){
+    uint16_t id;
+
+    if (!heatmap || !grid || !grid->boxes || !solver || !solver->boxes){
+        return FALSE;
+    }
+
+    heatmap_free(heatmap, FALSE);
+    heatmap->grid = grid;
+    heatmap->solver = solver;
+    heatmap->boxCount = grid->size.col * grid->size.row;
+
+    heatmap->probs = (uint8_t*)malloc(heatmap->boxCount);
+    heatmap->flags = (uint8_t*)malloc(heatmap->boxCount);
+    heatmap->dirty = (uint16_t*)malloc(heatmap->boxCount * sizeof(uint16_t));
+    heatmap->changed = (uint16_t*)malloc(heatmap->boxCount * sizeof(uint16_t));
+    heatmap->list = (uint16_t*)malloc(heatmap->boxCount * sizeof(uint16_t));
+    if (!heatmap->probs || !heatmap->flags || !heatmap->dirty ||
+        !heatmap->changed || !heatmap->list){
+        heatmap_free(heatmap, FALSE);
+        return FALSE;
+    }
+
+    memset(heatmap->flags, 0, heatmap->boxCount);
+    memset(heatmap->probs, 0, heatmap->boxCount);
+    heatmap->interior = (uint8_t)(grid->mines * HEATMAP_PROB_MAX / heatmap->boxCount);
+
+    for (id = 0; id < heatmap->boxCount; id++){
+        if (BOX_IS_COVERED(&grid->boxes[id])){
+            heatmap->covered++;
+        }
+        else{
+            heatmap->flags[id] = HEATMAP_REVEALED;
+        }
+
+        _markDirty(heatmap, id);
+    }
+
+    return TRUE;
+}
+
+//  heatmap_touch() : A box has been revealed
+//
+//  @heatmap : Pointer to the cache
+//  @pos : Position of the box
+//
+void heatmap_touch(PHEATMAP const heatmap, PCOORD const pos){
+    uint16_t id;
+    uint8_t r, c;
+
+    if (!heatmap || !heatmap->flags){
+        return;
+    }
+
+    id = pos->row * heatmap->grid->size.col + pos->col;
+    if (heatmap->flags[id] & HEATMAP_REVEALED){
+        return;
+    }
+
+    _setFrontier(heatmap, id, FALSE);
+    heatmap->flags[id] |= HEATMAP_REVEALED;
+    heatmap->covered--;
+
+    // Constraints within 2 boxes have changed
+    for (r = (pos->row > 2?pos->row - 2:0); r <= pos->row + 2 && r < heatmap->grid->size.row; r++){
+        for (c = (pos->col > 2?pos->col - 2:0); c <= pos->col + 2 && c < heatmap->grid->size.col; c++){
+            _markDirty(heatmap, r * heatmap->grid->size.col + c);
+        }
+    }
+}
+
+//  heatmap_update() : Compute the dirty components
+//
+//  Boxes whose drawn value has changed are listed in heatmap->changed
+//
+//  @heatmap : Pointer to the cache
+//
+//  @return : count of boxes whose drawn value has changed
+//
+uint16_t heatmap_update(PHEATMAP const heatmap){
+    uint16_t i, id, count, risk, visited = 0;
+    int32_t interior;
+    uint8_t status, level;
+
+    if (!heatmap || !heatmap->flags || !heatmap->dirtyCount){
+        return (heatmap?heatmap->changedCount:0);
+    }
+
+    for (i = 0; i < heatmap->dirtyCount; i++){
+        id = heatmap->dirty[i];
+        if (heatmap->flags[id] & (HEATMAP_VISITED | HEATMAP_REVEALED)){
+            continue;
+        }
+
+        // Known box
+        status = heatmap->solver->boxes[id];
+        if (SOLVER_UNKNOWN != status){
+            _setFrontier(heatmap, id, TRUE);
+            _setProb(heatmap, id, (SOLVER_MINE == status)?HEATMAP_PROB_MAX:0);
+            continue;
+        }
+
+        // Far from the numbers
+        if (!_hasNumber(heatmap, id)){
+            _setFrontier(heatmap, id, FALSE);
+            continue;
+        }
+
+        // The whole component is computed again
+        count = _component(heatmap, id, heatmap->list + visited);
+        if (!_enumerate(heatmap, heatmap->list + visited, count)){
+            // Too large => local estimate
+            for (uint16_t v = visited; v < visited + count; v++){
+                id = heatmap->list[v];
+                risk = solver_getRisk(heatmap->solver, id / heatmap->grid->size.col,
+                            id % heatmap->grid->size.col, heatmap->interior);
+                _setFrontier(heatmap, id, TRUE);
+                _setProb(heatmap, id, (uint8_t)MIN_VAL(risk, HEATMAP_PROB_MAX));
+            }
+        }
+        visited += count;
+    }
+
+    // Clear flags
+    for (i = 0; i < heatmap->dirtyCount; i++){
+        heatmap->flags[heatmap->dirty[i]] &= ~HEATMAP_DIRTY;
+    }
+    for (i = 0; i < visited; i++){
+        heatmap->flags[heatmap->list[i]] &= ~HEATMAP_VISITED;
+    }
+    heatmap->dirtyCount = 0;
+
+    // Boxes far from the numbers share the mines left
+    if (heatmap->covered > heatmap->frontier){
+        interior = ((int32_t)heatmap->grid->mines * HEATMAP_PROB_MAX - (int32_t)heatmap->frontierSum)
+                    / (heatmap->covered - heatmap->frontier);
+        interior = SET_IN_RANGE(interior, 0, HEATMAP_PROB_MAX);
+        level = HEATMAP_LEVEL(heatmap->interior);
+        heatmap->interior = (uint8_t)interior;
+        if (HEATMAP_LEVEL(heatmap->interior) != level){
+            // Rare : all interior boxes have to be drawn again
+            for (id = 0; id < heatmap->boxCount; id++){
+                if (!(heatmap->flags[id] & (HEATMAP_FRONTIER | HEATMAP_REVEALED | HEATMAP_CHANGED))){
+                    heatmap->flags[id] |= HEATMAP_CHANGED;
+                    heatmap->changed[heatmap->changedCount++] = id;
+                }
+            }
+        }
+    }
+
+    return heatmap->changedCount;
+}
+
+//  heatmap_clearChanged() : Changed boxes have been drawn
+//
+//  @heatmap : Pointer to the cache
+//
+void heatmap_clearChanged(PHEATMAP const heatmap){
+    if (heatmap && heatmap->flags){
+        for (uint16_t i = 0; i < heatmap->changedCount; i++){
+            heatmap->flags[heatmap->changed[i]] &= ~HEATMAP_CHANGED;
+        }
+        heatmap->changedCount = 0;
+    }
+}
+
+//  heatmap_getProb() : Cached mine probability of a box
+//
+//  @heatmap : Pointer to the cache
+//  @pos : Position of the box
+//
+//  @return : Probability in 1/HEATMAP_PROB_MAX
+//
+uint8_t heatmap_getProb(PHEATMAP const heatmap, PCOORD const pos){
+    uint16_t id;
+
+    if (!heatmap || !heatmap->flags){
+        return 0;
+    }
+
+    id = pos->row * heatmap->grid->size.col + pos->col;
+    return ((heatmap->flags[id] & HEATMAP_FRONTIER)?heatmap->probs[id]:heatmap->interior);
+}
+
+//  heatmap_free() : Free memory used by a cache
+//
+//  @heatmap : Pointer to the cache
+//  @freeAll : if FALSE only buffers are freed. If TRUE cache memory
+//              will also be freed
+//
+//  @return : pointer to cache or NULL if freed
+//
+PHEATMAP heatmap_free(PHEATMAP const heatmap, BOOL freeAll){
+    if (heatmap){
+        if (heatmap->probs){
+            free(heatmap->probs);
+        }
+        if (heatmap->flags){
+            free(heatmap->flags);
+        }
+        if (heatmap->dirty){
+            free(heatmap->dirty);
+        }
+        if (heatmap->changed){
+            free(heatmap->changed);
+        }
+        if (heatmap->list){
+            free(heatmap->list);
+        }
+
+        if (freeAll){
+            free(heatmap);
+            return NULL;
+        }
+
+        memset(heatmap, 0, sizeof(HEATMAP));
+    }
+
+    return heatmap;
+}
+
+//
+// Internal functions
+//
+
+// _markDirty() : Add a box to the dirty list
+//
+static void _markDirty(PHEATMAP const heatmap, uint16_t id){
+    if (!(heatmap->flags[id] & HEATMAP_DIRTY)){
+        heatmap->flags[id] |= HEATMAP_DIRTY;
+        heatmap->dirty[heatmap->dirtyCount++] = id;
+    }
+}
+
+// _setFrontier() : Add or remove a box from the frontier
+//
+static void _setFrontier(PHEATMAP const heatmap, uint16_t id, BOOL frontier){
+    if (frontier){
+        if (!(heatmap->flags[id] & HEATMAP_FRONTIER)){
+            heatmap->flags[id] |= HEATMAP_FRONTIER;
+            heatmap->frontier++;
+            heatmap->frontierSum += heatmap->probs[id];
+        }
+    }
+    else{
+        if (heatmap->flags[id] & HEATMAP_FRONTIER){
+            heatmap->flags[id] &= ~HEATMAP_FRONTIER;
+            heatmap->frontier--;
+            heatmap->frontierSum -= heatmap->probs[id];
+        }
+    }
+}
+
+// _setProb() : New probability of a frontier box
+//
+//  The box is added to the changed list if its tint has changed
+//
+static void _setProb(PHEATMAP const heatmap, uint16_t id, uint8_t prob){
+    uint8_t old = heatmap->probs[id];
+
+    heatmap->probs[id] = prob;
+    heatmap->frontierSum += prob;
+    heatmap->frontierSum -= old;
+
+    if (HEATMAP_LEVEL(old) != HEATMAP_LEVEL(prob) &&
+        !(heatmap->flags[id] & HEATMAP_CHANGED)){
+        heatmap->flags[id] |= HEATMAP_CHANGED;
+        heatmap->changed[heatmap->changedCount++] = id;
+    }
+}
+
+// _hasNumber() : Is there a revealed number next to the box ?
+//
+static BOOL _hasNumber(PHEATMAP const heatmap, uint16_t id){
+    PGRID grid = heatmap->grid;
+    uint8_t r = id / grid->size.col, c = id % grid->size.col;
+    int8_t dr, dc;
+
+    for (dr = -1; dr <= 1; dr++){
+        for (dc = -1; dc <= 1; dc++){
+            if ((dr || dc) &&
+                (uint8_t)(r + dr) < grid->size.row &&
+                (uint8_t)(c + dc) < grid->size.col &&
+                BOX_IS_NUMBER(BOX_AT(grid, r + dr, c + dc))){
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+// _component() : List the unsolved boxes sharing numbers with a box
+//
+//  @heatmap : Pointer to the cache
+//  @id : First box of the component
+//  @list : Destination buffer
+//
+//  @return : count of boxes in the component
+//
+static uint16_t _component(PHEATMAP const heatmap, uint16_t id, uint16_t* list){
+    PGRID grid = heatmap->grid;
+    uint16_t head = 0, count = 0, nId, wId;
+    uint8_t r, c, nr, nc;
+    int8_t dr, dc, ddr, ddc;
+
+    heatmap->flags[id] |= HEATMAP_VISITED;
+    list[count++] = id;
+
+    while (head < count){
+        r = list[head] / grid->size.col;
+        c = list[head] % grid->size.col;
+        head++;
+
+        for (dr = -1; dr <= 1; dr++){
+            for (dc = -1; dc <= 1; dc++){
+                nr = r + dr;
+                nc = c + dc;
+                if (!(dr || dc) || nr >= grid->size.row || nc >= grid->size.col){
+                    continue;
+                }
+
+                nId = nr * grid->size.col + nc;
+                if (!BOX_IS_NUMBER(&grid->boxes[nId])){
+                    continue;
+                }
+
+                // Boxes around the number
+                for (ddr = -1; ddr <= 1; ddr++){
+                    for (ddc = -1; ddc <= 1; ddc++){
+                        if ((ddr || ddc) &&
+                            (uint8_t)(nr + ddr) < grid->size.row &&
+                            (uint8_t)(nc + ddc) < grid->size.col){
+                            wId = (nr + ddr) * grid->size.col + nc + ddc;
+                            if (BOX_IS_COVERED(&grid->boxes[wId]) &&
+                                SOLVER_UNKNOWN == heatmap->solver->boxes[wId] &&
+                                !(heatmap->flags[wId] & HEATMAP_VISITED)){
+                                heatmap->flags[wId] |= HEATMAP_VISITED;
+                                list[count++] = wId;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return count;
+}
+
+// _enumerate() : Probabilities of the boxes of a component
+//
+//  All the mines layouts of the component matching its numbers are
+//  counted (layouts have the same weight)
+//
+//  @heatmap : Pointer to the cache
+//  @list : Boxes of the component
+//  @count : Count of boxes
+//
+//  @return : FALSE if the component can't be enumerated
+//
+static BOOL _enumerate(PHEATMAP const heatmap, uint16_t* list, uint16_t count){
+    PGRID grid = heatmap->grid;
+    ENUMCONTEXT ctx;
+    uint16_t nId, wId;
+    uint8_t v, row, r, c, nr, nc;
+    int8_t dr, dc, ddr, ddc;
+
+    if (count > HEATMAP_MAX_VARS){
+        return FALSE;
+    }
+
+    memset(&ctx, 0, sizeof(ENUMCONTEXT));
+    ctx.varCount = (uint8_t)count;
+    memcpy(ctx.vars, list, count * sizeof(uint16_t));
+
+    // Rows : numbers around the vars.
+    for (v = 0; v < ctx.varCount; v++){
+        r = ctx.vars[v] / grid->size.col;
+        c = ctx.vars[v] % grid->size.col;
+        for (dr = -1; dr <= 1; dr++){
+            for (dc = -1; dc <= 1; dc++){
+                nr = r + dr;
+                nc = c + dc;
+                if (!(dr || dc) || nr >= grid->size.row || nc >= grid->size.col){
+                    continue;
+                }
+
+                nId = nr * grid->size.col + nc;
+                if (!BOX_IS_NUMBER(&grid->boxes[nId])){
+                    continue;
+                }
+
+                // New row ?
+                for (row = 0; row < ctx.rowCount && ctx.rowBoxes[row] != nId; row++);
+                if (row == ctx.rowCount){
+                    ctx.rowBoxes[ctx.rowCount++] = nId;
+                    ctx.rowRhs[row] = BOX_NUMBER(&grid->boxes[nId]);
+
+                    // Known mines around the number
+                    for (ddr = -1; ddr <= 1; ddr++){
+                        for (ddc = -1; ddc <= 1; ddc++){
+                            if ((ddr || ddc) &&
+                                (uint8_t)(nr + ddr) < grid->size.row &&
+                                (uint8_t)(nc + ddc) < grid->size.col){
+                                wId = (nr + ddr) * grid->size.col + nc + ddc;
+                                if (BOX_IS_COVERED(&grid->boxes[wId]) &&
+                                    SOLVER_MINE == heatmap->solver->boxes[wId]){
+                                    ctx.rowRhs[row]--;
+                                }
+                            }
+                        }
+                    }
+                }
+
+                ctx.varRows[v][ctx.varRowCount[v]++] = row;
+                ctx.rowLeft[row]++;
+            }
+        }
+    }
+
+    _assign(&ctx, 0);
+
+    if (ctx.aborted || !ctx.solutions){
+        return FALSE;
+    }
+
+    for (v = 0; v < ctx.varCount; v++){
+        _setFrontier(heatmap, ctx.vars[v], TRUE);
+        _setProb(heatmap, ctx.vars[v], (uint8_t)((uint64_t)ctx.mines[v] * HEATMAP_PROB_MAX / ctx.solutions));
+    }
+
+    return TRUE;
+}
+
+// _assign() : Recursive assignment of the vars.
+//
+//  @ctx : Enumeration context
+//  @var : var. to assign
+//
+static void _assign(PENUMCONTEXT const ctx, uint8_t var){
+    uint8_t i, row, mine;
+    BOOL valid;
+
+    if (ctx->aborted || ++ctx->nodes > HEATMAP_MAX_NODES){
+        ctx->aborted = TRUE;
+        return;
+    }
+
+    if (var == ctx->varCount){
+        ctx->solutions++;
+        for (i = 0; i < ctx->varCount; i++){
+            if (ctx->assignment & ((uint32_t)1 << i)){
+                ctx->mines[i]++;
+            }
+        }
+        return;
+    }
+
+    for (mine = 0; mine <= 1; mine++){
+        valid = TRUE;
+        for (i = 0; i < ctx->varRowCount[var]; i++){
+            row = ctx->varRows[var][i];
+            ctx->rowLeft[row]--;
+            ctx->rowMines[row] += mine;
+            if (ctx->rowMines[row] > ctx->rowRhs[row] ||
+                ctx->rowMines[row] + ctx->rowLeft[row] < ctx->rowRhs[row]){
+                valid = FALSE;
+            }
+        }
+
+        if (valid){
+            if (mine){
+                ctx->assignment |= ((uint32_t)1 << var);
+            }
+            _assign(ctx, var + 1);
+            ctx->assignment &= ~((uint32_t)1 << var);
+        }
+
+        // Undo
+        for (i = 0; i < ctx->varRowCount[var]; i++){
+            row = ctx->varRows[var][i];
+            ctx->rowLeft[row]++;
+            ctx->rowMines[row] -= mine;
+        }
+    }
+}
+
+// EOF
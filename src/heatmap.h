@@ -0,0 +1,138 @@
+//----------------------------------------------------------------------
+//--
+//--    heatmap.h
+//--
+//--            Cached mine probabilities of the covered boxes
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_HEATMAP_h__
+#define __GEE_MINES_HEATMAP_h__    1
+
+#include "grid.h"
+#include "solver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// Covered boxes next to revealed numbers are grouped in components : two
+// boxes are in the same component when they share a number. Probabilities
+// of a component only depend on its own constraints.
+//
+// When a box is revealed, only the components within 2 boxes of it can
+// change. These boxes are marked "dirty" and only their components are
+// computed again. Other boxes keep their cached value.
+//
+// A component is enumerated when it is small enough, its boxes get the
+// local risk estimate of the solver otherwise. Boxes far from any number
+// share a single "interior" value.
+//
+
+// Probabilities
+//
+#define HEATMAP_PROB_MAX        255
+#define HEATMAP_LEVELS          16      // Count of drawn tints
+#define HEATMAP_LEVEL(prob)     ((prob) * HEATMAP_LEVELS / (HEATMAP_PROB_MAX + 1))
+
+// Enumeration limits
+//
+#define HEATMAP_MAX_VARS        24      // Max. boxes in an enumerated component
+#define HEATMAP_MAX_ROWS        (8 * HEATMAP_MAX_VARS)
+#define HEATMAP_MAX_NODES       20000   // Max. nodes in the search tree
+
+// Box flags
+//
+#define HEATMAP_DIRTY           1       // Box's constraints have changed
+#define HEATMAP_CHANGED         2       // Drawn value has changed
+#define HEATMAP_VISITED         4       // Component already computed
+#define HEATMAP_FRONTIER        8       // Box has a revealed neighbour
+#define HEATMAP_REVEALED        16
+
+// The cache
+//
+typedef struct __heatmap{
+    PGRID grid;
+    PSOLVER solver;         // Known boxes
+    uint16_t boxCount;
+    uint16_t covered;       // # of covered boxes
+    uint16_t frontier;      // # of covered boxes with a revealed neighbour
+    uint32_t frontierSum;   // Sum of frontier boxes probabilities
+    uint8_t interior;       // Prob. of the boxes with no revealed neighbour
+    uint8_t* probs;         // Prob. of each box (in 1/HEATMAP_PROB_MAX)
+    uint8_t* flags;         // HEATMAP_xxx for each box
+    uint16_t dirtyCount;
+    uint16_t* dirty;        // Dirty boxes
+    uint16_t changedCount;
+    uint16_t* changed;      // Boxes whose drawn value has changed
+    uint16_t* list;         // Buffer for components
+} HEATMAP, * PHEATMAP;
+
+//  heatmap_create() : Create an empty cache
+//
+//  @return : pointer to the new cache or NULL
+//
+PHEATMAP heatmap_create();
+
+//  heatmap_init() : Attach the cache to a new grid
+//
+//  All boxes are dirty
+//
+//  @heatmap : Pointer to the cache
+//  @grid : Grid to analyse (only boxes states are used)
+//  @solver : Known boxes
+//
+//  @return : TRUE if done
+//
+BOOL heatmap_init(PHEATMAP const heatmap, PGRID const grid, PSOLVER const solver);
+
+//  heatmap_touch() : A box has been revealed
+//
+//  @heatmap : Pointer to the cache
+//  @pos : Position of the box
+//
+void heatmap_touch(PHEATMAP const heatmap, PCOORD const pos);
+
+//  heatmap_update() : Compute the dirty components
+//
+//  Boxes whose drawn value has changed are listed in heatmap->changed
+//
+//  @heatmap : Pointer to the cache
+//
+//  @return : count of boxes whose drawn value has changed
+//
+uint16_t heatmap_update(PHEATMAP const heatmap);
+
+//  heatmap_clearChanged() : Changed boxes have been drawn
+//
+//  @heatmap : Pointer to the cache
+//
+void heatmap_clearChanged(PHEATMAP const heatmap);
+
+//  heatmap_getProb() : Cached mine probability of a box
+//
+//  @heatmap : Pointer to the cache
+//  @pos : Position of the box
+//
+//  @return : Probability in 1/HEATMAP_PROB_MAX
+//
+uint8_t heatmap_getProb(PHEATMAP const heatmap, PCOORD const pos);
+
+//  heatmap_free() : Free memory used by a cache
+//
+//  @heatmap : Pointer to the cache
+//  @freeAll : if FALSE only buffers are freed. If TRUE cache memory
+//              will also be freed
+//
+//  @return : pointer to cache or NULL if freed
+//
+PHEATMAP heatmap_free(PHEATMAP const heatmap, BOOL freeAll);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_HEATMAP_h__
+
+// EOF
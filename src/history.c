@@ -0,0 +1,376 @@
+//----------------------------------------------------------------------
+//--
+//--    history.c
+//--
+//--            History of all the finished games
+//--
+//----------------------------------------------------------------------
+
+#include "history.h"
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+
+#ifdef DEST_CASIO_CALC
+#include <gint/rtc.h>
+#else
+#include <time.h>
+#endif // #ifdef DEST_CASIO_CALC
+
+// Header
+//
+#define HEADER_MAGIC        "GMH"
+
+// Columns in a block
+//
+#define COL_GAMES           0
+#define COL_TIME            (COL_GAMES + HISTORY_BLOCK_ROWS)
+#define COL_BBBV            (COL_TIME + 4 * HISTORY_BLOCK_ROWS)
+#define COL_DATE            (COL_BBBV + 2 * HISTORY_BLOCK_ROWS)
+#define COL_COUNT           (COL_DATE + 2 * HISTORY_BLOCK_ROWS)
+
+#define GAME_LEVEL_MASK     3
+#define GAME_OUTCOME_SHIFT  2
+
+#define WINS_GROWTH         16
+
+static void _addRow(PHISTORY const history, uint8_t level, uint8_t outcome, uint32_t time, uint16_t bbbv, uint16_t date);
+static BOOL _index(PHISTORY const history, uint8_t level, uint8_t outcome, uint32_t time, uint16_t bbbv);
+static BOOL _writeLast(PHISTORY const history);
+static void _encode(const HISTORY_BLOCK* block, uint8_t* dest);
+static BOOL _decode(const uint8_t* data, PHISTORY_BLOCK block);
+static uint16_t _today();
+
+//  history_create() : Create an empty history
+//
+//  @return : pointer to the history or NULL
+//
+PHISTORY history_create(){
+    PHISTORY history = (PHISTORY)malloc(sizeof(HISTORY));
+    if (history){
+        memset(history, 0, sizeof(HISTORY));
+    }
+    return history;
+}
+
+//  history_load() : Read the history file and build the index
+//
+//  @history : Pointer to the history
+//
+//  @return : TRUE if the file has been read
+//
+BOOL history_load(PHISTORY const history){
+    uint8_t buffer[HISTORY_BLOCK_SIZE];
+    HISTORY_BLOCK block;
+    uint8_t row;
+    int fd;
+
+    if (!history || -1 == (fd = open(HISTORY_FILE, O_RDONLY))){
+        return FALSE;
+    }
+
+    if (HISTORY_HEADER_SIZE != read(fd, buffer, HISTORY_HEADER_SIZE) ||
+        memcmp(buffer, HEADER_MAGIC, 3) || HISTORY_VERSION != buffer[3] ||
+        HISTORY_BLOCK_ROWS != buffer[4]){
+        close(fd);
+        return FALSE;
+    }
+
+    // Only complete blocks are used
+    while (HISTORY_BLOCK_SIZE == read(fd, buffer, HISTORY_BLOCK_SIZE) &&
+            _decode(buffer, &block)){
+        for (row = 0; row < block.count; row++){
+            _index(history, block.games[row] & GAME_LEVEL_MASK,
+                    block.games[row] >> GAME_OUTCOME_SHIFT, block.time[row], block.bbbv[row]);
+        }
+
+        memcpy(&history->last, &block, sizeof(HISTORY_BLOCK));
+        history->blocks++;
+    }
+
+    close(fd);
+    return TRUE;
+}
+
+//  history_import() : Add the best scores to an empty history
+//
+//  Used once when the history file doesn't exist yet : the best scores
+//  are kept as won games of unknown date
+//
+//  @history : Pointer to the history
+//  @scores : Array of scores
+//
+//  @return : TRUE if done
+//
+BOOL history_import(PHISTORY const history, PSCORE const scores){
+    uint8_t id;
+
+    if (!history || !scores || history->blocks){
+        return FALSE;
+    }
+
+    for (id = 0; id < SCORE_COUNT; id++){
+        if (scores[id].bbbv || scores[id].time != SCORE_DEFAULT_TIME(scores[id].level)){
+            _addRow(history, scores[id].level, HISTORY_WON, scores[id].time, scores[id].bbbv, 0);
+        }
+    }
+
+    return (history->blocks?_writeLast(history):TRUE);
+}
+
+//  history_add() : Add a finished game
+//
+//  @history : Pointer to the history
+//  @level : Level of the game
+//  @outcome : HISTORY_WON or HISTORY_LOST
+//  @time : Duration in ms
+//  @bbbv : 3BV of the grid
+//
+//  @return : TRUE if the game has been written
+//
+BOOL history_add(PHISTORY const history, uint8_t level, uint8_t outcome, uint32_t time, uint16_t bbbv){
+    if (!history || level >= HISTORY_LEVELS){
+        return FALSE;
+    }
+
+    _addRow(history, level, outcome, time, bbbv, _today());
+    return _writeLast(history);
+}
+
+//  history_best() : Get one of the best games of a level
+//
+//  @history : Pointer to the history
+//  @level : Level of the games
+//  @rank : Rank of the game (0 for the best one)
+//
+//  @return : pointer to the game or NULL
+//
+const HISTORY_WIN* history_best(const HISTORY* history, uint8_t level, uint16_t rank){
+    if (!history || level >= HISTORY_LEVELS || rank >= history->levels[level].won){
+        return NULL;
+    }
+
+    return &history->levels[level].wins[rank];
+}
+
+//  history_percentile() : Time of the won games at a given percentile
+//
+//  @history : Pointer to the history
+//  @level : Level of the games
+//  @permille : Percentile in 1/1000 (500 for the median)
+//
+//  @return : time in ms or HISTORY_NO_TIME if no game has been won
+//
+uint32_t history_percentile(const HISTORY* history, uint8_t level, uint16_t permille){
+    uint32_t rank;
+    const HISTORY_LEVEL* summary;
+
+    if (!history || level >= HISTORY_LEVELS || !(summary = &history->levels[level])->won){
+        return HISTORY_NO_TIME;
+    }
+
+    // Nearest rank
+    rank = ((uint32_t)MIN_VAL(permille, 1000) * summary->won + 999) / 1000;
+    return summary->wins[rank?(rank - 1):0].time;
+}
+
+//  history_winRate() : Win rate of a level
+//
+//  @history : Pointer to the history
+//  @level : Level of the games
+//
+//  @return : win rate in 1/1000
+//
+uint16_t history_winRate(const HISTORY* history, uint8_t level){
+    if (!history || level >= HISTORY_LEVELS || !history->levels[level].played){
+        return 0;
+    }
+
+    return (uint16_t)((uint32_t)history->levels[level].won * 1000 / history->levels[level].played);
+}
+
+//  history_free() : Free a history
+//
+//  @history : Pointer to the history
+//
+void history_free(PHISTORY const history){
+    uint8_t level;
+
+    if (history){
+        for (level = 0; level < HISTORY_LEVELS; level++){
+            if (history->levels[level].wins){
+                free(history->levels[level].wins);
+            }
+        }
+
+        free(history);
+    }
+}
+
+//
+// Internal functions
+//
+
+// _addRow() : Add a game to the last block and to the index (no I/O)
+//
+static void _addRow(PHISTORY const history, uint8_t level, uint8_t outcome, uint32_t time, uint16_t bbbv, uint16_t date){
+    PHISTORY_BLOCK block = &history->last;
+
+    // A new block ?
+    if (!history->blocks || HISTORY_BLOCK_ROWS == block->count){
+        memset(block, 0, sizeof(HISTORY_BLOCK));
+        history->blocks++;
+    }
+
+    block->games[block->count] = (uint8_t)((outcome << GAME_OUTCOME_SHIFT) | (level & GAME_LEVEL_MASK));
+    block->time[block->count] = time;
+    block->bbbv[block->count] = bbbv;
+    block->date[block->count] = date;
+    block->count++;
+
+    _index(history, level, outcome, time, bbbv);
+}
+
+// _index() : Add a game to the summary of its level
+//
+//  @return : FALSE on memory error
+//
+static BOOL _index(PHISTORY const history, uint8_t level, uint8_t outcome, uint32_t time, uint16_t bbbv){
+    PHISTORY_LEVEL summary;
+    PHISTORY_WIN wins;
+    uint16_t low, high, mid;
+
+    if (level >= HISTORY_LEVELS){
+        return FALSE;
+    }
+
+    summary = &history->levels[level];
+    summary->played++;
+    if (HISTORY_WON != outcome){
+        return TRUE;
+    }
+
+    if (summary->won == summary->size){
+        if (!(wins = (PHISTORY_WIN)realloc(summary->wins, (summary->size + WINS_GROWTH) * sizeof(HISTORY_WIN)))){
+            return FALSE;
+        }
+
+        summary->wins = wins;
+        summary->size += WINS_GROWTH;
+    }
+
+    // Keep the wins sorted (after the games with the same time)
+    for (low = 0, high = summary->won; low < high; ){
+        mid = (low + high) / 2;
+        if (summary->wins[mid].time <= time){
+            low = mid + 1;
+        }
+        else{
+            high = mid;
+        }
+    }
+
+    memmove(&summary->wins[low + 1], &summary->wins[low], (summary->won - low) * sizeof(HISTORY_WIN));
+    summary->wins[low].time = time;
+    summary->wins[low].bbbv = bbbv;
+    summary->won++;
+    return TRUE;
+}
+
+// _writeLast() : Write the last block in the file
+//
+//  The first block is written with the header
+//
+static BOOL _writeLast(PHISTORY const history){
+    uint8_t buffer[HISTORY_HEADER_SIZE + HISTORY_BLOCK_SIZE];
+    uint8_t* data = buffer;
+    off_t offset = HISTORY_HEADER_SIZE + (off_t)(history->blocks - 1) * HISTORY_BLOCK_SIZE;
+    size_t size = HISTORY_BLOCK_SIZE;
+    BOOL done;
+    int fd;
+
+    if (1 == history->blocks){
+        memset(buffer, 0, HISTORY_HEADER_SIZE);
+        memcpy(buffer, HEADER_MAGIC, 3);
+        buffer[3] = HISTORY_VERSION;
+        buffer[4] = HISTORY_BLOCK_ROWS;
+        offset = 0;
+        size += HISTORY_HEADER_SIZE;
+    }
+    else{
+        data += HISTORY_HEADER_SIZE;
+    }
+
+    _encode(&history->last, buffer + HISTORY_HEADER_SIZE);
+
+    if (-1 == (fd = open(HISTORY_FILE, O_WRONLY | O_CREAT, 0644))){
+        return FALSE;
+    }
+
+    done = (offset == lseek(fd, offset, SEEK_SET) &&
+            (ssize_t)size == write(fd, data, size));
+    close(fd);
+
+    return done;
+}
+
+// _encode() : Columns of a block
+//
+static void _encode(const HISTORY_BLOCK* block, uint8_t* dest){
+    uint8_t row;
+
+    memcpy(dest + COL_GAMES, block->games, HISTORY_BLOCK_ROWS);
+    for (row = 0; row < HISTORY_BLOCK_ROWS; row++){
+        dest[COL_TIME + 4 * row] = (uint8_t)block->time[row];
+        dest[COL_TIME + 4 * row + 1] = (uint8_t)(block->time[row] >> 8);
+        dest[COL_TIME + 4 * row + 2] = (uint8_t)(block->time[row] >> 16);
+        dest[COL_TIME + 4 * row + 3] = (uint8_t)(block->time[row] >> 24);
+        dest[COL_BBBV + 2 * row] = (uint8_t)block->bbbv[row];
+        dest[COL_BBBV + 2 * row + 1] = (uint8_t)(block->bbbv[row] >> 8);
+        dest[COL_DATE + 2 * row] = (uint8_t)block->date[row];
+        dest[COL_DATE + 2 * row + 1] = (uint8_t)(block->date[row] >> 8);
+    }
+
+    dest[COL_COUNT] = block->count;     // Last written byte
+}
+
+// _decode() : Read the columns of a block
+//
+//  @return : FALSE if the block is not valid
+//
+static BOOL _decode(const uint8_t* data, PHISTORY_BLOCK block){
+    uint8_t row;
+
+    if (!(block->count = data[COL_COUNT]) || block->count > HISTORY_BLOCK_ROWS){
+        return FALSE;
+    }
+
+    memcpy(block->games, data + COL_GAMES, HISTORY_BLOCK_ROWS);
+    for (row = 0; row < HISTORY_BLOCK_ROWS; row++){
+        block->time[row] = data[COL_TIME + 4 * row] | (data[COL_TIME + 4 * row + 1] << 8) |
+                            ((uint32_t)data[COL_TIME + 4 * row + 2] << 16) |
+                            ((uint32_t)data[COL_TIME + 4 * row + 3] << 24);
+        block->bbbv[row] = data[COL_BBBV + 2 * row] | (data[COL_BBBV + 2 * row + 1] << 8);
+        block->date[row] = data[COL_DATE + 2 * row] | (data[COL_DATE + 2 * row + 1] << 8);
+    }
+
+    return TRUE;
+}
+
+// _today() : Current date
+//
+static uint16_t _today(){
+#ifdef DEST_CASIO_CALC
+    rtc_time_t now;
+    rtc_get_time(&now);
+    return (uint16_t)(((now.year - 2000) << 9) | ((now.month + 1) << 5) | now.month_day);  // month in 0..11
+#else
+    time_t now = time(NULL);
+    struct tm* date = localtime(&now);
+    return (uint16_t)(((date->tm_year - 100) << 9) | ((date->tm_mon + 1) << 5) | date->tm_mday);
+#endif // #ifdef DEST_CASIO_CALC
+}
+
+// EOF
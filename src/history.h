@@ -0,0 +1,170 @@
+//----------------------------------------------------------------------
+//--
+//--    history.h
+//--
+//--            History of all the finished games
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_HISTORY_h__
+#define __GEE_MINES_HISTORY_h__    1
+
+#include "shared/casioCalcs.h"
+#include "grid.h"
+#include "scores.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// Every finished game is kept in the history file. The file is a header
+// followed by blocks of HISTORY_BLOCK_ROWS games stored by columns :
+//
+//  games : (outcome << 2) | level, 1 byte per game
+//  time : duration in ms, 4 bytes per game
+//  bbbv : 3BV of the grid, 2 bytes per game
+//  date : ((year - 2000) << 9) | (month << 5) | day, 2 bytes per game
+//  count : # of games in the block (last byte, written last)
+//
+// Values are little endian. A new game only rewrites the last block.
+//
+// The file is read once : the summary index (played and won games, won
+// games sorted by time for each level) answers the queries without
+// any file access.
+//
+
+#ifdef DEST_CASIO_CALC
+#define HISTORY_FILE            "_geeMines.his"
+#else
+#define HISTORY_FILE            "/home/jhb/bidon/geeMines.his"
+#endif // #ifdef DEST_CASIO_CALC
+
+#define HISTORY_VERSION         1
+#define HISTORY_HEADER_SIZE     8
+#define HISTORY_BLOCK_ROWS      64
+#define HISTORY_BLOCK_SIZE      (HISTORY_BLOCK_ROWS * (1 + 4 + 2 + 2) + 1)
+
+// Outcomes (same values as replays)
+//
+#define HISTORY_WON             1
+#define HISTORY_LOST            2
+
+#define HISTORY_LEVELS          3
+#define HISTORY_NO_TIME         0xFFFFFFFF
+
+// A won game
+//
+typedef struct __historyWin{
+    uint32_t time;          // in ms
+    uint16_t bbbv;
+} HISTORY_WIN, * PHISTORY_WIN;
+
+// Summary of a level
+//
+typedef struct __historyLevel{
+    uint16_t played;
+    uint16_t won;
+    uint16_t size;          // Allocated items in wins
+    PHISTORY_WIN wins;      // Won games sorted by time
+} HISTORY_LEVEL, * PHISTORY_LEVEL;
+
+// Games of a block (columns)
+//
+typedef struct __historyBlock{
+    uint8_t count;
+    uint8_t games[HISTORY_BLOCK_ROWS];
+    uint32_t time[HISTORY_BLOCK_ROWS];
+    uint16_t bbbv[HISTORY_BLOCK_ROWS];
+    uint16_t date[HISTORY_BLOCK_ROWS];
+} HISTORY_BLOCK, * PHISTORY_BLOCK;
+
+// The history
+//
+typedef struct __history{
+    HISTORY_LEVEL levels[HISTORY_LEVELS];
+    uint16_t blocks;        // # of blocks in the file
+    HISTORY_BLOCK last;     // Last block of the file
+} HISTORY, * PHISTORY;
+
+//  history_create() : Create an empty history
+//
+//  @return : pointer to the history or NULL
+//
+PHISTORY history_create();
+
+//  history_load() : Read the history file and build the index
+//
+//  @history : Pointer to the history
+//
+//  @return : TRUE if the file has been read
+//
+BOOL history_load(PHISTORY const history);
+
+//  history_import() : Add the best scores to an empty history
+//
+//  Used once when the history file doesn't exist yet : the best scores
+//  are kept as won games of unknown date
+//
+//  @history : Pointer to the history
+//  @scores : Array of scores
+//
+//  @return : TRUE if done
+//
+BOOL history_import(PHISTORY const history, PSCORE const scores);
+
+//  history_add() : Add a finished game
+//
+//  @history : Pointer to the history
+//  @level : Level of the game
+//  @outcome : HISTORY_WON or HISTORY_LOST
+//  @time : Duration in ms
+//  @bbbv : 3BV of the grid
+//
+//  @return : TRUE if the game has been written
+//
+BOOL history_add(PHISTORY const history, uint8_t level, uint8_t outcome, uint32_t time, uint16_t bbbv);
+
+//  history_best() : Get one of the best games of a level
+//
+//  @history : Pointer to the history
+//  @level : Level of the games
+//  @rank : Rank of the game (0 for the best one)
+//
+//  @return : pointer to the game or NULL
+//
+const HISTORY_WIN* history_best(const HISTORY* history, uint8_t level, uint16_t rank);
+
+//  history_percentile() : Time of the won games at a given percentile
+//
+//  @history : Pointer to the history
+//  @level : Level of the games
+//  @permille : Percentile in 1/1000 (500 for the median)
+//
+//  @return : time in ms or HISTORY_NO_TIME if no game has been won
+//
+uint32_t history_percentile(const HISTORY* history, uint8_t level, uint16_t permille);
+#define history_median(history, level) history_percentile(history, level, 500)
+
+//  history_winRate() : Win rate of a level
+//
+//  @history : Pointer to the history
+//  @level : Level of the games
+//
+//  @return : win rate in 1/1000
+//
+uint16_t history_winRate(const HISTORY* history, uint8_t level);
+
+//  history_free() : Free a history
+//
+//  @history : Pointer to the history
+//
+void history_free(PHISTORY const history);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_HISTORY_h__
+
+// EOF
@@ -0,0 +1,227 @@
+//----------------------------------------------------------------------
+//--
+//--    journal.c
+//--
+//--            Undo / redo journal of the changes of a grid
+//--
+//----------------------------------------------------------------------
+
+#include "journal.h"
+
+#include <string.h>
+
+// Words
+//
+#define WORD_DELTA          0x8000
+#define WORD_INDEX_MASK     0x01FF
+#define WORD_STATE_SHIFT    9
+#define WORD_STATE_MASK     0x1F
+#define WORD_STEPS_MASK     0x03FF
+#define WORD_MINES_SHIFT    10
+
+#define WORD_AT(journal, id)    ((journal)->words[((journal)->bottom + (id)) % JOURNAL_SIZE])
+
+static void _push(PJOURNAL const journal, JOURNAL_WORD word);
+static BOOL _dropOldest(PJOURNAL const journal);
+static void _swap(PJOURNAL const journal, uint16_t id, PGRID const grid, JOURNAL_CB onChange, void* param);
+
+//  journal_create() : Create an empty journal
+//
+//  @return : pointer to the journal or NULL
+//
+PJOURNAL journal_create(){
+    PJOURNAL journal = (PJOURNAL)malloc(sizeof(JOURNAL));
+    if (journal){
+        memset(journal, 0, sizeof(JOURNAL));
+    }
+    return journal;
+}
+
+//  journal_clear() : Remove all the actions
+//
+//  @journal : Pointer to the journal
+//
+void journal_clear(PJOURNAL const journal){
+    if (journal){
+        journal->bottom = journal->top = journal->end = journal->start = 0;
+        journal->lost = FALSE;
+    }
+}
+
+//  journal_begin() : Start recording an action
+//
+//  Undone actions are lost as soon as the new action changes a box
+//
+//  @journal : Pointer to the journal
+//
+void journal_begin(PJOURNAL const journal){
+    if (journal){
+        journal->start = journal->top;
+        journal->lost = FALSE;
+    }
+}
+
+//  journal_add() : A box of the grid will change or has changed
+//
+//  @journal : Pointer to the journal
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @previous : State of the box before the action
+//
+void journal_add(PJOURNAL const journal, PGRID const grid, PCOORD const pos, BOX_STATE previous){
+    if (journal){
+        _push(journal, (JOURNAL_WORD)(((previous & WORD_STATE_MASK) << WORD_STATE_SHIFT) |
+                        ((pos->row * grid->size.col + pos->col) & WORD_INDEX_MASK)));
+    }
+}
+
+//  journal_end() : End of the current action
+//
+//  @journal : Pointer to the journal
+//  @minesLeft : Change of the count of mines left (-1, 0 or 1)
+//  @steps : Count of revealed boxes
+//
+void journal_end(PJOURNAL const journal, int8_t minesLeft, uint16_t steps){
+    if (!journal || journal->top == journal->start){
+        return;     // Nothing has changed
+    }
+
+    _push(journal, (JOURNAL_WORD)(WORD_DELTA | (((minesLeft + 1) & 3) << WORD_MINES_SHIFT) |
+                    (steps & WORD_STEPS_MASK)));
+    if (journal->lost){
+        journal_clear(journal);
+    }
+}
+
+//  journal_undo() : Undo the last action
+//
+//  @journal : Pointer to the journal
+//  @grid : Pointer to the grid
+//  @minesLeft, @steps : Counters to update
+//  @onChange : Function called for each restored box (can be NULL)
+//  @param : Parameter given to the function
+//
+//  @return : count of restored boxes (0 if nothing to undo)
+//
+uint16_t journal_undo(PJOURNAL const journal, PGRID const grid, int8_t* minesLeft, uint16_t* steps, JOURNAL_CB onChange, void* param){
+    JOURNAL_WORD delta;
+    uint16_t id, count = 0;
+
+    if (!journal || !journal->top){
+        return 0;
+    }
+
+    delta = WORD_AT(journal, journal->top - 1);
+    for (id = journal->top - 1; id && !(WORD_AT(journal, id - 1) & WORD_DELTA); id--, count++){
+        _swap(journal, id - 1, grid, onChange, param);
+    }
+
+    journal->top = id;
+    *minesLeft -= (int8_t)((delta >> WORD_MINES_SHIFT) & 3) - 1;
+    *steps -= (delta & WORD_STEPS_MASK);
+    return count;
+}
+
+//  journal_redo() : Redo the last undone action
+//
+//  @journal : Pointer to the journal
+//  @grid : Pointer to the grid
+//  @minesLeft, @steps : Counters to update
+//  @onChange : Function called for each changed box (can be NULL)
+//  @param : Parameter given to the function
+//
+//  @return : count of changed boxes (0 if nothing to redo)
+//
+uint16_t journal_redo(PJOURNAL const journal, PGRID const grid, int8_t* minesLeft, uint16_t* steps, JOURNAL_CB onChange, void* param){
+    JOURNAL_WORD delta;
+    uint16_t id, count = 0;
+
+    if (!journal || journal->top == journal->end){
+        return 0;
+    }
+
+    for (id = journal->top; id < journal->end && !(WORD_AT(journal, id) & WORD_DELTA); id++, count++){
+        _swap(journal, id, grid, onChange, param);
+    }
+
+    delta = WORD_AT(journal, id);
+    journal->top = id + 1;
+    *minesLeft += (int8_t)((delta >> WORD_MINES_SHIFT) & 3) - 1;
+    *steps += (delta & WORD_STEPS_MASK);
+    return count;
+}
+
+//  journal_free() : Free a journal
+//
+//  @journal : Pointer to the journal
+//
+void journal_free(PJOURNAL const journal){
+    if (journal){
+        free(journal);
+    }
+}
+
+//
+// Internal functions
+//
+
+// _push() : Add a word to the current action
+//
+static void _push(PJOURNAL const journal, JOURNAL_WORD word){
+    if (journal->lost){
+        return;
+    }
+
+    if (journal->top == JOURNAL_SIZE && !_dropOldest(journal)){
+        journal->lost = TRUE;
+        return;
+    }
+
+    WORD_AT(journal, journal->top) = word;
+    journal->end = ++journal->top;
+}
+
+// _dropOldest() : Remove the oldest action
+//
+//  @return : FALSE if the only action is the current one
+//
+static BOOL _dropOldest(PJOURNAL const journal){
+    uint16_t count;
+
+    for (count = 0; count < journal->start && !(WORD_AT(journal, count) & WORD_DELTA); count++);
+    if (count >= journal->start){
+        return FALSE;
+    }
+
+    count++;    // with its delta word
+    journal->bottom = (journal->bottom + count) % JOURNAL_SIZE;
+    journal->top -= count;
+    journal->end -= count;
+    journal->start -= count;
+    return TRUE;
+}
+
+// _swap() : Swap the state of a box with the state in the journal
+//
+static void _swap(PJOURNAL const journal, uint16_t id, PGRID const grid, JOURNAL_CB onChange, void* param){
+    JOURNAL_WORD* word = &WORD_AT(journal, id);
+    uint16_t index = *word & WORD_INDEX_MASK;
+    BOX_STATE current;
+    COORD pos;
+
+    if (index >= grid->size.col * grid->size.row){
+        return;
+    }
+
+    current = grid->boxes[index].state;
+    grid->boxes[index].state = (*word >> WORD_STATE_SHIFT) & WORD_STATE_MASK;
+    *word = (JOURNAL_WORD)((current << WORD_STATE_SHIFT) | index);
+
+    if (onChange){
+        pos.col = index % grid->size.col;
+        pos.row = index / grid->size.col;
+        onChange(grid, &pos, current, param);
+    }
+}
+
+// EOF
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------
+//--
+//--    journal.h
+//--
+//--            Undo / redo journal of the changes of a grid
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_JOURNAL_h__
+#define __GEE_MINES_JOURNAL_h__    1
+
+#include "shared/casioCalcs.h"
+#include "grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// The journal is a ring buffer of 16 bits words. An action of the player
+// is a list of entries (one per changed box : index and previous state)
+// followed by a "delta" word with the changes of minesLeft and steps.
+//
+//  entry : 0 | state (5 bits) | box index (9 bits)
+//  delta : 1 | minesLeft change + 1 (2 bits) | steps change (10 bits)
+//
+// Undo and redo swap the state stored in each entry with the state of the
+// box : the cost is the size of the action and the same entries are used
+// in both directions. Undone actions stay above the top of the journal
+// until a new action is recorded.
+//
+// When the buffer is full the oldest actions are dropped. An action that
+// doesn't fit in the whole buffer can't be undone : the journal is cleared.
+//
+
+#define JOURNAL_SIZE        1024    // Count of words
+
+typedef uint16_t JOURNAL_WORD;
+
+// Called for each box changed by an undo or a redo
+//
+typedef GRID_REVEAL_CB JOURNAL_CB;
+
+typedef struct __journal{
+    uint16_t bottom;        // Index of the oldest word
+    uint16_t top;           // # of words of the done actions
+    uint16_t end;           // # of words including the undone actions
+    uint16_t start;         // First word of the current action
+    BOOL lost;              // Current action is too large
+    JOURNAL_WORD words[JOURNAL_SIZE];
+} JOURNAL, * PJOURNAL;
+
+//  journal_create() : Create an empty journal
+//
+//  @return : pointer to the journal or NULL
+//
+PJOURNAL journal_create();
+
+//  journal_clear() : Remove all the actions
+//
+//  @journal : Pointer to the journal
+//
+void journal_clear(PJOURNAL const journal);
+
+//  journal_begin() : Start recording an action
+//
+//  Undone actions are lost as soon as the new action changes a box
+//
+//  @journal : Pointer to the journal
+//
+void journal_begin(PJOURNAL const journal);
+
+//  journal_add() : A box of the grid will change or has changed
+//
+//  @journal : Pointer to the journal
+//  @grid : Pointer to the grid
+//  @pos : Position of the box
+//  @previous : State of the box before the action
+//
+void journal_add(PJOURNAL const journal, PGRID const grid, PCOORD const pos, BOX_STATE previous);
+
+//  journal_end() : End of the current action
+//
+//  @journal : Pointer to the journal
+//  @minesLeft : Change of the count of mines left (-1, 0 or 1)
+//  @steps : Count of revealed boxes
+//
+void journal_end(PJOURNAL const journal, int8_t minesLeft, uint16_t steps);
+
+//  journal_undo() : Undo the last action
+//
+//  @journal : Pointer to the journal
+//  @grid : Pointer to the grid
+//  @minesLeft, @steps : Counters to update
+//  @onChange : Function called for each restored box (can be NULL)
+//  @param : Parameter given to the function
+//
+//  @return : count of restored boxes (0 if nothing to undo)
+//
+uint16_t journal_undo(PJOURNAL const journal, PGRID const grid, int8_t* minesLeft, uint16_t* steps, JOURNAL_CB onChange, void* param);
+
+//  journal_redo() : Redo the last undone action
+//
+//  @journal : Pointer to the journal
+//  @grid : Pointer to the grid
+//  @minesLeft, @steps : Counters to update
+//  @onChange : Function called for each changed box (can be NULL)
+//  @param : Parameter given to the function
+//
+//  @return : count of changed boxes (0 if nothing to redo)
+//
+uint16_t journal_redo(PJOURNAL const journal, PGRID const grid, int8_t* minesLeft, uint16_t* steps, JOURNAL_CB onChange, void* param);
+
+//  journal_free() : Free a journal
+//
+//  @journal : Pointer to the journal
+//
+void journal_free(PJOURNAL const journal);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_JOURNAL_h__
+
+// EOF
@@ -0,0 +1,202 @@
+//----------------------------------------------------------------------
+//--
+//--    mask.c
+//--
+//--            Mines of a grid as a bitmask - symmetries and hashes
+//--
+//----------------------------------------------------------------------
+
+#include "mask.h"
+
+#include <string.h>
+
+static uint32_t _reverse(uint32_t value);
+static void _transpose(uint32_t* lines);
+static uint64_t _mix(uint64_t value);
+
+//  mask_fromGrid() : Mines of a grid
+//
+//  @grid : Pointer to the grid
+//  @mask : Pointer to the mask
+//
+//  @return : TRUE if done
+//
+BOOL mask_fromGrid(PGRID const grid, PMASK mask){
+    uint8_t r, c;
+    PBOX box;
+
+    if (!grid || !grid->boxes || !mask ||
+        grid->size.col > MASK_MAX_SIZE || grid->size.row > MASK_MAX_SIZE){
+        return FALSE;
+    }
+
+    memset(mask, 0, sizeof(MASK));
+    mask->cols = grid->size.col;
+    mask->rows = grid->size.row;
+    for (r = 0, box = grid->boxes; r < mask->rows; r++){
+        for (c = 0; c < mask->cols; c++, box++){
+            if (box->mine){
+                mask->lines[r] |= (1u << c);
+            }
+        }
+    }
+
+    return TRUE;
+}
+
+//  mask_pack() : Pack a mask
+//
+//  @mask : Pointer to the mask
+//  @buffer : Destination buffer (mask_packedSize() bytes)
+//
+void mask_pack(const MASK* mask, uint8_t* buffer){
+    uint16_t bit = 0;
+    uint8_t r, c;
+
+    memset(buffer, 0, mask_packedSize(mask->cols, mask->rows));
+    for (r = 0; r < mask->rows; r++){
+        for (c = 0; c < mask->cols; c++, bit++){
+            if (mask->lines[r] & (1u << c)){
+                buffer[bit >> 3] |= (uint8_t)(1 << (bit & 7));
+            }
+        }
+    }
+}
+
+//  mask_unpack() : Unpack a mask
+//
+//  @mask : Pointer to the mask, its dimensions must be set
+//  @buffer : Packed mask
+//
+void mask_unpack(PMASK mask, const uint8_t* buffer){
+    uint16_t bit = 0;
+    uint8_t r, c;
+
+    memset(mask->lines, 0, sizeof(mask->lines));
+    for (r = 0; r < mask->rows; r++){
+        for (c = 0; c < mask->cols; c++, bit++){
+            if (buffer[bit >> 3] & (1 << (bit & 7))){
+                mask->lines[r] |= (1u << c);
+            }
+        }
+    }
+}
+
+//  mask_transform() : Apply a symmetry to a mask
+//
+//  @src : Pointer to the mask
+//  @symmetry : Combination of MASK_FLIP_H, MASK_FLIP_V and MASK_TRANSPOSE
+//  @dest : Pointer to the transformed mask (can't be src)
+//
+//  @return : FALSE if the symmetry is invalid (transposition of a
+//              non-square mask)
+//
+BOOL mask_transform(const MASK* src, uint8_t symmetry, PMASK dest){
+    uint32_t lines[MASK_MAX_SIZE];
+    const uint32_t* from = src->lines;
+    uint8_t r;
+
+    if (symmetry >= MASK_SYMMETRIES ||
+        ((symmetry & MASK_TRANSPOSE) && src->cols != src->rows)){
+        return FALSE;
+    }
+
+    if (symmetry & MASK_TRANSPOSE){
+        memcpy(lines, src->lines, sizeof(lines));
+        _transpose(lines);
+        from = lines;
+    }
+
+    memset(dest, 0, sizeof(MASK));
+    dest->cols = src->cols;
+    dest->rows = src->rows;
+    for (r = 0; r < src->rows; r++){
+        dest->lines[(symmetry & MASK_FLIP_V)?(src->rows - 1 - r):r] =
+            (symmetry & MASK_FLIP_H)?(_reverse(from[r]) >> (32 - src->cols)):from[r];
+    }
+
+    return TRUE;
+}
+
+//  mask_canonical() : Canonical form of a mask
+//
+//  @mask : Pointer to the mask
+//  @canonical : Pointer to the canonical form (can't be mask)
+//
+//  @return : symmetry that gives the canonical form
+//
+uint8_t mask_canonical(const MASK* mask, PMASK canonical){
+    uint8_t symmetry, best = 0, count;
+    size_t size = mask->rows * sizeof(uint32_t);
+    MASK current;
+
+    memcpy(canonical, mask, sizeof(MASK));
+    count = (mask->cols == mask->rows)?MASK_SYMMETRIES:MASK_TRANSPOSE;
+    for (symmetry = 1; symmetry < count; symmetry++){
+        mask_transform(mask, symmetry, &current);
+        if (memcmp(current.lines, canonical->lines, size) < 0){
+            memcpy(canonical, &current, sizeof(MASK));
+            best = symmetry;
+        }
+    }
+
+    return best;
+}
+
+//  mask_hash() : 64 bits hash of a mask
+//
+//  Apply the hash to the canonical form to identify symmetric grids
+//
+//  @mask : Pointer to the mask
+//
+//  @return : hash value
+//
+uint64_t mask_hash(const MASK* mask){
+    uint64_t hash = _mix(((uint64_t)mask->cols << 8) | mask->rows);
+    for (uint8_t r = 0; r < mask->rows; r++){
+        hash = _mix(hash ^ mask->lines[r]);
+    }
+
+    return hash;
+}
+
+//
+// Internal functions
+//
+
+// _reverse() : Reverse the bits of a word
+//
+static uint32_t _reverse(uint32_t value){
+    value = ((value >> 1) & 0x55555555u) | ((value & 0x55555555u) << 1);
+    value = ((value >> 2) & 0x33333333u) | ((value & 0x33333333u) << 2);
+    value = ((value >> 4) & 0x0F0F0F0Fu) | ((value & 0x0F0F0F0Fu) << 4);
+    value = ((value >> 8) & 0x00FF00FFu) | ((value & 0x00FF00FFu) << 8);
+    return (value >> 16) | (value << 16);
+}
+
+// _transpose() : Transpose a 32 x 32 bits matrix
+//
+//  Blocks of 16, 8, 4, 2 then 1 bits are swapped across the diagonal
+//
+static void _transpose(uint32_t* lines){
+    uint32_t mask = 0x0000FFFFu, swap;
+    uint8_t size, k;
+
+    for (size = 16; size; size >>= 1, mask ^= (mask << size)){
+        for (k = 0; k < MASK_MAX_SIZE; k = (k + size + 1) & ~size){
+            swap = ((lines[k] >> size) ^ lines[k + size]) & mask;
+            lines[k] ^= (swap << size);
+            lines[k + size] ^= swap;
+        }
+    }
+}
+
+// _mix() : 64 bits finalizer (splitmix64)
+//
+static uint64_t _mix(uint64_t value){
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// EOF
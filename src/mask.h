@@ -0,0 +1,117 @@
+//----------------------------------------------------------------------
+//--
+//--    mask.h
+//--
+//--            Mines of a grid as a bitmask - symmetries and hashes
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_MASK_h__
+#define __GEE_MINES_MASK_h__    1
+
+#include "grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// A mask only keeps the positions of the mines : one 32 bits word per
+// row, bit c of a row is set if there is a mine in column c.
+//
+// Symmetries are computed on the words : a horizontal flip reverses the
+// bits of each row, a vertical flip reverses the order of the rows and a
+// transposition (square grids only) swaps rows and columns. A square
+// grid has 8 symmetries, other grids only have 4.
+//
+// The canonical form of a mask is the smallest of its symmetries. Two
+// grids that are equal up to a symmetry have the same canonical form
+// and the same hash.
+//
+// Packed form (files) : cols * rows bits, row by row, LSB first.
+//
+
+#define MASK_MAX_SIZE       32      // Max. count of rows and cols
+
+// Symmetries (bits can be combined)
+//
+#define MASK_FLIP_H         1
+#define MASK_FLIP_V         2
+#define MASK_TRANSPOSE      4       // Applied first, square masks only
+
+#define MASK_SYMMETRIES     8
+
+typedef struct __mask{
+    uint8_t cols;
+    uint8_t rows;
+    uint32_t lines[MASK_MAX_SIZE];  // Unused bits and rows are 0
+} MASK, * PMASK;
+
+//  mask_fromGrid() : Mines of a grid
+//
+//  @grid : Pointer to the grid
+//  @mask : Pointer to the mask
+//
+//  @return : TRUE if done
+//
+BOOL mask_fromGrid(PGRID const grid, PMASK mask);
+
+//  mask_packedSize() : Size of a packed mask
+//
+//  @cols, @rows : Dimensions of the mask
+//
+//  @return : size in bytes
+//
+#define mask_packedSize(cols, rows) (((uint16_t)(cols) * (rows) + 7) / 8)
+
+//  mask_pack() : Pack a mask
+//
+//  @mask : Pointer to the mask
+//  @buffer : Destination buffer (mask_packedSize() bytes)
+//
+void mask_pack(const MASK* mask, uint8_t* buffer);
+
+//  mask_unpack() : Unpack a mask
+//
+//  @mask : Pointer to the mask, its dimensions must be set
+//  @buffer : Packed mask
+//
+void mask_unpack(PMASK mask, const uint8_t* buffer);
+
+//  mask_transform() : Apply a symmetry to a mask
+//
+//  @src : Pointer to the mask
+//  @symmetry : Combination of MASK_FLIP_H, MASK_FLIP_V and MASK_TRANSPOSE
+//  @dest : Pointer to the transformed mask (can't be src)
+//
+//  @return : FALSE if the symmetry is invalid (transposition of a
+//              non-square mask)
+//
+BOOL mask_transform(const MASK* src, uint8_t symmetry, PMASK dest);
+
+//  mask_canonical() : Canonical form of a mask
+//
+//  @mask : Pointer to the mask
+//  @canonical : Pointer to the canonical form (can't be mask)
+//
+//  @return : symmetry that gives the canonical form
+//
+uint8_t mask_canonical(const MASK* mask, PMASK canonical);
+
+//  mask_hash() : 64 bits hash of a mask
+//
+//  Apply the hash to the canonical form to identify symmetric grids
+//
+//  @mask : Pointer to the mask
+//
+//  @return : hash value
+//
+uint64_t mask_hash(const MASK* mask);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_MASK_h__
+
+// EOF
@@ -0,0 +1,240 @@
+//----------------------------------------------------------------------
+//--
+//--    minimap.c
+//--
+//--            Overview of a grid larger than the viewport
+//--
+//----------------------------------------------------------------------
+
+#include "minimap.h"
+
+#include <string.h>
+
+static uint8_t _colourID(PBOX const box);
+static void _drawBox(PMINIMAP const minimap, uint16_t id);
+static void _drawOutline(PMINIMAP const minimap);
+static void _fillRect(PMINIMAP const minimap, int16_t x, int16_t y, int16_t w, int16_t h, int colour);
+
+// Colours of the boxes (by ID)
+static const int _colours[] = {MINIMAP_COLOUR_COVERED, MINIMAP_COLOUR_REVEALED, MINIMAP_COLOUR_FLAG, MINIMAP_COLOUR_MINE};
+
+//  minimap_create() : Create an empty map
+//
+//  @return : pointer to the new map or NULL
+//
+PMINIMAP minimap_create(){
+    size_t size = sizeof(MINIMAP);
+    PMINIMAP minimap = (PMINIMAP)malloc(size);
+    if (minimap){
+        memset(minimap, 0, size);
+    }
+    return minimap;
+}
+
+//  minimap_init() : Attach the map to a new grid
+//
+//  @minimap : Pointer to the map
+//  @grid : Grid to show
+//
+void minimap_init(PMINIMAP const minimap, PGRID const grid){
+    if (minimap){
+        minimap->grid = grid;
+        minimap->pos.w = 0;     // No position yet
+        minimap_invalidate(minimap);
+    }
+}
+
+//  minimap_setArea() : Position of the map
+//
+//  The map uses the largest boxes that fit in the area. It will be drawn
+//  again
+//
+//  @minimap : Pointer to the map
+//  @area : Area where the map can be drawn (not rotated), NULL for no map
+//  @rotated : TRUE if the screen is in horizontal mode
+//
+void minimap_setArea(PMINIMAP const minimap, PRECT const area, BOOL rotated){
+    PGRID grid;
+    uint8_t size;
+
+    if (!minimap){
+        return;
+    }
+
+    minimap->pos.w = 0;
+    minimap->rotated = rotated;
+    if (area && (grid = minimap->grid) && grid->size.col && grid->size.row){
+        size = (uint8_t)MIN_VAL(MINIMAP_BOX_MAX, MIN_VAL(area->w / grid->size.col, area->h / grid->size.row));
+        if (size){
+            minimap->boxSize = size;
+            setRect(&minimap->pos, area->x,
+                area->y + (area->h - grid->size.row * size) / 2,
+                grid->size.col * size, grid->size.row * size);
+        }
+    }
+
+    minimap_invalidate(minimap);
+}
+
+//  minimap_invalidate() : The map has been erased
+//
+//  @minimap : Pointer to the map
+//
+void minimap_invalidate(PMINIMAP const minimap){
+    if (minimap){
+        minimap->erased = TRUE;
+        minimap->outlined = FALSE;
+    }
+}
+
+//  minimap_touch() : The state of a box may have changed
+//
+//  @minimap : Pointer to the map
+//  @pos : Position of the box
+//
+void minimap_touch(PMINIMAP const minimap, PCOORD const pos){
+    uint16_t id;
+
+    if (minimap && minimap->grid && !minimap->erased){
+        id = pos->row * minimap->grid->size.col + pos->col;
+        if (!(minimap->boxes[id] & MINIMAP_QUEUED)){
+            minimap->boxes[id] |= MINIMAP_QUEUED;
+            minimap->queue[minimap->queued++] = id;
+        }
+    }
+}
+
+//  minimap_draw() : Draw the changes
+//
+//  @minimap : Pointer to the map
+//  @frame : Visible part of the grid
+//
+//  @return : TRUE if something has been drawn
+//
+BOOL minimap_draw(PMINIMAP const minimap, PRECT const frame){
+    PGRID grid;
+    uint16_t id, count;
+    uint8_t colour;
+
+    if (!minimap || !(grid = minimap->grid) || !grid->boxes || !minimap->pos.w){
+        return FALSE;
+    }
+
+    if (!minimap->erased && !minimap->queued && minimap->outlined &&
+        frame->x == minimap->outline.x && frame->y == minimap->outline.y &&
+        frame->w == minimap->outline.w && frame->h == minimap->outline.h){
+        return FALSE;   // Nothing has changed
+    }
+
+    if (minimap->erased){
+        // All the boxes
+        count = grid->size.col * grid->size.row;
+        for (id = 0; id < count; id++){
+            minimap->boxes[id] = _colourID(grid->boxes + id);
+            _drawBox(minimap, id);
+        }
+        minimap->erased = FALSE;
+    }
+    else{
+        // The inverted outline is removed before the boxes are drawn
+        if (minimap->outlined){
+            _drawOutline(minimap);
+        }
+
+        for (count = 0; count < minimap->queued; count++){
+            id = minimap->queue[count];
+            colour = _colourID(grid->boxes + id);
+            if (colour != (minimap->boxes[id] & ~MINIMAP_QUEUED)){
+                minimap->boxes[id] = colour;
+                _drawBox(minimap, id);
+            }
+            else{
+                minimap->boxes[id] = colour;
+            }
+        }
+    }
+
+    minimap->queued = 0;
+
+    copyRect(&minimap->outline, frame);
+    _drawOutline(minimap);
+    minimap->outlined = TRUE;
+    return TRUE;
+}
+
+//  minimap_free() : Free a map
+//
+//  @minimap : Pointer to the map
+//
+//  @return : NULL
+//
+PMINIMAP minimap_free(PMINIMAP const minimap){
+    if (minimap){
+        free(minimap);
+    }
+
+    return NULL;
+}
+
+//
+// Internal functions
+//
+
+// _colourID() : Colour ID of a box
+//
+static uint8_t _colourID(PBOX const box){
+    switch (box->state){
+        case BS_FLAG:
+            return MINIMAP_FLAG;
+
+        case BS_BLAST:
+        case BS_MINE:
+        case BS_WRONG:
+            return MINIMAP_MINE;
+
+        default:
+            return BOX_IS_COVERED(box)?MINIMAP_COVERED:MINIMAP_REVEALED;
+    }
+}
+
+// _drawBox() : Draw a box with its colour
+//
+static void _drawBox(PMINIMAP const minimap, uint16_t id){
+    uint8_t size = minimap->boxSize;
+    _fillRect(minimap,
+        minimap->pos.x + (id % minimap->grid->size.col) * size,
+        minimap->pos.y + (id / minimap->grid->size.col) * size,
+        size, size, _colours[minimap->boxes[id]]);
+}
+
+// _drawOutline() : Invert the pixels around the visible part of the grid
+//
+//  Drawing the outline twice removes it
+//
+static void _drawOutline(PMINIMAP const minimap){
+    uint8_t size = minimap->boxSize;
+    int16_t x = minimap->pos.x + minimap->outline.x * size;
+    int16_t y = minimap->pos.y + minimap->outline.y * size;
+    int16_t w = minimap->outline.w * size;
+    int16_t h = minimap->outline.h * size;
+
+    // Each pixel is inverted once
+    _fillRect(minimap, x, y, w, 1, C_INVERT);
+    _fillRect(minimap, x, y + h - 1, w, 1, C_INVERT);
+    _fillRect(minimap, x, y + 1, 1, h - 2, C_INVERT);
+    _fillRect(minimap, x + w - 1, y + 1, 1, h - 2, C_INVERT);
+}
+
+// _fillRect() : Fill a rectangle of the map (rotated if needed)
+//
+static void _fillRect(PMINIMAP const minimap, int16_t x, int16_t y, int16_t w, int16_t h, int colour){
+    RECT rect = {x, y, w, h};
+
+    if (minimap->rotated){
+        rotateRect(&rect);
+    }
+
+    drect(rect.x, rect.y, rect.x + rect.w - 1, rect.y + rect.h - 1, colour);
+}
+
+// EOF
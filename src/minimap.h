@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------
+//--
+//--    minimap.h
+//--
+//--            Overview of a grid larger than the viewport
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_MINIMAP_h__
+#define __GEE_MINES_MINIMAP_h__    1
+
+#include "shared/casioCalcs.h"
+#include "grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// Each box of the grid is a 1 or 2 pixels square whose colour shows if
+// the box is covered, revealed, flagged or a mine. The visible part of
+// the grid is outlined with inverted pixels.
+//
+// The colour drawn for each box is kept : boxes whose state may have
+// changed are queued by minimap_touch() and only the ones whose colour
+// is not the drawn one are painted. Moving the outline costs its
+// perimeter. The whole map is only drawn after the screen has been
+// erased.
+//
+
+// Size of a box
+//
+#define MINIMAP_BOX_MAX         2       // in pixels
+
+// Colours of the boxes
+//
+#define MINIMAP_COVERED         0
+#define MINIMAP_REVEALED        1
+#define MINIMAP_FLAG            2
+#define MINIMAP_MINE            3
+#define MINIMAP_QUEUED          0x80    // Box is in the queue
+
+#define MINIMAP_COLOUR_COVERED  C_RGB(16, 16, 16)
+#define MINIMAP_COLOUR_REVEALED COLOUR_WHITE
+#define MINIMAP_COLOUR_FLAG     COLOUR_RED
+#define MINIMAP_COLOUR_MINE     COLOUR_BLACK
+
+// The map
+//
+typedef struct __minimap{
+    PGRID grid;
+    BOOL rotated;               // Horizontal orientation
+    RECT pos;                   // Position of the map (not rotated), w = 0 if no map
+    uint8_t boxSize;            // Size of a box in pixels
+    BOOL erased;                // The whole map must be drawn
+    BOOL outlined;              // The outline is on the screen
+    RECT outline;               // Boxes in the outline
+    uint8_t boxes[GRID_MAX_BOXES];  // Drawn colour (| MINIMAP_QUEUED)
+    uint16_t queued;
+    uint16_t queue[GRID_MAX_BOXES]; // Boxes that may have changed
+} MINIMAP, * PMINIMAP;
+
+//  minimap_create() : Create an empty map
+//
+//  @return : pointer to the new map or NULL
+//
+PMINIMAP minimap_create();
+
+//  minimap_init() : Attach the map to a new grid
+//
+//  @minimap : Pointer to the map
+//  @grid : Grid to show
+//
+void minimap_init(PMINIMAP const minimap, PGRID const grid);
+
+//  minimap_setArea() : Position of the map
+//
+//  The map uses the largest boxes that fit in the area. It will be drawn
+//  again
+//
+//  @minimap : Pointer to the map
+//  @area : Area where the map can be drawn (not rotated), NULL for no map
+//  @rotated : TRUE if the screen is in horizontal mode
+//
+void minimap_setArea(PMINIMAP const minimap, PRECT const area, BOOL rotated);
+
+//  minimap_invalidate() : The map has been erased
+//
+//  @minimap : Pointer to the map
+//
+void minimap_invalidate(PMINIMAP const minimap);
+
+//  minimap_touch() : The state of a box may have changed
+//
+//  @minimap : Pointer to the map
+//  @pos : Position of the box
+//
+void minimap_touch(PMINIMAP const minimap, PCOORD const pos);
+
+//  minimap_draw() : Draw the changes
+//
+//  @minimap : Pointer to the map
+//  @frame : Visible part of the grid
+//
+//  @return : TRUE if something has been drawn
+//
+BOOL minimap_draw(PMINIMAP const minimap, PRECT const frame);
+
+//  minimap_free() : Free a map
+//
+//  @minimap : Pointer to the map
+//
+//  @return : NULL
+//
+PMINIMAP minimap_free(PMINIMAP const minimap);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_MINIMAP_h__
+
+// EOF
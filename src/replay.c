@@ -0,0 +1,277 @@
+//----------------------------------------------------------------------
+//--
+//--    replay.c
+//--
+//--            Compact record of the actions of a game
+//--
+//----------------------------------------------------------------------
+
+#include "replay.h"
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+
+// Header of a replay in the file
+//
+#define HEADER_MAGIC        "GMR"
+#define MAX_VARINT          3       // Bytes of a 16 bits varint
+#define TRUNCATED           1       // Flags
+
+static uint8_t _encode(uint16_t value, uint8_t* dest);
+static BOOL _decode(const REPLAY* replay, uint16_t* offset, uint16_t* value);
+static void _dropOldest(PREPLAY const replay);
+static BOOL _readHeader(const uint8_t* header, PREPLAY const replay);
+
+//  replay_create() : Create an empty replay
+//
+//  @return : pointer to the replay or NULL
+//
+PREPLAY replay_create(){
+    PREPLAY replay = (PREPLAY)malloc(sizeof(REPLAY));
+    if (replay){
+        memset(replay, 0, sizeof(REPLAY));
+    }
+    return replay;
+}
+
+//  replay_init() : Start recording a new game
+//
+//  @replay : Pointer to the replay
+//  @grid : Grid of the game (mines must be laid)
+//
+void replay_init(PREPLAY const replay, PGRID const grid){
+    if (replay){
+        replay->seed = grid->seed;
+        replay->level = grid->level;
+        replay->result = REPLAY_CANCELLED;
+        replay->truncated = FALSE;
+        replay->time = replay->count = replay->lastTick = 0;
+        replay->head = replay->size = 0;
+    }
+}
+
+//  replay_add() : Add an action (no I/O)
+//
+//  @replay : Pointer to the replay
+//  @tick : Current time in 'ticks'
+//  @box : Index of the box
+//  @action : Action on the box
+//
+void replay_add(PREPLAY const replay, uint16_t tick, uint16_t box, uint8_t action){
+    uint8_t data[2 * MAX_VARINT], len, index;
+
+    if (!replay){
+        return;
+    }
+
+    len = _encode(tick - replay->lastTick, data);
+    len += _encode((uint16_t)((box << 2) | (action & 3)), data + len);
+
+    // Room for the new action
+    while (replay->size + len > REPLAY_BUFFER_SIZE){
+        _dropOldest(replay);
+    }
+
+    for (index = 0; index < len; index++){
+        replay->buffer[(replay->head + replay->size++) % REPLAY_BUFFER_SIZE] = data[index];
+    }
+
+    replay->count++;
+    replay->lastTick = tick;
+}
+
+//  replay_end() : End of the game
+//
+//  @replay : Pointer to the replay
+//  @result : REPLAY_WON, REPLAY_LOST or REPLAY_CANCELLED
+//  @tick : Duration of the game in 'ticks'
+//
+void replay_end(PREPLAY const replay, uint8_t result, uint16_t tick){
+    if (replay){
+        replay->result = result;
+        replay->time = tick;
+    }
+}
+
+//  replay_getAction() : Get a stored action
+//
+//  @replay : Pointer to the replay
+//  @offset : Offset of the action in the stored bytes (0 for the
+//              first action), updated to the next action
+//  @action : Pointer to the decoded action
+//
+//  @return : FALSE if there is no more action
+//
+BOOL replay_getAction(const REPLAY* replay, uint16_t* offset, PREPLAY_ACTION action){
+    uint16_t value;
+
+    if (!replay || !_decode(replay, offset, &action->delta) ||
+        !_decode(replay, offset, &value)){
+        return FALSE;
+    }
+
+    action->box = value >> 2;
+    action->action = value & 3;
+    return TRUE;
+}
+
+//  replay_save() : Append the replay to the replay file
+//
+//  @replay : Pointer to the replay
+//
+//  @return : TRUE if done
+//
+BOOL replay_save(const REPLAY* replay){
+    uint8_t header[REPLAY_HEADER_SIZE];
+    uint16_t first;
+    BOOL done;
+    int fd;
+
+    if (!replay || -1 == (fd = open(REPLAY_FILE, O_WRONLY | O_CREAT | O_APPEND, 0644))){
+        return FALSE;
+    }
+
+    memcpy(header, HEADER_MAGIC, 3);
+    header[3] = REPLAY_VERSION;
+    header[4] = replay->level;
+    header[5] = replay->result;
+    header[6] = replay->truncated?TRUNCATED:0;
+    header[7] = 0;
+    header[8] = (uint8_t)replay->seed;
+    header[9] = (uint8_t)(replay->seed >> 8);
+    header[10] = (uint8_t)(replay->seed >> 16);
+    header[11] = (uint8_t)(replay->seed >> 24);
+    header[12] = (uint8_t)replay->time;
+    header[13] = (uint8_t)(replay->time >> 8);
+    header[14] = (uint8_t)replay->count;
+    header[15] = (uint8_t)(replay->count >> 8);
+    header[16] = (uint8_t)replay->size;
+    header[17] = (uint8_t)(replay->size >> 8);
+
+    // Actions may wrap at the end of the buffer
+    first = MIN_VAL(replay->size, REPLAY_BUFFER_SIZE - replay->head);
+    done = (REPLAY_HEADER_SIZE == write(fd, header, REPLAY_HEADER_SIZE) &&
+            first == write(fd, replay->buffer + replay->head, first) &&
+            (replay->size == first ||
+                (replay->size - first) == write(fd, replay->buffer, replay->size - first)));
+    close(fd);
+
+    return done;
+}
+
+//  replay_read() : Read the next replay of a replay file
+//
+//  @fd : Open replay file
+//  @replay : Pointer to the replay
+//
+//  @return : TRUE if a replay has been read
+//
+BOOL replay_read(int fd, PREPLAY const replay){
+    uint8_t header[REPLAY_HEADER_SIZE];
+
+    return (replay && REPLAY_HEADER_SIZE == read(fd, header, REPLAY_HEADER_SIZE) &&
+            _readHeader(header, replay) &&
+            replay->size == read(fd, replay->buffer, replay->size));
+}
+
+//  replay_parse() : Read a replay from memory
+//
+//  @data : Pointer to the replay (ie. in a mapped replay file)
+//  @size : Count of bytes available
+//  @replay : Pointer to the replay
+//
+//  @return : size of the replay in bytes or 0 if invalid
+//
+size_t replay_parse(const uint8_t* data, size_t size, PREPLAY const replay){
+    if (!replay || size < REPLAY_HEADER_SIZE || !_readHeader(data, replay) ||
+        size < (size_t)REPLAY_HEADER_SIZE + replay->size){
+        return 0;
+    }
+
+    memcpy(replay->buffer, data + REPLAY_HEADER_SIZE, replay->size);
+    return REPLAY_HEADER_SIZE + replay->size;
+}
+
+//  replay_free() : Free a replay
+//
+//  @replay : Pointer to the replay
+//
+void replay_free(PREPLAY const replay){
+    if (replay){
+        free(replay);
+    }
+}
+
+//
+// Internal functions
+//
+
+// _encode() : Encode a value as a varint (7 bits per byte, LSB first)
+//
+//  @return : count of bytes
+//
+static uint8_t _encode(uint16_t value, uint8_t* dest){
+    uint8_t len = 0;
+    while (value >= 0x80){
+        dest[len++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    dest[len++] = (uint8_t)value;
+    return len;
+}
+
+// _decode() : Decode a varint from the ring buffer
+//
+static BOOL _decode(const REPLAY* replay, uint16_t* offset, uint16_t* value){
+    uint8_t byte, shift = 0;
+
+    *value = 0;
+    do{
+        if (*offset >= replay->size || shift >= 7 * MAX_VARINT){
+            return FALSE;
+        }
+
+        byte = replay->buffer[(replay->head + (*offset)++) % REPLAY_BUFFER_SIZE];
+        *value |= (uint16_t)((byte & 0x7F) << shift);
+        shift += 7;
+    } while (byte & 0x80);
+
+    return TRUE;
+}
+
+// _dropOldest() : Remove the oldest action from the ring buffer
+//
+static void _dropOldest(PREPLAY const replay){
+    REPLAY_ACTION action;
+    uint16_t offset = 0;
+
+    replay_getAction(replay, &offset, &action);
+    replay->head = (replay->head + offset) % REPLAY_BUFFER_SIZE;
+    replay->size -= offset;
+    replay->count--;
+    replay->truncated = TRUE;
+}
+
+// _readHeader() : Decode the header of a replay
+//
+static BOOL _readHeader(const uint8_t* header, PREPLAY const replay){
+    if (memcmp(header, HEADER_MAGIC, 3) || REPLAY_VERSION != header[3]){
+        return FALSE;
+    }
+
+    replay->level = header[4];
+    replay->result = header[5];
+    replay->truncated = (header[6] & TRUNCATED)?TRUE:FALSE;
+    replay->seed = header[8] | (header[9] << 8) | (header[10] << 16) | ((uint32_t)header[11] << 24);
+    replay->time = header[12] | (header[13] << 8);
+    replay->count = header[14] | (header[15] << 8);
+    replay->size = header[16] | (header[17] << 8);
+    replay->head = 0;
+    replay->lastTick = 0;
+
+    return (replay->size <= REPLAY_BUFFER_SIZE);
+}
+
+// EOF
@@ -0,0 +1,161 @@
+//----------------------------------------------------------------------
+//--
+//--    replay.h
+//--
+//--            Compact record of the actions of a game
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_REPLAY_h__
+#define __GEE_MINES_REPLAY_h__    1
+
+#include "shared/casioCalcs.h"
+#include "grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// A replay is the seed of the grid and the list of the actions of the
+// player. Each action is a (delta-time, box, action) tuple encoded as two
+// varints : the count of 'ticks' since the previous action, then
+// (box index << 2) | action. Most actions use 2 or 3 bytes.
+//
+// During the game, actions are only stored in a ring buffer : there is no
+// I/O. If the buffer is full, the oldest actions are dropped and the
+// replay is marked as truncated.
+//
+// At the end of the game the replay is appended to the replay file :
+// a header of REPLAY_HEADER_SIZE bytes (little endian values) followed by
+// the encoded actions.
+//
+
+#ifdef DEST_CASIO_CALC
+#define REPLAY_FILE             "_geeMines.rpl"
+#else
+#define REPLAY_FILE             "/home/jhb/bidon/geeMines.rpl"
+#endif // #ifdef DEST_CASIO_CALC
+
+#define REPLAY_BUFFER_SIZE      4096    // Ring buffer (bytes)
+#define REPLAY_HEADER_SIZE      18
+#define REPLAY_VERSION          1
+
+// Actions
+//
+#define REPLAY_STEP             0
+#define REPLAY_FLAG             1
+#define REPLAY_QUESTION         2
+
+// End of the game
+//
+#define REPLAY_CANCELLED        0
+#define REPLAY_WON              1
+#define REPLAY_LOST             2
+
+// An action
+//
+typedef struct __replayAction{
+    uint16_t delta;     // 'ticks' since the previous action
+    uint16_t box;       // Index of the box (row * cols + col)
+    uint8_t action;
+} REPLAY_ACTION, * PREPLAY_ACTION;
+
+// A replay
+//
+typedef struct __replay{
+    uint32_t seed;      // Seed of the grid
+    uint8_t level;
+    uint8_t result;     // REPLAY_WON, REPLAY_LOST or REPLAY_CANCELLED
+    BOOL truncated;     // Oldest actions have been dropped
+    uint16_t time;      // Duration of the game in 'ticks'
+    uint16_t count;     // # of stored actions
+    uint16_t lastTick;  // Time of the last stored action
+
+    // Ring buffer
+    uint16_t head;      // Offset of the oldest byte
+    uint16_t size;      // # of used bytes
+    uint8_t buffer[REPLAY_BUFFER_SIZE];
+} REPLAY, * PREPLAY;
+
+//  replay_create() : Create an empty replay
+//
+//  @return : pointer to the replay or NULL
+//
+PREPLAY replay_create();
+
+//  replay_init() : Start recording a new game
+//
+//  @replay : Pointer to the replay
+//  @grid : Grid of the game (mines must be laid)
+//
+void replay_init(PREPLAY const replay, PGRID const grid);
+
+//  replay_add() : Add an action (no I/O)
+//
+//  @replay : Pointer to the replay
+//  @tick : Current time in 'ticks'
+//  @box : Index of the box
+//  @action : Action on the box
+//
+void replay_add(PREPLAY const replay, uint16_t tick, uint16_t box, uint8_t action);
+
+//  replay_end() : End of the game
+//
+//  @replay : Pointer to the replay
+//  @result : REPLAY_WON, REPLAY_LOST or REPLAY_CANCELLED
+//  @tick : Duration of the game in 'ticks'
+//
+void replay_end(PREPLAY const replay, uint8_t result, uint16_t tick);
+
+//  replay_getAction() : Get a stored action
+//
+//  @replay : Pointer to the replay
+//  @offset : Offset of the action in the stored bytes (0 for the
+//              first action), updated to the next action
+//  @action : Pointer to the decoded action
+//
+//  @return : FALSE if there is no more action
+//
+BOOL replay_getAction(const REPLAY* replay, uint16_t* offset, PREPLAY_ACTION action);
+
+//  replay_save() : Append the replay to the replay file
+//
+//  @replay : Pointer to the replay
+//
+//  @return : TRUE if done
+//
+BOOL replay_save(const REPLAY* replay);
+
+//  replay_read() : Read the next replay of a replay file
+//
+//  @fd : Open replay file
+//  @replay : Pointer to the replay
+//
+//  @return : TRUE if a replay has been read
+//
+BOOL replay_read(int fd, PREPLAY const replay);
+
+//  replay_parse() : Read a replay from memory
+//
+//  @data : Pointer to the replay (ie. in a mapped replay file)
+//  @size : Count of bytes available
+//  @replay : Pointer to the replay
+//
+//  @return : size of the replay in bytes or 0 if invalid
+//
+size_t replay_parse(const uint8_t* data, size_t size, PREPLAY const replay);
+
+//  replay_free() : Free a replay
+//
+//  @replay : Pointer to the replay
+//
+void replay_free(PREPLAY const replay);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_REPLAY_h__
+
+// EOF
@@ -0,0 +1,250 @@
+//----------------------------------------------------------------------
+//--
+//--    save.c
+//--
+//--            Suspended game
+//--
+//----------------------------------------------------------------------
+
+#include "save.h"
+#include "game.h"
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+
+// Header
+//
+#define HEADER_MAGIC        "GMS"
+#define FLAG_HORIZONTAL     1
+#define FLAG_PRACTICE       2
+#define FLAG_ZOOM_SHIFT     2       // 2 bits for the zoom
+#define FLAG_ZOOM_MASK      3
+
+static BOOL _readGrid(PGRID const grid, const uint8_t* buffer, uint16_t boxes);
+static BOOL _isValid(PBOX const box);
+static uint8_t _checksum(const uint8_t* data, uint16_t size);
+
+//  save_write() : Write the current game in the save file
+//
+//  @board : Pointer to the board
+//
+//  @return : TRUE if done
+//
+BOOL save_write(PBOARD const board){
+    uint8_t buffer[SAVE_MAX_SIZE];
+    uint8_t* mines, * states;
+    uint16_t boxes, id, size;
+    uint32_t elapsed;
+    PGRID grid;
+    BOOL done;
+    int fd;
+
+    if (!board || !(grid = board->grid) || !grid->boxes){
+        return FALSE;
+    }
+
+    boxes = grid->size.col * grid->size.row;
+    size = SAVE_SIZE(boxes);
+    memset(buffer, 0, size);
+
+    memcpy(buffer, HEADER_MAGIC, 3);
+    buffer[3] = SAVE_VERSION;
+    buffer[4] = grid->level;
+    buffer[5] = ((CALC_HORIZONTAL == board->orientation)?FLAG_HORIZONTAL:0) |
+                (board->practice?FLAG_PRACTICE:0) |
+                (uint8_t)(board->zoom << FLAG_ZOOM_SHIFT);
+    buffer[6] = (uint8_t)board->viewPort.visibleFrame.x;
+    buffer[7] = (uint8_t)board->viewPort.visibleFrame.y;
+    buffer[8] = board->cursor.col;
+    buffer[9] = board->cursor.row;
+    buffer[10] = (uint8_t)grid->seed;
+    buffer[11] = (uint8_t)(grid->seed >> 8);
+    buffer[12] = (uint8_t)(grid->seed >> 16);
+    buffer[13] = (uint8_t)(grid->seed >> 24);
+    elapsed = chrono_ms(&board->chrono);
+    buffer[14] = (uint8_t)elapsed;
+    buffer[15] = (uint8_t)(elapsed >> 8);
+    buffer[16] = (uint8_t)(elapsed >> 16);
+    buffer[17] = (uint8_t)(elapsed >> 24);
+    buffer[18] = (uint8_t)board->minesLeft;
+
+    mines = buffer + SAVE_HEADER_SIZE;
+    states = mines + SAVE_MINES_SIZE(boxes);
+    for (id = 0; id < boxes; id++){
+        if (grid->boxes[id].mine){
+            mines[id >> 3] |= (uint8_t)(1 << (id & 7));
+        }
+
+        states[id >> 1] |= (uint8_t)(grid->boxes[id].state << ((id & 1) << 2));
+    }
+
+    buffer[SAVE_HEADER_SIZE - 1] = _checksum(mines, size - SAVE_HEADER_SIZE);
+
+    if (-1 == (fd = open(SAVE_FILE, O_WRONLY | O_CREAT | O_TRUNC, 0644))){
+        return FALSE;
+    }
+
+    done = (size == write(fd, buffer, size));
+    close(fd);
+
+    board->saved = done;
+    return done;
+}
+
+//  save_read() : Restore the game of the save file
+//
+//  On success the game is in STATE_SUSPENDED state. The undo journal
+//  is empty and the replay doesn't hold the actions made before the
+//  game was saved
+//
+//  @board : Pointer to the board
+//
+//  @return : TRUE if a game has been restored
+//
+BOOL save_read(PBOARD const board){
+    uint8_t buffer[SAVE_MAX_SIZE];
+    uint16_t boxes, id;
+    uint32_t elapsed;
+    PRECT frame;
+    PGRID grid;
+    PBOX box;
+    int fd, size;
+    BOOL blast = FALSE;
+
+    if (!board || !(grid = board->grid) ||
+        -1 == (fd = open(SAVE_FILE, O_RDONLY))){
+        return FALSE;
+    }
+
+    // The whole file at once
+    size = read(fd, buffer, SAVE_MAX_SIZE);
+    close(fd);
+
+    if (size < SAVE_HEADER_SIZE || memcmp(buffer, HEADER_MAGIC, 3) ||
+        SAVE_VERSION != buffer[3] || buffer[4] > LEVEL_EXPERT ||
+        !grid_init(grid, (GAME_LEVEL)buffer[4])){
+        return FALSE;
+    }
+
+    boxes = grid->size.col * grid->size.row;
+    if (size != SAVE_SIZE(boxes) ||
+        buffer[SAVE_HEADER_SIZE - 1] != _checksum(buffer + SAVE_HEADER_SIZE, size - SAVE_HEADER_SIZE) ||
+        !_readGrid(grid, buffer + SAVE_HEADER_SIZE, boxes)){
+        grid_free(grid, FALSE);     // No game
+        return FALSE;
+    }
+
+    grid->seed = buffer[10] | (buffer[11] << 8) | (buffer[12] << 16) | ((uint32_t)buffer[13] << 24);
+
+    board->orientation = (buffer[5] & FLAG_HORIZONTAL)?CALC_HORIZONTAL:CALC_VERTICAL;
+    board->zoom = (buffer[5] >> FLAG_ZOOM_SHIFT) & FLAG_ZOOM_MASK;
+    if (board->zoom >= ZOOM_COUNT){
+        board->zoom = ZOOM_16;
+    }
+    board_reset(board);
+
+    // Counters
+    board->practice = (buffer[5] & FLAG_PRACTICE)?TRUE:FALSE;
+    elapsed = buffer[14] | (buffer[15] << 8) | (buffer[16] << 16) | ((uint32_t)buffer[17] << 24);
+    chrono_reset(&board->chrono, elapsed);
+    board->time = (uint16_t)(elapsed / 1000);
+    board->minesLeft = (int8_t)buffer[18];
+    for (id = 0, box = grid->boxes; id < boxes; id++, box++){
+        if (BS_BLAST == box->state){
+            blast = TRUE;
+        }
+        else if (!BOX_IS_COVERED(box)){
+            board->steps++;
+        }
+    }
+
+    // Visible part of the grid
+    frame = &board->viewPort.visibleFrame;
+    frame->x = MIN_VAL(buffer[6], grid->size.col - frame->w);
+    frame->y = MIN_VAL(buffer[7], grid->size.row - frame->h);
+    board->cursor.col = MIN_VAL(buffer[8], grid->size.col - 1);
+    board->cursor.row = MIN_VAL(buffer[9], grid->size.row - 1);
+    board_showBox(board, &board->cursor);
+
+    // Actions before the save are lost
+    board->replay->truncated = TRUE;
+    board->replay->lastTick = (uint16_t)(elapsed / TIMER_TICK_DURATION);
+
+    board->gameState = STATE_SUSPENDED;
+    board->smileyState = blast?SMILEY_LOSE:(board->practice?SMILEY_CAUTION:SMILEY_HAPPY);
+    board->saved = TRUE;
+    return TRUE;
+}
+
+//  save_remove() : Remove the save file if any
+//
+//  @board : Pointer to the board
+//
+void save_remove(PBOARD const board){
+    if (board && board->saved){
+        unlink(SAVE_FILE);
+        board->saved = FALSE;
+    }
+}
+
+//
+// Internal functions
+//
+
+// _readGrid() : Mines and states of the boxes
+//
+//  @return : FALSE if the grid is not valid
+//
+static BOOL _readGrid(PGRID const grid, const uint8_t* buffer, uint16_t boxes){
+    const uint8_t* states = buffer + SAVE_MINES_SIZE(boxes);
+    uint16_t id, mines = 0;
+    PBOX box;
+
+    for (id = 0, box = grid->boxes; id < boxes; id++, box++){
+        if ((box->mine = (buffer[id >> 3] >> (id & 7)) & 1)){
+            mines++;
+        }
+        box->state = (BOX_STATE)((states[id >> 1] >> ((id & 1) << 2)) & 0x0F);
+    }
+
+    if (mines != grid->mines || !grid_computeRegions(grid)){
+        return FALSE;
+    }
+
+    // States must match the mines
+    for (id = 0, box = grid->boxes; id < boxes; id++, box++){
+        if (!_isValid(box)){
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+// _isValid() : Can the box be in its state during a game ?
+//
+static BOOL _isValid(PBOX const box){
+    if (box->mine){
+        return (BOX_IS_COVERED(box) || BS_BLAST == box->state);
+    }
+
+    if (BOX_IS_NUMBER(box)){
+        return (BOX_NUMBER(box) == box->around);    // BS_DOWN is a "0"
+    }
+
+    return BOX_IS_COVERED(box);
+}
+
+// _checksum() : Checksum of a block of bytes
+//
+static uint8_t _checksum(const uint8_t* data, uint16_t size){
+    uint8_t sum = 0;
+    while (size--){
+        sum = (uint8_t)(sum * 31 + *data++);
+    }
+    return sum;
+}
+
+// EOF
@@ -0,0 +1,80 @@
+//----------------------------------------------------------------------
+//--
+//--    save.h
+//--
+//--            Suspended game
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_SAVE_h__
+#define __GEE_MINES_SAVE_h__    1
+
+#include "shared/casioCalcs.h"
+#include "board.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// When the player leaves a game, the board is written in the save file
+// and restored when the application starts. Storage access is slow on the
+// calculator : the file is written and read in a single call and it
+// only holds what can't be computed again.
+//
+//  header : SAVE_HEADER_SIZE bytes (little endian values), the last one
+//              is a checksum of the mines and states
+//  mines : 1 bit per box (row by row)
+//  states : 1 nibble per box (BOX_STATE), low nibble first
+//
+// The count of revealed boxes and the smiley are computed from the
+// states. An expert game uses 320 bytes.
+//
+
+#ifdef DEST_CASIO_CALC
+#define SAVE_FILE               "_geeMines.sav"
+#else
+#define SAVE_FILE               "/home/jhb/bidon/geeMines.sav"
+#endif // #ifdef DEST_CASIO_CALC
+
+#define SAVE_HEADER_SIZE        20
+#define SAVE_VERSION            2
+
+#define SAVE_MINES_SIZE(boxes)  (((boxes) + 7) / 8)
+#define SAVE_STATES_SIZE(boxes) (((boxes) + 1) / 2)
+#define SAVE_SIZE(boxes)        (SAVE_HEADER_SIZE + SAVE_MINES_SIZE(boxes) + SAVE_STATES_SIZE(boxes))
+#define SAVE_MAX_SIZE           SAVE_SIZE(GRID_MAX_BOXES)
+
+//  save_write() : Write the current game in the save file
+//
+//  @board : Pointer to the board
+//
+//  @return : TRUE if done
+//
+BOOL save_write(PBOARD const board);
+
+//  save_read() : Restore the game of the save file
+//
+//  On success the game is in STATE_SUSPENDED state. The undo journal
+//  is empty and the replay doesn't hold the actions made before the
+//  game was saved
+//
+//  @board : Pointer to the board
+//
+//  @return : TRUE if a game has been restored
+//
+BOOL save_read(PBOARD const board);
+
+//  save_remove() : Remove the save file if any
+//
+//  @board : Pointer to the board
+//
+void save_remove(PBOARD const board);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_SAVE_h__
+
+// EOF
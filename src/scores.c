@@ -19,51 +19,164 @@
 #include <stdio.h>
 #endif // #ifdef DEST_CASIO_CALC
 
+// Previous formats of the .top file (times in dsec)
+//
+typedef struct __scoreV1{
+    uint8_t level :2;
+    uint16_t time :14;
+}SCORE_V1, * PSCORE_V1;     // v0.2.x
+
+typedef struct __scoreV2{
+    uint8_t level :2;
+    uint16_t time :14;
+    uint16_t bbbv;
+}SCORE_V2, * PSCORE_V2;
+
+// Journal
+//
+#define HEADER_MAGIC        "GT"
+#define NO_FILE             0xFF
+
+typedef struct __scoreStorage{
+    uint8_t file;           // Current journal file (or NO_FILE)
+    uint16_t generation;
+    uint8_t records;        // # of records in the current file
+    BOOL compact;           // The journal must be rewritten
+} SCORE_STORAGE;
+
+static SCORE_STORAGE _storage = {NO_FILE, 0, 0, FALSE};
+static const char* _files[2] = {SCORE_JOURNAL_0, SCORE_JOURNAL_1};
+
+static BOOL _insert(PSCORE const scores, uint8_t level, uint32_t time, uint16_t bbbv);
+static void _setDefaults(PSCORE const scores);
+static BOOL _loadPrevious(PSCORE const scores);
+static BOOL _append(uint8_t level, uint32_t time, uint16_t bbbv);
+static BOOL _compact(PSCORE const scores);
+static void _encode(uint8_t* dest, uint8_t index, uint16_t generation, uint8_t level, uint32_t time, uint16_t bbbv);
+static uint16_t _crc(const uint8_t* data, uint8_t size, uint16_t crc);
+
 //  scores_load() : Load the scores list from disk
 //
 //  @return a pointer to the scores or NULL
 //
 PSCORE scores_load(){
-    PSCORE scores = NULL;
-    int fd = open(SCORE_FILE, O_RDONLY | O_CREAT);
-    if (fd != -1){
-        size_t len = SCORE_SIZE * SCORE_COUNT;
-        scores = (PSCORE)malloc(len);
-        if (scores){
-            memset(scores, 0, len);
-            if (read(fd, (void*)scores, len) != (ssize_t)len){
-                // set default values
-                for (uint8_t id=0; id < SCORE_COUNT; id++){
-                    scores[id].level = id / SCORE_LEVEL_COUNT;
-                    scores[id].time = 500 + 1500 * scores[id].level;
-                }
-            }
-        }
-        close(fd);
+    SCORE records[2][SCORE_FILE_RECORDS];
+    uint16_t generations[2];
+    BOOL damaged[2];
+    int counts[2], id;
+    uint8_t file;
+    PSCORE scores = (PSCORE)malloc(SCORE_SIZE * SCORE_COUNT);
+
+    if (!scores){
+        return NULL;
+    }
+
+    _setDefaults(scores);
+    _storage.file = NO_FILE;
+    _storage.records = 0;
+    _storage.compact = FALSE;
+
+    // The most recent valid journal
+    for (file = 0; file < 2; file++){
+        counts[file] = scores_readFile(_files[file], records[file], &generations[file], &damaged[file]);
     }
 
+    if (counts[0] >= 0 && (counts[1] < 0 || (int16_t)(generations[0] - generations[1]) > 0)){
+        file = 0;
+    }
+    else{
+        file = (counts[1] >= 0)?1:NO_FILE;
+    }
+
+    if (NO_FILE == file){
+        // Scores of a previous version ?
+        _storage.compact = _loadPrevious(scores);
+        return scores;
+    }
+
+    for (id = 0; id < counts[file]; id++){
+        _insert(scores, records[file][id].level, records[file][id].time, records[file][id].bbbv);
+    }
+
+    _storage.file = file;
+    _storage.generation = generations[file];
+    _storage.records = (uint8_t)counts[file];
+    _storage.compact = damaged[file];   // Don't append after invalid bytes
     return scores;
 }
 
 //  scores_save() : Save the scores list to the disk
 //
+//  New scores are already in the journal : the file is only written
+//  if it must be compacted
+//
 //  @scores : Pointer to the scores list
 //
 //  @return TRUE if done
 //
 BOOL scores_save(PSCORE const scores){
-    if (scores){
-        int fd = open(SCORE_FILE, O_WRONLY | O_CREAT);
-        if (fd != -1){
-            size_t len = SCORE_SIZE * SCORE_COUNT;
-            size_t ct = write(fd, scores, len);
-            close(fd);
+    if (!scores){
+        return FALSE;
+    }
+
+    return (_storage.compact?_compact(scores):TRUE);
+}
 
-            return (ct == len);
+//  scores_readFile() : Read the valid records of a score journal
+//
+//  @file : Name of the file
+//  @records : Buffer of SCORE_FILE_RECORDS scores
+//  @generation : Pointer to the generation of the file
+//  @damaged : Pointer set to TRUE if the end of the file is not valid
+//
+//  @return : count of records or -1 if the file is not valid
+//
+int scores_readFile(const char* file, PSCORE records, uint16_t* generation, BOOL* damaged){
+    uint8_t buffer[SCORE_HEADER_SIZE + SCORE_FILE_RECORDS * SCORE_RECORD_SIZE + 1];
+    uint8_t* record;
+    ssize_t size;
+    int count = 0, fd;
+
+    *damaged = FALSE;
+    if (-1 == (fd = open(file, O_RDONLY))){
+        return -1;
+    }
+
+    // The whole file at once
+    size = read(fd, buffer, sizeof(buffer));
+    close(fd);
+
+    if (size < SCORE_HEADER_SIZE || memcmp(buffer, HEADER_MAGIC, 2) ||
+        !buffer[2] || buffer[2] > SCORE_JOURNAL_VERSION ||
+        (buffer[6] | (buffer[7] << 8)) != _crc(buffer, 6, 0xFFFF)){
+        return -1;
+    }
+
+    *generation = buffer[4] | (buffer[5] << 8);
+    for (record = buffer + SCORE_HEADER_SIZE;
+        count < SCORE_FILE_RECORDS && record + SCORE_RECORD_SIZE <= buffer + size;
+        record += SCORE_RECORD_SIZE, count++){
+        if (record[1] != (uint8_t)count || (record[0] & 3) > LEVEL_EXPERT ||
+            (record[6] | (record[7] << 8)) != _crc(record, 6, *generation)){
+            break;  // Torn write
+        }
+
+        records[count].level = record[0] & 3;
+        records[count].time = record[2] | (record[3] << 8) | ((uint32_t)(record[0] >> 2) << 16);
+        records[count].bbbv = record[4] | (record[5] << 8);
+        if (1 == buffer[2]){
+            records[count].time *= 100;     // Version 1 : dsec
         }
     }
 
-    return FALSE;
+    // An incomplete compaction is not a valid file
+    if (count < buffer[3]){
+        return -1;
+    }
+
+    // Previous versions are rewritten
+    *damaged = (record != buffer + size) || (SCORE_JOURNAL_VERSION != buffer[2]);
+    return count;
 }
 
 //  scores_free() : Free the list of scores
@@ -78,12 +191,96 @@ void scores_free(PSCORE const scores){
 
 //  scores_add() : Add a new score to the list
 //
+//  The score is appended to the journal
+//
 //  @scores : Pointer to the scores list
-//  @level, @tipme : score's values
+//  @level, @time : score's values
+//  @bbbv : 3BV of the grid
 //
 //  @return TRUE if added (ie. the score is in the high-scores list)
 //
-BOOL scores_add(PSCORE const scores, uint8_t level, uint16_t time){
+BOOL scores_add(PSCORE const scores, uint8_t level, uint32_t time, uint16_t bbbv){
+    if (!_insert(scores, level, time, bbbv)){
+        return FALSE;
+    }
+
+    // A single record is written ...
+    if (_storage.compact || NO_FILE == _storage.file ||
+        _storage.records >= SCORE_FILE_RECORDS || !_append(level, time, bbbv)){
+        _compact(scores);   // ... or the whole table
+    }
+
+    return TRUE;
+}
+
+//  scores_efficiency() : 3BV per second of a score
+//
+//  @bbbv : 3BV of the grid
+//  @time : duration in ms
+//
+//  @return : 3BV/s in 1/100 (0 if unknown)
+//
+uint16_t scores_efficiency(uint16_t bbbv, uint32_t time){
+    return (bbbv && time)?(uint16_t)((uint32_t)bbbv * 100000 / time):0;
+}
+
+// scores_efficiency2a() : Convert an efficiency to a string
+//
+//  @eff : Efficiency in 1/100 3BV/s
+//  @str : destination buffer (must be large enough)
+//
+//  @return : a pointer to the string
+//
+char* scores_efficiency2a(uint16_t eff, char *str){
+    if (str){
+        if (!eff){
+            strcpy(str, "-");
+        }
+        else{
+            size_t len;
+            __itoa(eff / 100, FALSE, str);
+            len = strlen(str);
+            str[len++] = '.';
+            str[len++] = '0' + (eff % 100) / 10;
+            str[len++] = '0' + eff % 10;
+            str[len] = 0;
+        }
+    }
+    return str;
+}
+
+// scores_time2a() : Convert a game duration val to a string
+//
+//  @num : Time to convert (in ms)
+//  @str : destination buffer (must be large enough)
+//
+//  @return : a pointer to the string
+//
+char* scores_time2a(uint32_t num, char *str){
+    if (str){
+        size_t len;
+        __itoa(((num<1000)?1:(int)(num / 1000)), FALSE, str);   // not less than 1 sec.
+
+        len = strlen(str);
+        num = (num<1000)?0:(num % 1000);
+        str[len++] = '.';
+        str[len++] = '0' + num / 100;
+        str[len++] = '0' + (num / 10) % 10;
+        str[len++] = '0' + num % 10;
+        str[len] = 0;
+    }
+    return str;
+}
+
+//
+// Internal functions
+//
+
+// _insert() : Insert a score in the list
+//
+//  @return TRUE if added (ie. the score is in the high-scores list)
+//
+static BOOL _insert(PSCORE const scores, uint8_t level, uint32_t time, uint16_t bbbv){
     BOOL found = FALSE, add = FALSE;
     uint8_t id, pos=0, count;
 
@@ -111,34 +308,164 @@ BOOL scores_add(PSCORE const scores, uint8_t level, uint16_t time){
     if (count){
         for (id = pos + count; id > pos; id--){
             scores[id].time = scores[id-1].time;
+            scores[id].bbbv = scores[id-1].bbbv;
         }
     }
 
     scores[pos].time = time;
+    scores[pos].bbbv = bbbv;
     return TRUE;
 }
 
-// scores_time2a() : Convert a game duration val to a string
+// _setDefaults() : Default scores
 //
-//  @num : Time to convert
-//  @str : destination buffer (must be large enough)
+static void _setDefaults(PSCORE const scores){
+    memset(scores, 0, SCORE_SIZE * SCORE_COUNT);
+    for (uint8_t id=0; id < SCORE_COUNT; id++){
+        scores[id].level = id / SCORE_LEVEL_COUNT;
+        scores[id].time = SCORE_DEFAULT_TIME(scores[id].level);
+    }
+}
+
+// _loadPrevious() : Load the scores file of a previous version
 //
-//  @return : a pointer to the string
+//  @return : TRUE if scores have been loaded
 //
-char* scores_time2a(int num, char *str){
-    if (str){
-        size_t len;
-        __itoa((num<10?10:num), FALSE, str);   // not less than 1 sec.
+static BOOL _loadPrevious(PSCORE const scores){
+    SCORE_V2 old[SCORE_COUNT];
+    ssize_t ct;
+    int fd = open(SCORE_FILE, O_RDONLY);
+
+    if (fd == -1){
+        return FALSE;
+    }
+
+    ct = read(fd, (void*)old, sizeof(old));
+    close(fd);
+
+    if (ct == (ssize_t)(SCORE_V1_SIZE * SCORE_COUNT)){
+        // v0.2.x : 3BV are unknown
+        SCORE_V1 v1[SCORE_COUNT];
+        memcpy(v1, old, sizeof(v1));
+        for (uint8_t id=0; id < SCORE_COUNT; id++){
+            scores[id].level = v1[id].level;
+            scores[id].time = v1[id].time * 100;
+            scores[id].bbbv = 0;
+        }
+    }
+    else if (ct == (ssize_t)(SCORE_V2_SIZE * SCORE_COUNT)){
+        for (uint8_t id=0; id < SCORE_COUNT; id++){
+            scores[id].level = old[id].level;
+            scores[id].time = old[id].time * 100;
+            scores[id].bbbv = old[id].bbbv;
+        }
+    }
+    else{
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+// _append() : Append a record to the current journal
+//
+static BOOL _append(uint8_t level, uint32_t time, uint16_t bbbv){
+    uint8_t record[SCORE_RECORD_SIZE];
+    BOOL done;
+    int fd;
+
+    if (-1 == (fd = open(_files[_storage.file], O_WRONLY | O_APPEND))){
+        return FALSE;
+    }
 
-        if ((len = strlen(str))>1){
-            str[len] = str[len-1];
-            str[len-1] = '.';
-            str[len+1] = 0;
+    _encode(record, _storage.records, _storage.generation, level, time, bbbv);
+    done = (SCORE_RECORD_SIZE == write(fd, record, SCORE_RECORD_SIZE));
+    close(fd);
+
+    if (done){
+        _storage.records++;
+    }
+    return done;
+}
+
+// _compact() : Write the scores in the other journal file
+//
+//  The current file is kept until the new one is complete
+//
+static BOOL _compact(PSCORE const scores){
+    uint8_t buffer[SCORE_HEADER_SIZE + SCORE_COUNT * SCORE_RECORD_SIZE];
+    uint8_t file = (NO_FILE == _storage.file)?0:(_storage.file ^ 1);
+    uint16_t generation = _storage.generation + 1, crc;
+    uint8_t id, count = 0;
+    size_t size;
+    BOOL done;
+    int fd;
+
+    // Default scores are not stored
+    for (id = 0; id < SCORE_COUNT; id++){
+        if (scores[id].bbbv || scores[id].time != SCORE_DEFAULT_TIME(scores[id].level)){
+            _encode(buffer + SCORE_HEADER_SIZE + count * SCORE_RECORD_SIZE, count, generation,
+                    scores[id].level, scores[id].time, scores[id].bbbv);
+            count++;
         }
+    }
 
+    memcpy(buffer, HEADER_MAGIC, 2);
+    buffer[2] = SCORE_JOURNAL_VERSION;
+    buffer[3] = count;
+    buffer[4] = (uint8_t)generation;
+    buffer[5] = (uint8_t)(generation >> 8);
+    crc = _crc(buffer, 6, 0xFFFF);
+    buffer[6] = (uint8_t)crc;
+    buffer[7] = (uint8_t)(crc >> 8);
+
+    if (-1 == (fd = open(_files[file], O_WRONLY | O_CREAT | O_TRUNC, 0644))){
+        return FALSE;
     }
-    return str;
+
+    size = SCORE_HEADER_SIZE + count * SCORE_RECORD_SIZE;
+    done = ((ssize_t)size == write(fd, buffer, size));
+    close(fd);
+
+    if (done){
+        _storage.file = file;
+        _storage.generation = generation;
+        _storage.records = count;
+        _storage.compact = FALSE;
+    }
+
+    return done;
 }
 
+// _encode() : Encode a record
+//
+static void _encode(uint8_t* dest, uint8_t index, uint16_t generation, uint8_t level, uint32_t time, uint16_t bbbv){
+    uint16_t crc;
+
+    dest[0] = (uint8_t)(level | ((time >> 16) << 2));
+    dest[1] = index;
+    dest[2] = (uint8_t)time;
+    dest[3] = (uint8_t)(time >> 8);
+    dest[4] = (uint8_t)bbbv;
+    dest[5] = (uint8_t)(bbbv >> 8);
+    crc = _crc(dest, 6, generation);
+    dest[6] = (uint8_t)crc;
+    dest[7] = (uint8_t)(crc >> 8);
+}
+
+// _crc() : CRC-16 (CCITT polynomial)
+//
+static uint16_t _crc(const uint8_t* data, uint8_t size, uint16_t crc){
+    uint8_t bit;
+
+    while (size--){
+        crc ^= (uint16_t)(*data++ << 8);
+        for (bit = 0; bit < 8; bit++){
+            crc = (crc & 0x8000)?(uint16_t)((crc << 1) ^ 0x1021):(uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
 
 // EOF
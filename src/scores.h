@@ -12,22 +12,58 @@
 #include "shared/casioCalcs.h"
 #include "consts.h"
 
+//
+// Scores are stored in a journal : each new best score is appended to the
+// current file as a fixed-size record protected by a CRC. Loading the
+// scores replays the valid records over the default scores.
+//
+// When the journal is full (or damaged) the scores are written in the
+// other file with a higher generation : the "compaction". A file is only
+// used if all its compacted records are valid, so a torn write never
+// loses the previous scores.
+//
+//  header : "GT", version, # of compacted records, generation (16 bits),
+//              CRC of the header
+//  record : level | bits 16-21 of the time, index in the file,
+//              time (low 16 bits), 3BV (16 bits), CRC of the record
+//              (seeded with the generation)
+//
+// Values are little endian. Times are in ms (version 1 used dsec).
+//
+
 #ifdef DEST_CASIO_CALC
-#define SCORE_FILE            "_geeMines.top"
+#define SCORE_FILE            "_geeMines.top"   // Previous format
+#define SCORE_JOURNAL_0       "_geeMines.sc0"
+#define SCORE_JOURNAL_1       "_geeMines.sc1"
 #else
 #define SCORE_FILE            "/home/jhb/bidon/geeMines.top"
+#define SCORE_JOURNAL_0       "/home/jhb/bidon/geeMines.sc0"
+#define SCORE_JOURNAL_1       "/home/jhb/bidon/geeMines.sc1"
 #endif // #ifdef DEST_CASIO_CALC
 
 #define SCORE_LEVEL_COUNT     5     // # per level
 #define SCORE_COUNT           (3 * SCORE_LEVEL_COUNT)
 
+#define SCORE_DEFAULT_TIME(level)   ((uint32_t)(500 + 1500 * (level)) * 100)   // in ms
+
+// Journal
+//
+#define SCORE_JOURNAL_VERSION 2
+#define SCORE_HEADER_SIZE     8
+#define SCORE_RECORD_SIZE     8
+#define SCORE_JOURNAL_MAX     48    // # of appended records before compaction
+#define SCORE_FILE_RECORDS    (SCORE_COUNT + SCORE_JOURNAL_MAX)
+
 // A score
 typedef struct __score{
-    uint8_t level :2;
-    uint16_t time :14;      // in dsec
+    uint8_t level;
+    uint32_t time;          // in ms
+    uint16_t bbbv;          // 3BV of the grid (0 if unknown)
 }SCORE, * PSCORE;
 
-#define SCORE_SIZE          2//  sizeof(SCORE)
+#define SCORE_SIZE          sizeof(SCORE)
+#define SCORE_V1_SIZE       2   // Previous formats (.top file)
+#define SCORE_V2_SIZE       4
 
 // Positions
 //
@@ -37,8 +73,10 @@ typedef struct __score{
 #define SCORES_TOP          60
 #define SCORES_HEIGHT       20
 
-#define SCORES_COL_ID       160
-#define SCORES_COL_SCORE    210
+#define SCORES_COL_ID       120
+#define SCORES_COL_SCORE    160
+#define SCORES_COL_BBBV     230
+#define SCORES_COL_STATS    80      // Statistics of the level
 
 #ifdef __cplusplus
 extern "C" {
@@ -52,12 +90,26 @@ PSCORE scores_load();
 
 //  scores_save() : Save the scores list to the disk
 //
+//  New scores are already in the journal : the file is only written
+//  if it must be compacted
+//
 //  @scores : Pointer to the scores list
 //
 //  @return TRUE if done
 //
 BOOL scores_save(PSCORE const scores);
 
+//  scores_readFile() : Read the valid records of a score journal
+//
+//  @file : Name of the file
+//  @records : Buffer of SCORE_FILE_RECORDS scores
+//  @generation : Pointer to the generation of the file
+//  @damaged : Pointer set to TRUE if the end of the file is not valid
+//
+//  @return : count of records or -1 if the file is not valid
+//
+int scores_readFile(const char* file, PSCORE records, uint16_t* generation, BOOL* damaged);
+
 //  scores_free() : Free the list of scores
 //
 //  @scores : Pointer to the scores list
@@ -66,21 +118,42 @@ void scores_free(PSCORE const scores);
 
 //  scores_add() : Add a new score to the list
 //
+//  The score is appended to the journal
+//
 //  @scores : Pointer to the scores list
-//  @level, @tipme : score's values
+//  @level, @time : score's values
+//  @bbbv : 3BV of the grid
 //
 //  @return TRUE if added (ie. the score is in the high-scores list)
 //
-BOOL scores_add(PSCORE const scores, uint8_t level, uint16_t time);
+BOOL scores_add(PSCORE const scores, uint8_t level, uint32_t time, uint16_t bbbv);
+
+//  scores_efficiency() : 3BV per second of a score
+//
+//  @bbbv : 3BV of the grid
+//  @time : duration in ms
+//
+//  @return : 3BV/s in 1/100 (0 if unknown)
+//
+uint16_t scores_efficiency(uint16_t bbbv, uint32_t time);
+
+// scores_efficiency2a() : Convert an efficiency to a string
+//
+//  @eff : Efficiency in 1/100 3BV/s
+//  @str : destination buffer (must be large enough)
+//
+//  @return : a pointer to the string
+//
+char* scores_efficiency2a(uint16_t eff, char *str);
 
 // scores_time2a() : Convert a game duration val to a string
 //
-//  @num : Time to convert
+//  @num : Time to convert (in ms)
 //  @str : destination buffer (must be large enough)
 //
 //  @return : a pointer to the string
 //
-char* scores_time2a(int num, char *str);
+char* scores_time2a(uint32_t num, char *str);
 
 #ifdef __cplusplus
 }
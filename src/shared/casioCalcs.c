@@ -188,51 +188,6 @@ void capture_remove(){
 #endif // #ifdef DEST_CASIO_CALC
 #endif // #ifdef  SCREEN_CAPTURE
 
-#ifdef TRACE_MODE
-
-//
-// Debug & trace primitives
-//
-
-// __coordtoa() : Format point coord. to an output string
-//
-//  This specific method creates a string composed of the name of the value
-//  and the value it self. It is equivalent to a sprintf(out, "%s : %d", name, value)
-//
-//  The base can't be changed it is always equal to 10
-//
-//  This method assumes the output buffer - ie. str - is large enough to contain
-//  the name and the formated value.
-//
-//  @name : Name of the value (can be NULL)
-//  @x,@y : Position to show
-//  @str : Pointer to output string
-//
-//  @return : pointer to formated string
-//
-char* __coordtoa(const char* name, uint8_t x, uint8_t y, char* str){
-    char* strVal = str;
-
-    // Add name
-    if (name){
-        strcpy(str, name);
-        strVal+=strlen(str);    // num. value starts here
-    }
-
-    // Append col. value
-    __atoi(x, strVal);
-
-    strVal = str + strlen(str);
-    strVal[0] = ',';                // Add a separator
-    strVal++;
-
-    __atoi(y, strVal);
-
-    return str;
-}
-
-#endif // TRACE_MODE
-
 // __itoa() : Convert a num. val to a string
 //
 //  @num : Numeric value to convert
@@ -13,15 +13,18 @@
 #ifdef DEST_CASIO_CALC
 // Specific includes for calculators
 #include <gint/gint.h>
-#include <gint/display.h>
+#include "render.h"     // gint's display functions
 
 // Screen dimensions in pixels
 #define CASIO_WIDTH     DWIDTH
 #define CASIO_HEIGHT    DHEIGHT
 #else
-// Screen dimensions in pixels for tests
-#define CASIO_WIDTH     384
-#define CASIO_HEIGHT    192
+// Drawing in a framebuffer
+#include "render.h"
+
+// Screen dimensions in pixels
+#define CASIO_WIDTH     RENDER_WIDTH
+#define CASIO_HEIGHT    RENDER_HEIGHT
 #endif // #ifdef DEST_CASIO_CALC
 
 #include <stdint.h>
@@ -31,11 +34,6 @@
 // A few basic colours
 //
 
-#ifndef DEST_CASIO_CALC
-// 24 bits RGB (for tests only on Windows and Linux)
-#define C_RGB(r,g,b)    ((uint32_t)(((uint8_t)(r)|((uint16_t)((uint8_t)(g))<<8))|(((uint32_t)(uint8_t)(b))<<16)))
-#endif // #ifndef DEST_CASIO_CALC
-
 #ifdef FX9860G
 #define COLOUR_BLACK    C_BLACK
 #define COLOUR_WHITE    C_WHITE
@@ -81,8 +79,8 @@ typedef uint8_t BOOL;
 #define SET_IN_RANGE(val, min, max) ((val < min)?min:((val > max)?max:val))
 
 // Min. / Max.
-#define MIN_VAL(a,b)    (a<=b?a:b)
-#define MAX_VAL(a,b)    MIN_VAL(b,a)
+#define MIN_VAL(a,b)    ((a)<=(b)?(a):(b))
+#define MAX_VAL(a,b)    ((a)>=(b)?(a):(b))
 
 // Point coordinates
 //
@@ -192,32 +190,6 @@ void rotateRect(PRECT const rect);
 #endif // #ifdef DEST_CASIO_CALC
 #endif // #ifdef  SCREEN_CAPTURE
 
-//
-// Debug & trace primitives
-//
-
-#ifdef TRACE_MODE
-
-// __coordtoa() : Format a point coord. to an output string
-//
-//  This specific method creates a string composed of the name of the value
-//  and the value it self. It is equivalent to a sprintf(out, "%s : %d", name, value)
-//
-//  The base can't be changed it is always equal to 10
-//
-//  This method assumes the output buffer - ie. str - is large enough to contain
-//  the name and the formated value.
-//
-//  @name : Name of the value (can be NULL)
-//  @x,@y : Position to show
-//  @str : Pointer to output string
-//
-//  @return : pointer to formated string
-//
-char* __coordtoa(const char* name, uint8_t x, uint8_t y, char* str);
-
-#endif // TRACE_MODE
-
 // __itoa() : Convert a num. val to a string
 //
 //  @num : Numeric value to convert
@@ -0,0 +1,123 @@
+//----------------------------------------------------------------------
+//--
+//--    chrono.c
+//--
+//--    Monotonic chronometer (ms)
+//--
+//----------------------------------------------------------------------
+
+#include "chrono.h"
+
+#ifdef DEST_CASIO_CALC
+#include <gint/timer.h>
+
+static volatile uint32_t _ms = 0;   // Counted by the timer
+static int _timerID = -1;
+static uint8_t _running = 0;        // # of running chronometers
+
+static int _onTimer();
+#else
+#include <time.h>
+#endif // #ifdef DEST_CASIO_CALC
+
+static uint32_t _clock();
+
+//  chrono_reset() : Stop a chronometer and set its value
+//
+//  @chrono : Pointer to the chronometer
+//  @elapsed : Value in ms
+//
+void chrono_reset(PCHRONO const chrono, uint32_t elapsed){
+    if (chrono){
+        chrono_stop(chrono);
+        chrono->elapsed = elapsed;
+    }
+}
+
+//  chrono_start() : Start (or go on) counting
+//
+//  @chrono : Pointer to the chronometer
+//
+//  @return : FALSE if there is no clock
+//
+BOOL chrono_start(PCHRONO const chrono){
+    if (!chrono){
+        return FALSE;
+    }
+
+    if (!chrono->running){
+#ifdef DEST_CASIO_CALC
+        if (!_running){
+            if ((_timerID = timer_configure(TIMER_ANY, 1000, GINT_CALL(_onTimer))) < 0){
+                return FALSE;
+            }
+            timer_start(_timerID);
+        }
+        _running++;
+#endif // #ifdef DEST_CASIO_CALC
+
+        chrono->start = _clock();
+        chrono->running = TRUE;
+    }
+
+    return TRUE;
+}
+
+//  chrono_stop() : Stop counting
+//
+//  @chrono : Pointer to the chronometer
+//
+void chrono_stop(PCHRONO const chrono){
+    if (chrono && chrono->running){
+        chrono->elapsed = chrono_ms(chrono);
+        chrono->running = FALSE;
+
+#ifdef DEST_CASIO_CALC
+        if (!--_running){
+            timer_stop(_timerID);
+            _timerID = -1;
+        }
+#endif // #ifdef DEST_CASIO_CALC
+    }
+}
+
+//  chrono_ms() : Elapsed time
+//
+//  @chrono : Pointer to the chronometer
+//
+//  @return : time in ms
+//
+uint32_t chrono_ms(const CHRONO* chrono){
+    if (!chrono){
+        return 0;
+    }
+
+    return chrono->elapsed + (chrono->running?(_clock() - chrono->start):0);
+}
+
+//
+// Internal functions
+//
+
+// _clock() : Current value of the clock in ms
+//
+static uint32_t _clock(){
+#ifdef DEST_CASIO_CALC
+    return _ms;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+#endif // #ifdef DEST_CASIO_CALC
+}
+
+#ifdef DEST_CASIO_CALC
+// _onTimer() : One more ms
+//
+static int _onTimer(){
+    _ms++;
+    return TIMER_CONTINUE;
+}
+#endif // #ifdef DEST_CASIO_CALC
+
+// EOF
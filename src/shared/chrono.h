@@ -0,0 +1,67 @@
+//----------------------------------------------------------------------
+//--
+//--    chrono.h
+//--
+//--    Monotonic chronometer (ms)
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_TOOLS_CHRONO_h__
+#define __GEE_TOOLS_CHRONO_h__    1
+
+#include "casioCalcs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// The time doesn't depend on the main loop : on the calculator a hardware
+// timer counts the milliseconds while a chronometer is running, on Linux
+// the monotonic clock is used.
+//
+
+// A chronometer
+//
+typedef struct __chrono{
+    uint32_t elapsed;       // ms before the last start
+    uint32_t start;         // Clock value at start
+    BOOL running;
+} CHRONO, * PCHRONO;
+
+//  chrono_reset() : Stop a chronometer and set its value
+//
+//  @chrono : Pointer to the chronometer
+//  @elapsed : Value in ms
+//
+void chrono_reset(PCHRONO const chrono, uint32_t elapsed);
+
+//  chrono_start() : Start (or go on) counting
+//
+//  @chrono : Pointer to the chronometer
+//
+//  @return : FALSE if there is no clock
+//
+BOOL chrono_start(PCHRONO const chrono);
+
+//  chrono_stop() : Stop counting
+//
+//  @chrono : Pointer to the chronometer
+//
+void chrono_stop(PCHRONO const chrono);
+
+//  chrono_ms() : Elapsed time
+//
+//  @chrono : Pointer to the chronometer
+//
+//  @return : time in ms
+//
+uint32_t chrono_ms(const CHRONO* chrono);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_TOOLS_CHRONO_h__
+
+// EOF
@@ -0,0 +1,239 @@
+//----------------------------------------------------------------------
+//--
+//--    frameStats.c
+//--
+//--    Counters of the drawing functions for each frame (debug mode)
+//--
+//----------------------------------------------------------------------
+
+#define RENDER_INTERNAL     // gint's functions are not redirected here
+#include "frameStats.h"
+
+#ifdef _DEBUG_
+
+#include <string.h>
+
+#ifdef DEST_CASIO_CALC
+#include "chrono.h"
+
+static CHRONO _chrono;
+#else
+#include <stdio.h>
+#include <time.h>
+#endif // #ifdef DEST_CASIO_CALC
+
+// Names of the counters
+static const char* _names[FRAME_COUNTERS] = {"dsubimage", "drect", "dline", "Boxes", "Chrome", "Pixels", "Time (us)"};
+
+static uint32_t _current[FRAME_COUNTERS];   // Frame being drawn
+static uint32_t _frames[FRAME_STATS_WINDOW][FRAME_COUNTERS];
+static uint8_t _count = 0;                  // # of frames in the window
+static uint8_t _next = 0;                   // Next frame in the window
+static uint32_t _updates = 0;
+static uint8_t _started = 0;                // Time of the frame is running
+static uint32_t _start;
+
+static void _begin();
+static void _area(int x1, int y1, int x2, int y2);
+static uint32_t _clock();
+
+//  frameStats_add() : Increase a counter of the current frame
+//
+//  @counter : ID of the counter
+//  @value : Value to add
+//
+void frameStats_add(FRAME_COUNTER counter, uint32_t value){
+    if (counter < FRAME_COUNTERS){
+        _current[counter] += value;
+    }
+}
+
+//  frameStats_summary() : Values of the last frames
+//
+//  @summary : Pointer to the values
+//
+void frameStats_summary(PFRAME_SUMMARY const summary){
+    uint8_t frame, counter;
+    uint32_t value, sum;
+
+    if (!summary){
+        return;
+    }
+
+    memset(summary, 0, sizeof(FRAME_SUMMARY));
+    summary->updates = _updates;
+    if (!(summary->frames = _count)){
+        return;
+    }
+
+    for (counter = 0; counter < FRAME_COUNTERS; counter++){
+        summary->last[counter] = _frames[(_next + FRAME_STATS_WINDOW - 1) % FRAME_STATS_WINDOW][counter];
+        summary->min[counter] = 0xFFFFFFFF;
+        for (frame = 0, sum = 0; frame < _count; frame++){
+            value = _frames[frame][counter];
+            sum += value;
+            summary->min[counter] = (value < summary->min[counter])?value:summary->min[counter];
+            summary->max[counter] = (value > summary->max[counter])?value:summary->max[counter];
+        }
+        summary->mean[counter] = sum / _count;
+    }
+}
+
+//  frameStats_reset() : Remove all the frames
+//
+void frameStats_reset(){
+    memset(_current, 0, sizeof(_current));
+    _count = _next = 0;
+    _started = 0;
+}
+
+//  frameStats_name() : Name of a counter
+//
+//  @counter : ID of the counter
+//
+//  @return : Name of the counter
+//
+const char* frameStats_name(FRAME_COUNTER counter){
+    return (counter < FRAME_COUNTERS)?_names[counter]:"";
+}
+
+#ifndef DEST_CASIO_CALC
+//  frameStats_print() : Print the values of the last frames
+//
+//  @summary : Values to print
+//
+void frameStats_print(PFRAME_SUMMARY const summary){
+    uint8_t counter;
+
+    if (summary){
+        printf("%u frames - last %u :\n", summary->updates, summary->frames);
+        printf("%-10s %10s %10s %10s %10s\n", "", "last", "min", "mean", "max");
+        for (counter = 0; counter < FRAME_COUNTERS; counter++){
+            printf("%-10s %10u %10u %10u %10u\n", _names[counter], summary->last[counter],
+                    summary->min[counter], summary->mean[counter], summary->max[counter]);
+        }
+    }
+}
+#endif // #ifndef DEST_CASIO_CALC
+
+//
+// Counted functions
+//
+
+void frameStats_dclear(int colour){
+    _begin();
+    _area(0, 0, RENDER_WIDTH - 1, RENDER_HEIGHT - 1);
+    dclear(colour);
+}
+
+void frameStats_drect(int x1, int y1, int x2, int y2, int colour){
+    _begin();
+    _current[FRAME_RECTS]++;
+    _area(x1, y1, x2, y2);
+    drect(x1, y1, x2, y2, colour);
+}
+
+void frameStats_drect_border(int x1, int y1, int x2, int y2, int fill, int width, int border){
+    _begin();
+    _area(x1, y1, x2, y2);
+    drect_border(x1, y1, x2, y2, fill, width, border);
+}
+
+void frameStats_dline(int x1, int y1, int x2, int y2, int colour){
+    int dx = (x2 > x1)?(x2 - x1):(x1 - x2), dy = (y2 > y1)?(y2 - y1):(y1 - y2);
+    _begin();
+    _current[FRAME_LINES]++;
+    _current[FRAME_PIXELS] += ((dx > dy)?dx:dy) + 1;
+    dline(x1, y1, x2, y2, colour);
+}
+
+void frameStats_dimage(int x, int y, bopti_image_t const* image){
+    _begin();
+    dimage(x, y, image);    // Size is known once drawn (Linux)
+    _area(x, y, x + image->width - 1, y + image->height - 1);
+}
+
+void frameStats_dsubimage(int x, int y, bopti_image_t const* image, int left, int top, int w, int h, int flags){
+    _begin();
+    _current[FRAME_SUBIMAGES]++;
+    _area(x, y, x + w - 1, y + h - 1);
+    dsubimage(x, y, image, left, top, w, h, flags);
+}
+
+void frameStats_dtext(int x, int y, int fg, char const* str){
+    _begin();
+    dtext(x, y, fg, str);
+}
+
+void frameStats_dtext_opt(int x, int y, int fg, int bg, int halign, int valign, char const* str, int size){
+    _begin();
+    dtext_opt(x, y, fg, bg, halign, valign, str, size);
+}
+
+void frameStats_dupdate(){
+    _begin();
+    dupdate();
+    _current[FRAME_TIME] = _clock() - _start;
+    _started = 0;
+    _updates++;
+
+    // The frame enters the window
+    memcpy(_frames[_next], _current, sizeof(_current));
+    _next = (_next + 1) % FRAME_STATS_WINDOW;
+    if (_count < FRAME_STATS_WINDOW){
+        _count++;
+    }
+    memset(_current, 0, sizeof(_current));
+}
+
+//
+// Internal functions
+//
+
+// _begin() : First drawing call of a frame ?
+//
+static void _begin(){
+    if (!_started){
+        _start = _clock();
+        _started = 1;
+    }
+}
+
+// _area() : Pixels of a rectangle in the screen
+//
+static void _area(int x1, int y1, int x2, int y2){
+    int swap;
+    if (x1 > x2){
+        swap = x1; x1 = x2; x2 = swap;
+    }
+    if (y1 > y2){
+        swap = y1; y1 = y2; y2 = swap;
+    }
+
+    x1 = (x1 < 0)?0:x1;
+    y1 = (y1 < 0)?0:y1;
+    x2 = (x2 >= RENDER_WIDTH)?(RENDER_WIDTH - 1):x2;
+    y2 = (y2 >= RENDER_HEIGHT)?(RENDER_HEIGHT - 1):y2;
+    if (x1 <= x2 && y1 <= y2){
+        _current[FRAME_PIXELS] += (uint32_t)(x2 - x1 + 1) * (y2 - y1 + 1);
+    }
+}
+
+// _clock() : Current time in µs
+//
+static uint32_t _clock(){
+#ifdef DEST_CASIO_CALC
+    if (!_chrono.running){
+        chrono_start(&_chrono);     // ms
+    }
+    return chrono_ms(&_chrono) * 1000;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000 + now.tv_nsec / 1000);
+#endif // #ifdef DEST_CASIO_CALC
+}
+
+#endif // #ifdef _DEBUG_
+
+// EOF
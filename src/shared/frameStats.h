@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------
+//--
+//--    frameStats.h
+//--
+//--    Counters of the drawing functions for each frame (debug mode)
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_TOOLS_FRAME_STATS_h__
+#define __GEE_TOOLS_FRAME_STATS_h__    1
+
+#include "render.h"
+
+#include <stdint.h>
+
+//
+// In debug mode (_DEBUG_), render.h redirects gint's drawing functions
+// and dupdate() to this module. The calls and the pixels they cover are
+// counted until dupdate(), which closes the frame. The counters of the
+// last FRAME_STATS_WINDOW frames give rolling min, mean and max values.
+//
+// The time of a frame starts with its first drawing call and ends when
+// dupdate() returns. It is measured in ms on the calculator and in µs
+// on Linux.
+//
+// With RENDER_RECORD, the commands are counted when they are executed :
+// dropped commands are not counted.
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+#define FRAME_STATS_WINDOW  32      // # of frames of the rolling values
+
+// Counters
+//
+typedef enum{
+    FRAME_SUBIMAGES = 0,    // Calls to dsubimage()
+    FRAME_RECTS,            // Calls to drect()
+    FRAME_LINES,            // Calls to dline()
+    FRAME_BOXES,            // Boxes of the grid drawn
+    FRAME_CHROMES,          // Borders of the board drawn (not copied)
+    FRAME_PIXELS,           // Area of the rectangles, images and lines (text excepted)
+    FRAME_TIME,             // in µs
+    FRAME_COUNTERS
+} FRAME_COUNTER;
+
+// Rolling values
+//
+typedef struct __frameSummary{
+    uint32_t updates;           // # of calls to dupdate()
+    uint8_t frames;             // # of frames in the window
+    uint32_t last[FRAME_COUNTERS];
+    uint32_t min[FRAME_COUNTERS];
+    uint32_t mean[FRAME_COUNTERS];
+    uint32_t max[FRAME_COUNTERS];
+} FRAME_SUMMARY, * PFRAME_SUMMARY;
+
+//  frameStats_add() : Increase a counter of the current frame
+//
+//  @counter : ID of the counter
+//  @value : Value to add
+//
+void frameStats_add(FRAME_COUNTER counter, uint32_t value);
+
+//  frameStats_summary() : Values of the last frames
+//
+//  @summary : Pointer to the values
+//
+void frameStats_summary(PFRAME_SUMMARY const summary);
+
+//  frameStats_reset() : Remove all the frames
+//
+void frameStats_reset();
+
+//  frameStats_name() : Name of a counter
+//
+//  @counter : ID of the counter
+//
+//  @return : Name of the counter
+//
+const char* frameStats_name(FRAME_COUNTER counter);
+
+#ifndef DEST_CASIO_CALC
+//  frameStats_print() : Print the values of the last frames
+//
+//  @summary : Values to print
+//
+void frameStats_print(PFRAME_SUMMARY const summary);
+#endif // #ifndef DEST_CASIO_CALC
+
+//
+// Counted functions
+//
+
+void frameStats_dclear(int colour);
+void frameStats_drect(int x1, int y1, int x2, int y2, int colour);
+void frameStats_drect_border(int x1, int y1, int x2, int y2, int fill, int width, int border);
+void frameStats_dline(int x1, int y1, int x2, int y2, int colour);
+void frameStats_dimage(int x, int y, bopti_image_t const* image);
+void frameStats_dsubimage(int x, int y, bopti_image_t const* image, int left, int top, int w, int h, int flags);
+void frameStats_dtext(int x, int y, int fg, char const* str);
+void frameStats_dtext_opt(int x, int y, int fg, int bg, int halign, int valign, char const* str, int size);
+void frameStats_dupdate();
+
+// Recorded functions are counted when executed
+#if !defined(RENDER_INTERNAL) && (!defined(RENDER_RECORD) || defined(RECORD_INTERNAL))
+#define dclear(colour)      frameStats_dclear(colour)
+#define drect(x1, y1, x2, y2, colour)   frameStats_drect(x1, y1, x2, y2, colour)
+#define drect_border(x1, y1, x2, y2, fill, width, border)   frameStats_drect_border(x1, y1, x2, y2, fill, width, border)
+#define dline(x1, y1, x2, y2, colour)   frameStats_dline(x1, y1, x2, y2, colour)
+#define dimage(x, y, image)     frameStats_dimage(x, y, image)
+#define dsubimage(x, y, image, left, top, w, h, flags)  frameStats_dsubimage(x, y, image, left, top, w, h, flags)
+#define dtext(x, y, fg, str)    frameStats_dtext(x, y, fg, str)
+#define dtext_opt(x, y, fg, bg, halign, valign, str, size)  frameStats_dtext_opt(x, y, fg, bg, halign, valign, str, size)
+#define dupdate()           frameStats_dupdate()
+#endif // #if !defined(RENDER_INTERNAL) && ...
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_TOOLS_FRAME_STATS_h__
+
+// EOF
@@ -9,16 +9,18 @@
 #include "menu.h"
 #include <string.h>
 
+// Background image
 #ifdef DEST_CASIO_CALC
-    // Background image
     extern bopti_image_t g_menu;
+#else
+    bopti_image_t g_menu = RENDER_IMAGE("menu.png");
+#endif // #ifdef DEST_CASIO_CALC
 
-    // Images index in the image
-    //
-    #define MENU_IMG_BACK_ID        0
-    #define MENU_IMG_CHECKED_ID     1
-    #define MENU_IMG_UNCHECKED_ID   2
-#endif // #ifndef DEST_CASIO_CALC
+// Images index in the image
+//
+#define MENU_IMG_BACK_ID        0
+#define MENU_IMG_CHECKED_ID     1
+#define MENU_IMG_UNCHECKED_ID   2
 
 // menu_create() : Create a new menu
 //
@@ -131,11 +133,10 @@ void menu_updateEx(POWNMENU menu, BOOL update){
         } // for
 
         if (update){
-#ifdef DEST_CASIO_CALC
             dupdate();
-#else
+#ifndef DEST_CASIO_CALC
             printf("\n");
-#endif // #ifdef DEST_CASIO_CALC
+#endif // #ifndef DEST_CASIO_CALC
         }
     }
 }
@@ -199,7 +200,6 @@ BOOL menu_defDrawItem(POWNMENU const menu, PMENUITEM const item, RECT* const anc
         return FALSE;
     }
 
-#ifdef DEST_CASIO_CALC
     BOOL selected = FALSE;
 
     // Draw background
@@ -291,7 +291,9 @@ BOOL menu_defDrawItem(POWNMENU const menu, PMENUITEM const item, RECT* const anc
                 anchor->x + anchor->w -1, anchor->y,
                 menu->colours_[COLOUR_ITEM_BORDER]);
     }
-#else
+
+#ifndef DEST_CASIO_CALC
+    // Console output
     if (item){
         printf("|");
         printf(isBitSet(item->state, ITEM_STATE_SELECTED)?">" : " ");
@@ -318,7 +320,7 @@ BOOL menu_defDrawItem(POWNMENU const menu, PMENUITEM const item, RECT* const anc
     else{
         printf("| [empty] |");
     }
-#endif // #ifdef DEST_CASIO_CALC
+#endif // #ifndef DEST_CASIO_CALC
     return TRUE;    // Done
 }
 
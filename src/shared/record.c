@@ -0,0 +1,632 @@
+//----------------------------------------------------------------------
+//--
+//--    record.c
+//--
+//--    Recorded drawing : the primitives of a frame are kept in a
+//--    command buffer and executed by dupdate(), without the ones whose
+//--    pixels are already on the screen
+//--
+//----------------------------------------------------------------------
+
+#define RECORD_INTERNAL     // gint's functions are not recorded here
+#include "record.h"
+
+#ifdef RENDER_RECORD
+
+#include <string.h>
+
+// Tiles of the screen
+#define TILES_W     ((RENDER_WIDTH + RECORD_TILE - 1) / RECORD_TILE)
+#define TILES_H     ((RENDER_HEIGHT + RECORD_TILE - 1) / RECORD_TILE)
+
+// Commands kept by tile : more commands fill the tile
+#define TILE_COMMANDS   4
+#define TILE_FULL       (TILE_COMMANDS + 1)
+
+// Index of the commands of the previous frame (open addressing)
+#define INDEX_SIZE  (2 * RECORD_MAX_COMMANDS)     // power of 2
+#define INDEX_FREE  0xFFFF
+
+// Commands of a frame
+//
+typedef struct __recordFrame{
+    uint16_t count;
+    uint8_t overflow;           // Commands have been executed without being kept
+    uint16_t textSize;
+    RECORD_COMMAND commands[RECORD_MAX_COMMANDS];
+    char texts[RECORD_TEXT_SIZE];
+} RECORD_FRAME, * PRECORD_FRAME;
+
+// Commands drawn in a tile
+//
+typedef struct __recordTile{
+    uint8_t count;              // TILE_FULL : overlaps any command
+    uint16_t commands[TILE_COMMANDS];
+} RECORD_TILE_LIST;
+
+// Colours in the parameters of each type of command (bit n for args[n])
+static const uint8_t _colourArgs[RECORD_TYPES] = {
+    0x01,   // RECORD_CLEAR
+    0x04,   // RECORD_PIXEL
+    0x10,   // RECORD_RECT
+    0x50,   // RECORD_RECT_BORDER
+    0x10,   // RECORD_LINE
+    0x18,   // RECORD_CIRCLE
+    0x00,   // RECORD_IMAGE
+    0x00,   // RECORD_SUBIMAGE
+    0x04,   // RECORD_TEXT
+    0x0C,   // RECORD_TEXT_OPT
+    0x00    // RECORD_RAW
+};
+
+static RECORD_FRAME _frames[2];
+static uint8_t _current = 0;            // Frame being recorded
+static uint16_t _pending = 0;           // First command not yet executed
+static uint8_t _previous = 0;           // The previous frame can be compared
+static uint8_t _recording = 1;
+static uint16_t _index[INDEX_SIZE];
+static RECORD_TILE_LIST _touched[TILES_H][TILES_W];   // Drawn in the current frame
+static RECORD_STATS _stats;
+
+static void _add(PRECORD_COMMAND const command);
+static int _isVisible(PRECORD_COMMAND const command);
+static void _bounds(PRECORD_COMMAND const command);
+static void _setBounds(PRECORD_COMMAND const command, int x1, int y1, int x2, int y2);
+static int _tiles(PRECORD_COMMAND const command, uint16_t id, RECORD_TILE_LIST tiles[TILES_H][TILES_W], int mark);
+static uint32_t _hash(PRECORD_COMMAND const command);
+static int _equal(PRECORD_COMMAND const first, PRECORD_COMMAND const second);
+static int _inverts(PRECORD_COMMAND const command);
+static void _execute(PRECORD_COMMAND const command);
+static void _endFrame();
+
+//  record_setMode() : Start or stop recording the commands
+//
+//  When recording is stopped, the commands are executed immediately.
+//  Recording is on by default
+//
+//  @on : 1 to record the commands
+//
+void record_setMode(int on){
+    if (_recording){
+        record_flush();
+    }
+
+    // The screen may change without being recorded
+    _recording = on?1:0;
+    _previous = 0;
+    _frames[_current].count = _pending = 0;
+    _frames[_current].textSize = 0;
+    _frames[_current].overflow = 0;
+    memset(_touched, 0, sizeof(_touched));
+}
+
+//  record_flush() : Execute the pending commands
+//
+//  Commands are still compared with the previous frame
+//
+void record_flush(){
+    PRECORD_FRAME frame = _frames + _current;
+    PRECORD_COMMAND command;
+
+    for (command = frame->commands + _pending; _pending < frame->count; _pending++, command++){
+        if (_isVisible(command)){
+            command->dropped = 1;
+            _stats.dropped++;
+        }
+        else{
+            _execute(command);
+            _tiles(command, _pending, _touched, 1);
+            _stats.executed++;
+        }
+    }
+}
+
+//  record_raw() : Pixels of the VRAM will be accessed directly
+//
+//  The pending commands are executed first
+//
+//  @x, @y, @w, @h : Area that may change
+//
+void record_raw(int x, int y, int w, int h){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_RAW;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.args[2] = w;
+    command.args[3] = h;
+    _add(&command);
+}
+
+//  record_frame() : Commands of the last frame
+//
+//  @count : # of commands
+//
+//  @return : pointer to the commands
+//
+const RECORD_COMMAND* record_frame(uint16_t* count){
+    PRECORD_FRAME frame = _frames + (1 - _current);
+    if (count){
+        *count = frame->count;
+    }
+    return frame->commands;
+}
+
+//  record_stats() : Counters
+//
+//  @return : pointer to the counters
+//
+const RECORD_STATS* record_stats(){
+    return &_stats;
+}
+
+//
+// Recorded functions
+//
+
+void record_dclear(int colour){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_CLEAR;
+    command.args[0] = colour;
+    _add(&command);
+}
+
+void record_dpixel(int x, int y, int colour){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_PIXEL;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.args[2] = colour;
+    _add(&command);
+}
+
+void record_drect(int x1, int y1, int x2, int y2, int colour){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_RECT;
+    command.args[0] = x1;
+    command.args[1] = y1;
+    command.args[2] = x2;
+    command.args[3] = y2;
+    command.args[4] = colour;
+    _add(&command);
+}
+
+void record_drect_border(int x1, int y1, int x2, int y2, int fill, int width, int border){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_RECT_BORDER;
+    command.args[0] = x1;
+    command.args[1] = y1;
+    command.args[2] = x2;
+    command.args[3] = y2;
+    command.args[4] = fill;
+    command.args[5] = width;
+    command.args[6] = border;
+    _add(&command);
+}
+
+void record_dline(int x1, int y1, int x2, int y2, int colour){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_LINE;
+    command.args[0] = x1;
+    command.args[1] = y1;
+    command.args[2] = x2;
+    command.args[3] = y2;
+    command.args[4] = colour;
+    _add(&command);
+}
+
+void record_dcircle(int x, int y, int r, int fill, int border){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_CIRCLE;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.args[2] = r;
+    command.args[3] = fill;
+    command.args[4] = border;
+    _add(&command);
+}
+
+void record_dimage(int x, int y, bopti_image_t const* image){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_IMAGE;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.image = image;
+    _add(&command);
+}
+
+void record_dsubimage(int x, int y, bopti_image_t const* image, int left, int top, int w, int h, int flags){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_SUBIMAGE;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.args[2] = left;
+    command.args[3] = top;
+    command.args[4] = w;
+    command.args[5] = h;
+    command.args[6] = flags;
+    command.image = image;
+    _add(&command);
+}
+
+void record_dtext(int x, int y, int fg, char const* str){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_TEXT;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.args[2] = fg;
+    command.str = str;
+    _add(&command);
+}
+
+void record_dtext_opt(int x, int y, int fg, int bg, int halign, int valign, char const* str, int size){
+    RECORD_COMMAND command;
+    memset(&command, 0, sizeof(command));
+    command.type = RECORD_TEXT_OPT;
+    command.args[0] = x;
+    command.args[1] = y;
+    command.args[2] = fg;
+    command.args[3] = bg;
+    command.args[4] = halign;
+    command.args[5] = valign;
+    command.args[6] = size;
+    command.str = str;
+    _add(&command);
+}
+
+void record_dupdate(){
+    if (_recording){
+        record_flush();
+        _endFrame();
+    }
+
+    dupdate();
+}
+
+//
+// Internal functions
+//
+
+// _add() : Add a command to the current frame
+//
+static void _add(PRECORD_COMMAND const command){
+    PRECORD_FRAME frame = _frames + _current;
+    PRECORD_COMMAND dest;
+    size_t len = 0;
+
+    if (!_recording){
+        _execute(command);
+        return;
+    }
+
+    _bounds(command);
+    if (command->str){
+        len = strlen(command->str) + 1;
+    }
+
+    // No more room : executed immediately
+    if (frame->count >= RECORD_MAX_COMMANDS || frame->textSize + len > RECORD_TEXT_SIZE){
+        record_flush();
+        _execute(command);
+        _tiles(command, INDEX_FREE, _touched, 1);
+        frame->overflow = 1;
+        _stats.executed++;
+        return;
+    }
+
+    dest = frame->commands + frame->count++;
+    memcpy(dest, command, sizeof(RECORD_COMMAND));
+    if (len){
+        dest->str = frame->texts + frame->textSize;
+        memcpy(frame->texts + frame->textSize, command->str, len);
+        frame->textSize += len;
+    }
+    dest->hash = _hash(dest);
+
+    // The screen will be accessed now
+    if (RECORD_RAW == command->type){
+        record_flush();
+    }
+}
+
+// _isVisible() : Are the pixels of the command on the screen ?
+//
+static int _isVisible(PRECORD_COMMAND const command){
+    PRECORD_FRAME previous = _frames + (1 - _current);
+    PRECORD_COMMAND other;
+    uint16_t slot;
+
+    if (!_previous || RECORD_RAW == command->type || _inverts(command) ||
+        _tiles(command, INDEX_FREE, _touched, 0)){
+        return 0;
+    }
+
+    for (slot = command->hash & (INDEX_SIZE - 1); INDEX_FREE != _index[slot]; slot = (slot + 1) & (INDEX_SIZE - 1)){
+        other = previous->commands + _index[slot];
+        if (other->hash == command->hash && _equal(other, command)){
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+// _bounds() : Pixels that may be changed by a command
+//
+//  Text and circles are a bit larger than their exact size
+//
+static void _bounds(PRECORD_COMMAND const command){
+    int32_t* args = command->args;
+    int x, y, w, h;
+
+    switch (command->type){
+        case RECORD_CLEAR:
+            _setBounds(command, 0, 0, RENDER_WIDTH - 1, RENDER_HEIGHT - 1);
+            break;
+
+        case RECORD_PIXEL:
+            _setBounds(command, args[0], args[1], args[0], args[1]);
+            break;
+
+        case RECORD_RECT:
+        case RECORD_RECT_BORDER:
+        case RECORD_LINE:
+            _setBounds(command, args[0], args[1], args[2], args[3]);
+            break;
+
+        case RECORD_CIRCLE:
+            _setBounds(command, args[0] - args[2] - 1, args[1] - args[2] - 1,
+                        args[0] + args[2] + 1, args[1] + args[2] + 1);
+            break;
+
+        case RECORD_IMAGE:
+            w = ((bopti_image_t const*)command->image)->width;
+            h = ((bopti_image_t const*)command->image)->height;
+            if (w && h){
+                _setBounds(command, args[0], args[1], args[0] + w - 1, args[1] + h - 1);
+            }
+            else{
+                // Size unknown until the image is loaded
+                _setBounds(command, 0, 0, RENDER_WIDTH - 1, RENDER_HEIGHT - 1);
+            }
+            break;
+
+        case RECORD_SUBIMAGE:
+            _setBounds(command, args[0], args[1], args[0] + args[4] - 1, args[1] + args[5] - 1);
+            break;
+
+        case RECORD_TEXT:
+        case RECORD_TEXT_OPT:
+            dsize(command->str, NULL, &w, &h);
+            x = args[0];
+            y = args[1];
+            if (RECORD_TEXT_OPT == command->type){
+                // Aligned text may start on the left of / above (x, y)
+                x -= (DTEXT_LEFT == args[4])?0:w;
+                y -= (DTEXT_TOP == args[5])?0:h;
+            }
+            _setBounds(command, x - 1, y - 1, args[0] + w, args[1] + h);
+            break;
+
+        case RECORD_RAW:
+            _setBounds(command, args[0], args[1], args[0] + args[2] - 1, args[1] + args[3] - 1);
+            break;
+    }
+}
+
+// _setBounds() : Clipped rectangle
+//
+static void _setBounds(PRECORD_COMMAND const command, int x1, int y1, int x2, int y2){
+    int swap;
+    if (x1 > x2){
+        swap = x1; x1 = x2; x2 = swap;
+    }
+    if (y1 > y2){
+        swap = y1; y1 = y2; y2 = swap;
+    }
+
+    command->x1 = (int16_t)((x1 < 0)?0:x1);
+    command->y1 = (int16_t)((y1 < 0)?0:y1);
+    command->x2 = (int16_t)((x2 >= RENDER_WIDTH)?(RENDER_WIDTH - 1):x2);
+    command->y2 = (int16_t)((y2 >= RENDER_HEIGHT)?(RENDER_HEIGHT - 1):y2);
+}
+
+// _tiles() : Check or mark the tiles under a command
+//
+//  @command : Command of the current frame
+//  @id : Index of the command in the frame, INDEX_FREE if not kept
+//  @tiles : Commands drawn in each tile
+//  @mark : 1 to add the command in its tiles
+//
+//  @return : 1 if the command overlaps one of the commands of the tiles
+//
+static int _tiles(PRECORD_COMMAND const command, uint16_t id, RECORD_TILE_LIST tiles[TILES_H][TILES_W], int mark){
+    PRECORD_COMMAND commands = _frames[_current].commands, other;
+    RECORD_TILE_LIST* tile;
+    int row, col, found = 0;
+    uint8_t index;
+
+    if (command->x2 < command->x1 || command->y2 < command->y1){
+        return 0;   // Out of the screen
+    }
+
+    for (row = command->y1 / RECORD_TILE; row <= command->y2 / RECORD_TILE; row++){
+        for (col = command->x1 / RECORD_TILE; col <= command->x2 / RECORD_TILE; col++){
+            tile = &tiles[row][col];
+
+            // Overlap ?
+            if (!found){
+                found = (TILE_FULL == tile->count);
+                for (index = 0; !found && index < tile->count; index++){
+                    other = commands + tile->commands[index];
+                    found = (command->x1 <= other->x2 && other->x1 <= command->x2 &&
+                                command->y1 <= other->y2 && other->y1 <= command->y2);
+                }
+
+                if (found && !mark){
+                    return 1;
+                }
+            }
+
+            if (mark && TILE_FULL != tile->count){
+                if (INDEX_FREE == id || TILE_COMMANDS == tile->count){
+                    tile->count = TILE_FULL;
+                }
+                else{
+                    tile->commands[tile->count++] = id;
+                }
+            }
+        }
+    }
+
+    return found;
+}
+
+// _hash() : FNV-1a hash of the parameters of a command
+//
+static uint32_t _hash(PRECORD_COMMAND const command){
+    uint32_t hash = 2166136261u;
+    const uint8_t* data = (const uint8_t*)command->args;
+    const char* str;
+    size_t id;
+
+    hash = (hash ^ command->type) * 16777619u;
+    for (id = 0; id < sizeof(command->args); id++){
+        hash = (hash ^ data[id]) * 16777619u;
+    }
+    hash = (hash ^ (uint32_t)(uintptr_t)command->image) * 16777619u;
+    for (str = command->str; str && *str; str++){
+        hash = (hash ^ (uint8_t)*str) * 16777619u;
+    }
+
+    return hash;
+}
+
+// _equal() : Do two commands draw the same pixels ?
+//
+static int _equal(PRECORD_COMMAND const first, PRECORD_COMMAND const second){
+    if (first->type != second->type || first->image != second->image ||
+        memcmp(first->args, second->args, sizeof(first->args))){
+        return 0;
+    }
+
+    if (first->str || second->str){
+        return (first->str && second->str && !strcmp(first->str, second->str));
+    }
+
+    return 1;
+}
+
+// _inverts() : Does the command use C_INVERT ?
+//
+static int _inverts(PRECORD_COMMAND const command){
+    uint8_t id, colours = _colourArgs[command->type];
+    for (id = 0; colours; id++, colours >>= 1){
+        if ((colours & 1) && C_INVERT == command->args[id]){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// _execute() : Call the drawing function
+//
+static void _execute(PRECORD_COMMAND const command){
+    int32_t* args = command->args;
+
+    switch (command->type){
+        case RECORD_CLEAR:
+            dclear(args[0]);
+            break;
+
+        case RECORD_PIXEL:
+            dpixel(args[0], args[1], args[2]);
+            break;
+
+        case RECORD_RECT:
+            drect(args[0], args[1], args[2], args[3], args[4]);
+            break;
+
+        case RECORD_RECT_BORDER:
+            drect_border(args[0], args[1], args[2], args[3], args[4], args[5], args[6]);
+            break;
+
+        case RECORD_LINE:
+            dline(args[0], args[1], args[2], args[3], args[4]);
+            break;
+
+        case RECORD_CIRCLE:
+            dcircle(args[0], args[1], args[2], args[3], args[4]);
+            break;
+
+        case RECORD_IMAGE:
+            dimage(args[0], args[1], (bopti_image_t const*)command->image);
+            break;
+
+        case RECORD_SUBIMAGE:
+            dsubimage(args[0], args[1], (bopti_image_t const*)command->image,
+                        args[2], args[3], args[4], args[5], args[6]);
+            break;
+
+        case RECORD_TEXT:
+            dtext(args[0], args[1], args[2], command->str);
+            break;
+
+        case RECORD_TEXT_OPT:
+            dtext_opt(args[0], args[1], args[2], args[3], args[4], args[5], command->str, args[6]);
+            break;
+
+        default:
+            break;  // RECORD_RAW : done by the caller
+    }
+}
+
+// _endFrame() : The current frame becomes the previous one
+//
+static void _endFrame(){
+    static RECORD_TILE_LIST covered[TILES_H][TILES_W];
+    PRECORD_FRAME frame = _frames + _current;
+    PRECORD_COMMAND command;
+    uint16_t id, slot;
+    int hidden;
+
+    _stats.frames++;
+    _stats.recorded = frame->count;
+    _stats.totalRecorded += frame->count;
+    _stats.totalDropped += _stats.dropped;
+
+    // Commands whose pixels have not been drawn over
+    memset(covered, 0, sizeof(covered));
+    memset(_index, 0xFF, sizeof(_index));
+    for (id = frame->count; id--;){
+        command = frame->commands + id;
+        hidden = _tiles(command, id, covered, 1);
+        command->visible = (!hidden && RECORD_RAW != command->type && !_inverts(command));
+        if (command->visible){
+            for (slot = command->hash & (INDEX_SIZE - 1); INDEX_FREE != _index[slot]; slot = (slot + 1) & (INDEX_SIZE - 1));
+            _index[slot] = id;
+        }
+    }
+    _previous = !frame->overflow;
+
+    // New frame
+    _current = 1 - _current;
+    frame = _frames + _current;
+    frame->count = frame->textSize = _pending = 0;
+    frame->overflow = 0;
+    memset(_touched, 0, sizeof(_touched));
+    _stats.executed = _stats.dropped = 0;
+}
+
+#endif // #ifdef RENDER_RECORD
+
+// EOF
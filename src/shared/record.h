@@ -0,0 +1,171 @@
+//----------------------------------------------------------------------
+//--
+//--    record.h
+//--
+//--    Recorded drawing : the primitives of a frame are kept in a
+//--    command buffer and executed by dupdate(), without the ones whose
+//--    pixels are already on the screen
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_TOOLS_RECORD_h__
+#define __GEE_TOOLS_RECORD_h__    1
+
+#include "render.h"
+
+#include <stdint.h>
+
+//
+// When the sources are compiled with RENDER_RECORD, render.h redirects
+// gint's drawing functions and dupdate() to this module. Each call is
+// appended to the commands of the current frame ; dupdate() executes
+// them in one pass, in the order of the calls, and then updates the
+// screen.
+//
+// A command identical to one of the previous frame is dropped when its
+// pixels are still on the screen : nothing has been drawn over them
+// after it in the previous frame nor before it in the current one.
+// The screen is split in tiles of RECORD_TILE x RECORD_TILE pixels that
+// keep the bounding rectangles of the commands drawn in them : overlaps
+// are only searched in the tiles of a command.
+// Drawing the same command twice gives the same pixels, except with
+// C_INVERT : these commands are never dropped.
+//
+// render_vram() and render_scroll() execute the pending commands before
+// the pixels are accessed. The area they may change is handled as a
+// command that can't be dropped.
+//
+// The commands of the last frame can be read, for instance to check
+// headless what a frame draws, and the dropped ones are counted.
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+// Size of the buffers (of a frame)
+//
+#ifndef RECORD_MAX_COMMANDS
+#define RECORD_MAX_COMMANDS     1024
+#endif // #ifndef RECORD_MAX_COMMANDS
+#define RECORD_TEXT_SIZE        2048    // Copies of the strings
+
+#define RECORD_TILE             8       // in pixels
+
+// Types of commands
+//
+typedef enum{
+    RECORD_CLEAR = 0,       // dclear(colour)
+    RECORD_PIXEL,           // dpixel(x, y, colour)
+    RECORD_RECT,            // drect(x1, y1, x2, y2, colour)
+    RECORD_RECT_BORDER,     // drect_border(x1, y1, x2, y2, fill, width, border)
+    RECORD_LINE,            // dline(x1, y1, x2, y2, colour)
+    RECORD_CIRCLE,          // dcircle(x, y, r, fill, border)
+    RECORD_IMAGE,           // dimage(x, y, image)
+    RECORD_SUBIMAGE,        // dsubimage(x, y, image, left, top, w, h, flags)
+    RECORD_TEXT,            // dtext(x, y, fg, str)
+    RECORD_TEXT_OPT,        // dtext_opt(x, y, fg, bg, halign, valign, str, size)
+    RECORD_RAW,             // Direct access to the VRAM
+    RECORD_TYPES
+} RECORD_TYPE;
+
+#define RECORD_MAX_ARGS     7
+
+// A drawing command
+//
+typedef struct __recordCommand{
+    uint8_t type;               // RECORD_TYPE
+    uint8_t dropped;            // Pixels were already on the screen
+    uint8_t visible;            // Pixels were still on the screen at the end of the frame
+    int32_t args[RECORD_MAX_ARGS];  // Parameters in the order of the call (image and string excepted)
+    const void* image;
+    const char* str;            // Copy of the string
+    int16_t x1, y1, x2, y2;     // Pixels that may change (x2 < x1 if none)
+    uint32_t hash;
+} RECORD_COMMAND, * PRECORD_COMMAND;
+
+// Counters
+//
+typedef struct __recordStats{
+    uint32_t frames;            // # of calls to dupdate()
+    uint16_t recorded;          // Commands of the last frame
+    uint16_t executed;
+    uint16_t dropped;
+    uint32_t totalRecorded;     // Since the first frame
+    uint32_t totalDropped;
+} RECORD_STATS, * PRECORD_STATS;
+
+//  record_setMode() : Start or stop recording the commands
+//
+//  When recording is stopped, the commands are executed immediately.
+//  Recording is on by default
+//
+//  @on : 1 to record the commands
+//
+void record_setMode(int on);
+
+//  record_flush() : Execute the pending commands
+//
+//  Commands are still compared with the previous frame
+//
+void record_flush();
+
+//  record_raw() : Pixels of the VRAM will be accessed directly
+//
+//  The pending commands are executed first
+//
+//  @x, @y, @w, @h : Area that may change
+//
+void record_raw(int x, int y, int w, int h);
+
+//  record_frame() : Commands of the last frame
+//
+//  @count : # of commands
+//
+//  @return : pointer to the commands
+//
+const RECORD_COMMAND* record_frame(uint16_t* count);
+
+//  record_stats() : Counters
+//
+//  @return : pointer to the counters
+//
+const RECORD_STATS* record_stats();
+
+//
+// Recorded functions
+//
+
+void record_dclear(int colour);
+void record_dpixel(int x, int y, int colour);
+void record_drect(int x1, int y1, int x2, int y2, int colour);
+void record_drect_border(int x1, int y1, int x2, int y2, int fill, int width, int border);
+void record_dline(int x1, int y1, int x2, int y2, int colour);
+void record_dcircle(int x, int y, int r, int fill, int border);
+void record_dimage(int x, int y, bopti_image_t const* image);
+void record_dsubimage(int x, int y, bopti_image_t const* image, int left, int top, int w, int h, int flags);
+void record_dtext(int x, int y, int fg, char const* str);
+void record_dtext_opt(int x, int y, int fg, int bg, int halign, int valign, char const* str, int size);
+void record_dupdate();
+
+#if !defined(RENDER_INTERNAL) && !defined(RECORD_INTERNAL)
+#define dclear(colour)      record_dclear(colour)
+#define dpixel(x, y, colour)    record_dpixel(x, y, colour)
+#define drect(x1, y1, x2, y2, colour)   record_drect(x1, y1, x2, y2, colour)
+#define drect_border(x1, y1, x2, y2, fill, width, border)   record_drect_border(x1, y1, x2, y2, fill, width, border)
+#define dline(x1, y1, x2, y2, colour)   record_dline(x1, y1, x2, y2, colour)
+#define dcircle(x, y, r, fill, border)  record_dcircle(x, y, r, fill, border)
+#define dimage(x, y, image)     record_dimage(x, y, image)
+#define dsubimage(x, y, image, left, top, w, h, flags)  record_dsubimage(x, y, image, left, top, w, h, flags)
+#define dtext(x, y, fg, str)    record_dtext(x, y, fg, str)
+#define dtext_opt(x, y, fg, bg, halign, valign, str, size)  record_dtext_opt(x, y, fg, bg, halign, valign, str, size)
+#define dupdate()           record_dupdate()
+#endif // #if !defined(RENDER_INTERNAL) && !defined(RECORD_INTERNAL)
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_TOOLS_RECORD_h__
+
+// EOF
@@ -0,0 +1,636 @@
+//----------------------------------------------------------------------
+//--
+//--    render.c
+//--
+//--    Drawing primitives : gint on the calculator, an in-memory
+//--    framebuffer on Linux
+//--
+//----------------------------------------------------------------------
+
+#define RENDER_INTERNAL     // Not recorded (RENDER_RECORD)
+#include "render.h"
+
+#include <string.h>
+
+#ifndef DEST_CASIO_CALC
+#include <stdio.h>
+#include <stdlib.h>
+#include <png.h>
+
+// A glyph of the font
+//
+typedef struct __renderGlyph{
+    uint8_t width;                          // Advance in pixels
+    uint16_t rows[RENDER_FONT_HEIGHT];      // Bit 0 is the left pixel
+} RENDER_GLYPH;
+
+#define FONT_FIRST      ' '
+#define FONT_LAST       '~'
+#define FONT_UNKNOWN    '?'
+
+// DejaVu Sans 10 px, printable ASCII chars
+//
+static const RENDER_GLYPH _font[FONT_LAST - FONT_FIRST + 1] = {
+    { 3, {0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000}},   // space
+    { 4, {0x000, 0x004, 0x004, 0x004, 0x004, 0x004, 0x000, 0x004, 0x000, 0x000}},   // !
+    { 5, {0x000, 0x00A, 0x00A, 0x00A, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000}},   // "
+    { 8, {0x000, 0x048, 0x048, 0x0FC, 0x028, 0x07E, 0x024, 0x024, 0x000, 0x000}},   // #
+    { 6, {0x000, 0x008, 0x03C, 0x00A, 0x00E, 0x038, 0x028, 0x01E, 0x008, 0x000}},   // $
+    {10, {0x000, 0x04E, 0x04A, 0x02A, 0x1FE, 0x150, 0x148, 0x1C8, 0x000, 0x000}},   // %
+    { 8, {0x000, 0x018, 0x024, 0x004, 0x09A, 0x0A2, 0x066, 0x09C, 0x000, 0x000}},   // &
+    { 3, {0x000, 0x002, 0x002, 0x002, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000}},   // quote
+    { 4, {0x004, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x004, 0x000}},   // (
+    { 4, {0x002, 0x002, 0x004, 0x004, 0x004, 0x004, 0x004, 0x002, 0x002, 0x000}},   // )
+    { 5, {0x000, 0x015, 0x00E, 0x00E, 0x015, 0x000, 0x000, 0x000, 0x000, 0x000}},   // *
+    { 8, {0x000, 0x010, 0x010, 0x010, 0x0FE, 0x010, 0x010, 0x010, 0x000, 0x000}},   // +
+    { 3, {0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x002, 0x002, 0x000}},   // ,
+    { 4, {0x000, 0x000, 0x000, 0x000, 0x000, 0x00E, 0x000, 0x000, 0x000, 0x000}},   // -
+    { 3, {0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x002, 0x000, 0x000}},   // .
+    { 3, {0x000, 0x004, 0x004, 0x002, 0x002, 0x002, 0x002, 0x001, 0x001, 0x000}},   // /
+    { 6, {0x000, 0x01C, 0x022, 0x022, 0x022, 0x022, 0x022, 0x01C, 0x000, 0x000}},   // 0
+    { 6, {0x000, 0x00E, 0x008, 0x008, 0x008, 0x008, 0x008, 0x03E, 0x000, 0x000}},   // 1
+    { 6, {0x000, 0x01C, 0x022, 0x020, 0x010, 0x008, 0x004, 0x03E, 0x000, 0x000}},   // 2
+    { 6, {0x000, 0x01C, 0x022, 0x020, 0x01C, 0x020, 0x022, 0x01C, 0x000, 0x000}},   // 3
+    { 6, {0x000, 0x010, 0x018, 0x014, 0x012, 0x03E, 0x010, 0x010, 0x000, 0x000}},   // 4
+    { 6, {0x000, 0x01E, 0x002, 0x01E, 0x020, 0x020, 0x020, 0x01E, 0x000, 0x000}},   // 5
+    { 6, {0x000, 0x03C, 0x006, 0x002, 0x01E, 0x022, 0x022, 0x01C, 0x000, 0x000}},   // 6
+    { 6, {0x000, 0x03E, 0x020, 0x010, 0x010, 0x008, 0x008, 0x004, 0x000, 0x000}},   // 7
+    { 6, {0x000, 0x01C, 0x022, 0x022, 0x01C, 0x022, 0x022, 0x01C, 0x000, 0x000}},   // 8
+    { 6, {0x000, 0x01C, 0x022, 0x022, 0x03C, 0x020, 0x030, 0x01E, 0x000, 0x000}},   // 9
+    { 3, {0x000, 0x000, 0x000, 0x002, 0x000, 0x000, 0x000, 0x002, 0x000, 0x000}},   // :
+    { 3, {0x000, 0x000, 0x000, 0x002, 0x000, 0x000, 0x000, 0x002, 0x002, 0x000}},   // ;
+    { 8, {0x000, 0x000, 0x040, 0x038, 0x006, 0x038, 0x040, 0x000, 0x000, 0x000}},   // <
+    { 8, {0x000, 0x000, 0x000, 0x07E, 0x000, 0x07E, 0x000, 0x000, 0x000, 0x000}},   // =
+    { 8, {0x000, 0x000, 0x002, 0x01C, 0x060, 0x01C, 0x002, 0x000, 0x000, 0x000}},   // >
+    { 5, {0x000, 0x01E, 0x010, 0x008, 0x004, 0x004, 0x000, 0x004, 0x000, 0x000}},   // ?
+    {10, {0x000, 0x0F8, 0x10C, 0x206, 0x272, 0x352, 0x1F2, 0x006, 0x08C, 0x078}},   // @
+    { 7, {0x000, 0x008, 0x014, 0x014, 0x022, 0x03E, 0x022, 0x041, 0x000, 0x000}},   // A
+    { 7, {0x000, 0x01E, 0x022, 0x022, 0x01E, 0x022, 0x022, 0x01E, 0x000, 0x000}},   // B
+    { 7, {0x000, 0x038, 0x044, 0x002, 0x002, 0x002, 0x044, 0x038, 0x000, 0x000}},   // C
+    { 8, {0x000, 0x03E, 0x062, 0x042, 0x042, 0x042, 0x062, 0x03E, 0x000, 0x000}},   // D
+    { 6, {0x000, 0x03E, 0x002, 0x002, 0x03E, 0x002, 0x002, 0x03E, 0x000, 0x000}},   // E
+    { 6, {0x000, 0x01E, 0x002, 0x002, 0x01E, 0x002, 0x002, 0x002, 0x000, 0x000}},   // F
+    { 8, {0x000, 0x03C, 0x046, 0x002, 0x072, 0x042, 0x046, 0x03C, 0x000, 0x000}},   // G
+    { 8, {0x000, 0x042, 0x042, 0x042, 0x07E, 0x042, 0x042, 0x042, 0x000, 0x000}},   // H
+    { 3, {0x000, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x000, 0x000}},   // I
+    { 3, {0x000, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x001}},   // J
+    { 7, {0x000, 0x022, 0x012, 0x00A, 0x006, 0x00A, 0x012, 0x022, 0x000, 0x000}},   // K
+    { 6, {0x000, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x03E, 0x000, 0x000}},   // L
+    { 9, {0x000, 0x082, 0x0C6, 0x0C6, 0x0AA, 0x0AA, 0x092, 0x082, 0x000, 0x000}},   // M
+    { 7, {0x000, 0x042, 0x046, 0x04A, 0x04A, 0x052, 0x062, 0x042, 0x000, 0x000}},   // N
+    { 8, {0x000, 0x03C, 0x066, 0x042, 0x042, 0x042, 0x066, 0x03C, 0x000, 0x000}},   // O
+    { 6, {0x000, 0x01E, 0x022, 0x022, 0x01E, 0x002, 0x002, 0x002, 0x000, 0x000}},   // P
+    { 8, {0x000, 0x03C, 0x066, 0x042, 0x042, 0x042, 0x026, 0x01C, 0x020, 0x000}},   // Q
+    { 7, {0x000, 0x01E, 0x022, 0x022, 0x01E, 0x012, 0x022, 0x042, 0x000, 0x000}},   // R
+    { 6, {0x000, 0x01C, 0x022, 0x002, 0x01C, 0x020, 0x022, 0x01C, 0x000, 0x000}},   // S
+    { 6, {0x000, 0x01F, 0x004, 0x004, 0x004, 0x004, 0x004, 0x004, 0x000, 0x000}},   // T
+    { 7, {0x000, 0x042, 0x042, 0x042, 0x042, 0x042, 0x042, 0x03C, 0x000, 0x000}},   // U
+    { 7, {0x000, 0x020, 0x020, 0x011, 0x011, 0x00A, 0x00A, 0x004, 0x000, 0x000}},   // V
+    {10, {0x000, 0x111, 0x111, 0x0AA, 0x0AA, 0x0AA, 0x044, 0x044, 0x000, 0x000}},   // W
+    { 7, {0x000, 0x033, 0x012, 0x00C, 0x00C, 0x00C, 0x012, 0x033, 0x000, 0x000}},   // X
+    { 6, {0x000, 0x041, 0x022, 0x014, 0x008, 0x008, 0x008, 0x008, 0x000, 0x000}},   // Y
+    { 7, {0x000, 0x03F, 0x010, 0x008, 0x00C, 0x004, 0x002, 0x03F, 0x000, 0x000}},   // Z
+    { 4, {0x006, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x006, 0x000}},   // [
+    { 3, {0x000, 0x001, 0x001, 0x002, 0x002, 0x002, 0x002, 0x004, 0x004, 0x000}},   // backslash
+    { 4, {0x006, 0x004, 0x004, 0x004, 0x004, 0x004, 0x004, 0x004, 0x006, 0x000}},   // ]
+    { 8, {0x000, 0x018, 0x024, 0x042, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000}},   // ^
+    { 5, {0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x01F}},   // _
+    { 5, {0x002, 0x004, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000, 0x000}},   // `
+    { 6, {0x000, 0x000, 0x000, 0x01C, 0x020, 0x03C, 0x022, 0x03E, 0x000, 0x000}},   // a
+    { 6, {0x002, 0x002, 0x002, 0x01E, 0x022, 0x022, 0x022, 0x01E, 0x000, 0x000}},   // b
+    { 6, {0x000, 0x000, 0x000, 0x01C, 0x002, 0x002, 0x002, 0x01C, 0x000, 0x000}},   // c
+    { 6, {0x020, 0x020, 0x020, 0x03C, 0x022, 0x022, 0x022, 0x03C, 0x000, 0x000}},   // d
+    { 6, {0x000, 0x000, 0x000, 0x01C, 0x022, 0x03E, 0x002, 0x03C, 0x000, 0x000}},   // e
+    { 4, {0x01C, 0x004, 0x004, 0x00E, 0x004, 0x004, 0x004, 0x004, 0x000, 0x000}},   // f
+    { 6, {0x000, 0x000, 0x000, 0x03C, 0x022, 0x022, 0x022, 0x03C, 0x020, 0x01C}},   // g
+    { 6, {0x002, 0x002, 0x002, 0x01E, 0x022, 0x022, 0x022, 0x022, 0x000, 0x000}},   // h
+    { 3, {0x002, 0x000, 0x000, 0x002, 0x002, 0x002, 0x002, 0x002, 0x000, 0x000}},   // i
+    { 3, {0x002, 0x000, 0x000, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x003}},   // j
+    { 6, {0x002, 0x002, 0x002, 0x012, 0x00A, 0x006, 0x00A, 0x012, 0x000, 0x000}},   // k
+    { 3, {0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x000, 0x000}},   // l
+    {10, {0x000, 0x000, 0x000, 0x1DE, 0x222, 0x222, 0x222, 0x222, 0x000, 0x000}},   // m
+    { 6, {0x000, 0x000, 0x000, 0x01E, 0x022, 0x022, 0x022, 0x022, 0x000, 0x000}},   // n
+    { 6, {0x000, 0x000, 0x000, 0x01C, 0x022, 0x022, 0x022, 0x01C, 0x000, 0x000}},   // o
+    { 6, {0x000, 0x000, 0x000, 0x01E, 0x022, 0x022, 0x022, 0x01E, 0x002, 0x002}},   // p
+    { 6, {0x000, 0x000, 0x000, 0x03C, 0x022, 0x022, 0x022, 0x03C, 0x020, 0x020}},   // q
+    { 4, {0x000, 0x000, 0x000, 0x00E, 0x002, 0x002, 0x002, 0x002, 0x000, 0x000}},   // r
+    { 5, {0x000, 0x000, 0x000, 0x01E, 0x002, 0x01C, 0x010, 0x01E, 0x000, 0x000}},   // s
+    { 4, {0x000, 0x002, 0x002, 0x00F, 0x002, 0x002, 0x002, 0x00E, 0x000, 0x000}},   // t
+    { 6, {0x000, 0x000, 0x000, 0x022, 0x022, 0x022, 0x022, 0x03C, 0x000, 0x000}},   // u
+    { 6, {0x000, 0x000, 0x000, 0x022, 0x022, 0x014, 0x014, 0x008, 0x000, 0x000}},   // v
+    { 8, {0x000, 0x000, 0x000, 0x092, 0x0AA, 0x0AA, 0x044, 0x044, 0x000, 0x000}},   // w
+    { 6, {0x000, 0x000, 0x000, 0x022, 0x014, 0x008, 0x014, 0x022, 0x000, 0x000}},   // x
+    { 6, {0x000, 0x000, 0x000, 0x022, 0x022, 0x014, 0x014, 0x008, 0x008, 0x006}},   // y
+    { 5, {0x000, 0x000, 0x000, 0x01E, 0x010, 0x008, 0x004, 0x01E, 0x000, 0x000}},   // z
+    { 6, {0x018, 0x008, 0x008, 0x008, 0x006, 0x008, 0x008, 0x008, 0x018, 0x000}},   // {
+    { 3, {0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002, 0x002}},   // |
+    { 6, {0x006, 0x004, 0x004, 0x004, 0x018, 0x004, 0x004, 0x004, 0x006, 0x000}},   // }
+    { 8, {0x000, 0x000, 0x000, 0x04C, 0x032, 0x000, 0x000, 0x000, 0x000, 0x000}},   // ~
+};
+
+static uint16_t _vram[RENDER_WIDTH * RENDER_HEIGHT];
+static uint32_t _frames = 0;
+static const char* _output = NULL;
+
+static void _setPixel(int x, int y, int colour);
+static void _fillRect(int x1, int y1, int x2, int y2, int colour);
+static int _loadImage(bopti_image_t* image);
+static const RENDER_GLYPH* _glyph(const char** str);
+static int _savePixels(const char* file, int png);
+
+//
+// gint's functions
+//
+
+void dclear(int colour){
+    _fillRect(0, 0, RENDER_WIDTH - 1, RENDER_HEIGHT - 1, colour);
+}
+
+void dpixel(int x, int y, int colour){
+    _setPixel(x, y, colour);
+}
+
+void drect(int x1, int y1, int x2, int y2, int colour){
+    _fillRect(x1, y1, x2, y2, colour);
+}
+
+void drect_border(int x1, int y1, int x2, int y2, int fill, int width, int border){
+    int swap;
+
+    if (x1 > x2){
+        swap = x1; x1 = x2; x2 = swap;
+    }
+    if (y1 > y2){
+        swap = y1; y1 = y2; y2 = swap;
+    }
+
+    // Border (inside the rect)
+    _fillRect(x1, y1, x2, y1 + width - 1, border);
+    _fillRect(x1, y2 - width + 1, x2, y2, border);
+    y1 += width;
+    y2 -= width;
+    _fillRect(x1, y1, x1 + width - 1, y2, border);
+    _fillRect(x2 - width + 1, y1, x2, y2, border);
+    x1 += width;
+    x2 -= width;
+
+    if (x1 <= x2 && y1 <= y2){
+        _fillRect(x1, y1, x2, y2, fill);
+    }
+}
+
+void dline(int x1, int y1, int x2, int y2, int colour){
+    int dx = abs(x2 - x1), dy = -abs(y2 - y1);
+    int sx = (x1 < x2)?1:-1, sy = (y1 < y2)?1:-1;
+    int err = dx + dy, e2;
+
+    if (y1 == y2 || x1 == x2){
+        _fillRect(x1, y1, x2, y2, colour);
+        return;
+    }
+
+    // Bresenham
+    for (;;){
+        _setPixel(x1, y1, colour);
+        if (x1 == x2 && y1 == y2){
+            break;
+        }
+
+        e2 = 2 * err;
+        if (e2 >= dy){
+            err += dy;
+            x1 += sx;
+        }
+        if (e2 <= dx){
+            err += dx;
+            y1 += sy;
+        }
+    }
+}
+
+void dcircle(int x, int y, int r, int fill, int border){
+    int cx, cy, err;
+
+    if (r < 0){
+        return;
+    }
+
+    // Interior : one horizontal span per row
+    if (C_NONE != fill){
+        for (cy = -r; cy <= r; cy++){
+            for (cx = 0; (cx + 1) * (cx + 1) + cy * cy <= r * r; cx++);
+            _fillRect(x - cx, y + cy, x + cx, y + cy, fill);
+        }
+    }
+
+    // Midpoint algorithm
+    if (C_NONE != border){
+        cx = -r;
+        cy = 0;
+        err = 2 - 2 * r;
+        do{
+            _setPixel(x - cx, y + cy, border);
+            _setPixel(x - cy, y - cx, border);
+            _setPixel(x + cx, y - cy, border);
+            _setPixel(x + cy, y + cx, border);
+
+            r = err;
+            if (r <= cy){
+                err += ++cy * 2 + 1;
+            }
+            if (r > cx || err > cy){
+                err += ++cx * 2 + 1;
+            }
+        } while (cx < 0);
+    }
+}
+
+void dimage(int x, int y, bopti_image_t const* image){
+    if (image && _loadImage((bopti_image_t*)image)){
+        dsubimage(x, y, image, 0, 0, image->width, image->height, DIMAGE_NONE);
+    }
+}
+
+void dsubimage(int x, int y, bopti_image_t const* image, int left, int top, int w, int h, int flags){
+    const uint16_t* src;
+    uint16_t* dest;
+    int row, col;
+
+    (void)flags;
+    if (!image || !_loadImage((bopti_image_t*)image)){
+        return;
+    }
+
+    // Clip in the image ...
+    if (left < 0){
+        x -= left; w += left; left = 0;
+    }
+    if (top < 0){
+        y -= top; h += top; top = 0;
+    }
+    w = (left + w > image->width)?(image->width - left):w;
+    h = (top + h > image->height)?(image->height - top):h;
+
+    // ... and in the screen
+    if (x < 0){
+        left -= x; w += x; x = 0;
+    }
+    if (y < 0){
+        top -= y; h += y; y = 0;
+    }
+    w = (x + w > RENDER_WIDTH)?(RENDER_WIDTH - x):w;
+    h = (y + h > RENDER_HEIGHT)?(RENDER_HEIGHT - y):h;
+
+    for (row = 0; row < h; row++){
+        src = image->data + (top + row) * image->width + left;
+        dest = _vram + (y + row) * RENDER_WIDTH + x;
+        for (col = 0; col < w; col++, src++, dest++){
+            if (RENDER_ALPHA != *src){
+                *dest = *src;
+            }
+        }
+    }
+}
+
+void dtext(int x, int y, int fg, char const* str){
+    dtext_opt(x, y, fg, C_NONE, DTEXT_LEFT, DTEXT_TOP, str, -1);
+}
+
+void dtext_opt(int x, int y, int fg, int bg, int halign, int valign, char const* str, int size){
+    const RENDER_GLYPH* glyph;
+    const char* end;
+    int w, h, row, col;
+
+    if (!str){
+        return;
+    }
+
+    end = str + ((size < 0)?(int)strlen(str):size);
+    dsize(str, NULL, &w, &h);   // Whole string
+    if (size >= 0){
+        const char* next = str;
+        for (w = 0; next < end;){
+            w += _glyph(&next)->width;
+        }
+    }
+
+    x -= (DTEXT_CENTER == halign)?(w / 2):((DTEXT_RIGHT == halign)?(w - 1):0);
+    y -= (DTEXT_MIDDLE == valign)?(h / 2):((DTEXT_BOTTOM == valign)?(h - 1):0);
+
+    if (C_NONE != bg){
+        _fillRect(x, y, x + w - 1, y + h - 1, bg);
+    }
+
+    while (str < end){
+        glyph = _glyph(&str);
+        for (row = 0; row < RENDER_FONT_HEIGHT; row++){
+            for (col = 0; col < glyph->width; col++){
+                if (glyph->rows[row] & (1 << col)){
+                    _setPixel(x + col, y + row, fg);
+                }
+            }
+        }
+        x += glyph->width;
+    }
+}
+
+void dsize(char const* str, void const* font, int* w, int* h){
+    int width = 0;
+
+    (void)font;
+    while (str && *str){
+        width += _glyph(&str)->width;
+    }
+
+    if (w){
+        *w = width;
+    }
+    if (h){
+        *h = RENDER_FONT_HEIGHT;
+    }
+}
+
+void dupdate(){
+    char file[256];
+
+    _frames++;
+    if (_output){
+        snprintf(file, sizeof(file), _output, _frames);
+        _savePixels(file, NULL != strstr(file, ".png"));
+    }
+}
+
+//
+// Framebuffer
+//
+
+//  render_frames() : Count of frames
+//
+//  @return : # of calls to dupdate()
+//
+uint32_t render_frames(){
+    return _frames;
+}
+
+//  render_setOutput() : Save each new frame
+//
+//  @pattern : printf-like pattern of the files (with %u or %05u for the
+//              frame number), the extension gives the format (".png" or
+//              ".ppm"). NULL to stop saving frames
+//
+void render_setOutput(const char* pattern){
+    _output = pattern;
+}
+
+//  render_savePPM() : Save the framebuffer in a PPM (P6) file
+//
+//  @file : Name of the file
+//
+//  @return : 1 if done
+//
+int render_savePPM(const char* file){
+    return _savePixels(file, 0);
+}
+
+//  render_savePNG() : Save the framebuffer in a PNG file
+//
+//  @file : Name of the file
+//
+//  @return : 1 if done
+//
+int render_savePNG(const char* file){
+    return _savePixels(file, 1);
+}
+
+//
+// Internal functions
+//
+
+// _setPixel() : Change a pixel of the framebuffer
+//
+static void _setPixel(int x, int y, int colour){
+    if (x >= 0 && x < RENDER_WIDTH && y >= 0 && y < RENDER_HEIGHT && C_NONE != colour){
+        uint16_t* pixel = _vram + y * RENDER_WIDTH + x;
+        *pixel = (C_INVERT == colour)?(uint16_t)(*pixel ^ 0xFFFF):(uint16_t)colour;
+    }
+}
+
+// _fillRect() : Fill a clipped rectangle (corners are included)
+//
+static void _fillRect(int x1, int y1, int x2, int y2, int colour){
+    uint16_t* pixel;
+    int x, y, swap;
+
+    if (C_NONE == colour){
+        return;
+    }
+
+    if (x1 > x2){
+        swap = x1; x1 = x2; x2 = swap;
+    }
+    if (y1 > y2){
+        swap = y1; y1 = y2; y2 = swap;
+    }
+
+    x1 = (x1 < 0)?0:x1;
+    y1 = (y1 < 0)?0:y1;
+    x2 = (x2 >= RENDER_WIDTH)?(RENDER_WIDTH - 1):x2;
+    y2 = (y2 >= RENDER_HEIGHT)?(RENDER_HEIGHT - 1):y2;
+
+    for (y = y1; y <= y2; y++){
+        pixel = _vram + y * RENDER_WIDTH + x1;
+        for (x = x1; x <= x2; x++, pixel++){
+            *pixel = (C_INVERT == colour)?(uint16_t)(*pixel ^ 0xFFFF):(uint16_t)colour;
+        }
+    }
+}
+
+// _loadImage() : Read the PNG file of an image (once)
+//
+//  Pixels are converted as fxconv does : RGB888 values are truncated
+//  and transparent pixels use the RENDER_ALPHA value
+//
+//  @return : 1 if the image can be drawn
+//
+static int _loadImage(bopti_image_t* image){
+    png_image png;
+    uint8_t* rgba, * src;
+    uint16_t* dest;
+    int id;
+
+    if (image->data){
+        return 1;
+    }
+
+    memset(&png, 0, sizeof(png));
+    png.version = PNG_IMAGE_VERSION;
+    if (!image->file || !png_image_begin_read_from_file(&png, image->file)){
+        return 0;
+    }
+
+    png.format = PNG_FORMAT_RGBA;
+    if (!(rgba = (uint8_t*)malloc(PNG_IMAGE_SIZE(png))) ||
+        !(image->data = (uint16_t*)malloc(png.width * png.height * sizeof(uint16_t)))){
+        free(rgba);
+        png_image_free(&png);
+        return 0;
+    }
+
+    if (!png_image_finish_read(&png, NULL, rgba, 0, NULL)){
+        free(rgba);
+        free(image->data);
+        image->data = NULL;
+        return 0;
+    }
+
+    image->width = png.width;
+    image->height = png.height;
+    for (id = 0, src = rgba, dest = image->data; id < image->width * image->height; id++, src += 4, dest++){
+        if (src[3] < 0x80){
+            *dest = RENDER_ALPHA;
+        }
+        else{
+            *dest = (uint16_t)(((src[0] >> 3) << 11) | ((src[1] >> 2) << 5) | (src[2] >> 3));
+            if (RENDER_ALPHA == *dest){
+                *dest = 0;      // Not transparent
+            }
+        }
+    }
+
+    free(rgba);
+    return 1;
+}
+
+// _glyph() : Glyph of the next char of a string
+//
+//  Chars out of the font (and UTF-8 sequences) are shown as FONT_UNKNOWN
+//
+static const RENDER_GLYPH* _glyph(const char** str){
+    uint8_t car = (uint8_t)*(*str)++;
+
+    if (car >= 0x80){
+        while (0x80 == ((uint8_t)**str & 0xC0)){
+            (*str)++;   // Continuation bytes
+        }
+        car = FONT_UNKNOWN;
+    }
+    else if (car < FONT_FIRST || car > FONT_LAST){
+        car = FONT_UNKNOWN;
+    }
+
+    return _font + (car - FONT_FIRST);
+}
+
+// _savePixels() : Save the framebuffer as RGB888
+//
+static int _savePixels(const char* file, int png){
+    uint8_t rgb[RENDER_WIDTH * RENDER_HEIGHT * 3], * dest = rgb;
+    const uint16_t* pixel = _vram;
+    int id, done;
+
+    // Expand the 5 and 6 bits values
+    for (id = 0; id < RENDER_WIDTH * RENDER_HEIGHT; id++, pixel++){
+        *dest++ = (uint8_t)(((*pixel >> 11) & 0x1F) * 255 / 31);
+        *dest++ = (uint8_t)(((*pixel >> 5) & 0x3F) * 255 / 63);
+        *dest++ = (uint8_t)((*pixel & 0x1F) * 255 / 31);
+    }
+
+    if (png){
+        png_image image;
+        memset(&image, 0, sizeof(image));
+        image.version = PNG_IMAGE_VERSION;
+        image.width = RENDER_WIDTH;
+        image.height = RENDER_HEIGHT;
+        image.format = PNG_FORMAT_RGB;
+        return png_image_write_to_file(&image, file, 0, rgb, 0, NULL)?1:0;
+    }
+    else{
+        FILE* out = fopen(file, "wb");
+        if (!out){
+            return 0;
+        }
+
+        fprintf(out, "P6\n%d %d\n255\n", RENDER_WIDTH, RENDER_HEIGHT);
+        done = (1 == fwrite(rgb, sizeof(rgb), 1, out));
+        fclose(out);
+        return done;
+    }
+}
+
+#endif // #ifndef DEST_CASIO_CALC
+
+//
+// Both targets
+//
+
+//  render_vram() : Pixels of the screen (VRAM)
+//
+//  @return : pointer to the RENDER_WIDTH * RENDER_HEIGHT pixels
+//
+uint16_t* render_vram(){
+#ifdef RENDER_RECORD
+    record_raw(0, 0, RENDER_WIDTH, RENDER_HEIGHT);
+#endif // #ifdef RENDER_RECORD
+
+#ifdef DEST_CASIO_CALC
+    return gint_vram;
+#else
+    return _vram;
+#endif // #ifdef DEST_CASIO_CALC
+}
+
+//  render_scroll() : Move the pixels of a rectangle
+//
+//  Pixels are moved inside the rectangle : the uncovered part keeps
+//  its previous content and has to be drawn again
+//
+//  @x, @y, @w, @h : Rectangle
+//  @dx, @dy : Translation in pixels
+//
+void render_scroll(int x, int y, int w, int h, int dx, int dy){
+#ifdef DEST_CASIO_CALC
+    uint16_t* vram = gint_vram;
+#else
+    uint16_t* vram = _vram;
+#endif // #ifdef DEST_CASIO_CALC
+    int row, first, last, step, len;
+
+    // Clipping
+    if (x < 0){
+        w += x; x = 0;
+    }
+    if (y < 0){
+        h += y; y = 0;
+    }
+    w = (x + w > RENDER_WIDTH)?(RENDER_WIDTH - x):w;
+    h = (y + h > RENDER_HEIGHT)?(RENDER_HEIGHT - y):h;
+
+    len = w - ((dx < 0)?-dx:dx);    // pixels of a row
+    if (len <= 0 || h - ((dy < 0)?-dy:dy) <= 0){
+        return;     // Nothing left in the rectangle
+    }
+
+#ifdef RENDER_RECORD
+    record_raw(x, y, w, h);
+#endif // #ifdef RENDER_RECORD
+
+    // Destination rows, in an order that doesn't overwrite the source
+    if (dy > 0){
+        first = y + h - 1;
+        last = y + dy - 1;
+        step = -1;
+    }
+    else{
+        first = y;
+        last = y + h + dy;
+        step = 1;
+    }
+
+    for (row = first; row != last; row += step){
+        memmove(vram + row * RENDER_WIDTH + x + ((dx > 0)?dx:0),
+                vram + (row - dy) * RENDER_WIDTH + x + ((dx < 0)?-dx:0),
+                len * sizeof(uint16_t));
+    }
+}
+
+// EOF
@@ -0,0 +1,186 @@
+//----------------------------------------------------------------------
+//--
+//--    render.h
+//--
+//--    Drawing primitives : gint on the calculator, an in-memory
+//--    framebuffer on Linux
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_TOOLS_RENDER_h__
+#define __GEE_TOOLS_RENDER_h__    1
+
+//
+// The drawing code uses the gint API on both targets. On the calculator
+// this file includes gint's header and only adds direct access to the
+// VRAM.
+//
+// On Linux the same functions draw in a RGB565 framebuffer of
+// RENDER_WIDTH x RENDER_HEIGHT pixels with the same colour values as
+// gint's VRAM. Images are read from the PNG files of the assets the
+// first time they are drawn and each dupdate() can save the frame in a
+// PNG or a PPM file. Text uses a built-in proportional font : only the
+// text can't be compared pixel by pixel with the calculator.
+//
+// With RENDER_RECORD, the drawing functions are recorded and executed
+// by dupdate() (see record.h). In debug mode, they are counted for each
+// frame (see frameStats.h).
+//
+
+#ifdef DEST_CASIO_CALC
+#include <gint/display.h>
+
+#define RENDER_WIDTH    DWIDTH
+#define RENDER_HEIGHT   DHEIGHT
+#else
+#include <stdint.h>
+
+// fx-CG50 screen
+#define RENDER_WIDTH    396
+#define RENDER_HEIGHT   224
+
+#ifndef RENDER_ASSETS_DIR
+#define RENDER_ASSETS_DIR   "../assets-cg/"
+#endif // #ifndef RENDER_ASSETS_DIR
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+// Colours (RGB565 as in gint)
+//
+typedef uint16_t color_t;
+
+#define C_RGB(r,g,b)    (((r) << 11) | ((g) << 6) | (b))    // 5 bits values
+
+#define C_WHITE         0xFFFF
+#define C_LIGHT         0xAD55
+#define C_DARK          0x528A
+#define C_BLACK         0x0000
+#define C_NONE          -1
+#define C_INVERT        -2
+
+// Transparent pixels of the images
+#define RENDER_ALPHA    0x0001
+
+// Images
+//
+#define DIMAGE_NONE     0x00
+#define DIMAGE_NOCLIP   0x01    // Ignored : images are always clipped
+
+typedef struct __renderImage{
+    const char* file;       // PNG file
+    int width, height;
+    uint16_t* data;         // RGB565 pixels (NULL until loaded)
+} bopti_image_t;
+
+// Declaration of an image from the assets folder
+#define RENDER_IMAGE(name)  {RENDER_ASSETS_DIR name, 0, 0, NULL}
+
+// Text alignment
+//
+#define DTEXT_LEFT      0
+#define DTEXT_CENTER    1
+#define DTEXT_RIGHT     2
+#define DTEXT_TOP       0
+#define DTEXT_MIDDLE    1
+#define DTEXT_BOTTOM    2
+
+#define RENDER_FONT_HEIGHT  10
+
+//
+// gint's functions
+//
+
+void dclear(int colour);
+void dpixel(int x, int y, int colour);
+void drect(int x1, int y1, int x2, int y2, int colour);
+void drect_border(int x1, int y1, int x2, int y2, int fill, int width, int border);
+void dline(int x1, int y1, int x2, int y2, int colour);
+void dcircle(int x, int y, int r, int fill, int border);
+void dimage(int x, int y, bopti_image_t const* image);
+void dsubimage(int x, int y, bopti_image_t const* image, int left, int top, int w, int h, int flags);
+void dtext(int x, int y, int fg, char const* str);
+void dtext_opt(int x, int y, int fg, int bg, int halign, int valign, char const* str, int size);
+void dsize(char const* str, void const* font, int* w, int* h);
+void dupdate();
+
+//
+// Framebuffer
+//
+
+//  render_frames() : Count of frames
+//
+//  @return : # of calls to dupdate()
+//
+uint32_t render_frames();
+
+//  render_setOutput() : Save each new frame
+//
+//  @pattern : printf-like pattern of the files (with %u or %05u for the
+//              frame number), the extension gives the format (".png" or
+//              ".ppm"). NULL to stop saving frames
+//
+void render_setOutput(const char* pattern);
+
+//  render_savePPM() : Save the framebuffer in a PPM (P6) file
+//
+//  @file : Name of the file
+//
+//  @return : 1 if done
+//
+int render_savePPM(const char* file);
+
+//  render_savePNG() : Save the framebuffer in a PNG file
+//
+//  @file : Name of the file
+//
+//  @return : 1 if done
+//
+int render_savePNG(const char* file);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifdef DEST_CASIO_CALC
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// Both targets
+//
+
+//  render_vram() : Pixels of the screen (VRAM)
+//
+//  @return : pointer to the RENDER_WIDTH * RENDER_HEIGHT pixels
+//
+uint16_t* render_vram();
+
+//  render_scroll() : Move the pixels of a rectangle
+//
+//  Pixels are moved inside the rectangle : the uncovered part keeps
+//  its previous content and has to be drawn again
+//
+//  @x, @y, @w, @h : Rectangle
+//  @dx, @dy : Translation in pixels
+//
+void render_scroll(int x, int y, int w, int h, int dx, int dy);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#ifdef RENDER_RECORD
+#include "record.h"     // Drawing functions are recorded
+#endif // #ifdef RENDER_RECORD
+
+#ifdef _DEBUG_
+#include "frameStats.h" // Drawing functions are counted
+#endif // #ifdef _DEBUG_
+
+#endif // #ifndef __GEE_TOOLS_RENDER_h__
+
+// EOF
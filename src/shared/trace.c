@@ -0,0 +1,212 @@
+//---------------------------------------------------------------------------
+//--
+//--	trace.c
+//--
+//--        Events kept in memory (TRACE_MODE)
+//--
+//---------------------------------------------------------------------------
+
+#include "trace.h"
+
+#ifdef TRACE_MODE
+
+#include <string.h>
+
+#ifdef DEST_CASIO_CALC
+#include "chrono.h"
+#include "keys.h"
+
+// Viewer
+#define TRACE_TITLE_Y       5
+#define TRACE_TOP           25
+#define TRACE_HEIGHT        16
+#define TRACE_LINES         12      // Events by page
+#define TRACE_COL_TIME      70      // Right of the time
+#define TRACE_COL_NAME      80
+#define TRACE_COL_ARG1      300     // Right of the values
+#define TRACE_COL_ARG2      380
+
+static CHRONO _chrono;
+#else
+#include <stdio.h>
+#include <time.h>
+#endif // #ifdef DEST_CASIO_CALC
+
+static TRACE_EVENT _events[TRACE_SIZE];
+static uint32_t _total = 0;     // # of events added
+
+static uint32_t _clock();
+static const char* _name(uint16_t id, const char* const* names, uint16_t count, char* buffer);
+
+//  trace_add() : Add an event
+//
+//  @id : ID of the event
+//  @arg1, @arg2 : Values
+//
+void trace_add(uint16_t id, int32_t arg1, int32_t arg2){
+    PTRACE_EVENT event = _events + (_total++ & (TRACE_SIZE - 1));
+    event->time = _clock();
+    event->id = id;
+    event->args[0] = arg1;
+    event->args[1] = arg2;
+}
+
+//  trace_count() : Events in the buffer
+//
+//  @lost : Pointer to the # of events overwritten (can be NULL)
+//
+//  @return : # of events
+//
+uint16_t trace_count(uint32_t* lost){
+    uint16_t count = (_total < TRACE_SIZE)?(uint16_t)_total:TRACE_SIZE;
+    if (lost){
+        *lost = _total - count;
+    }
+    return count;
+}
+
+//  trace_event() : An event of the buffer
+//
+//  @index : Index of the event, 0 for the oldest
+//
+//  @return : Pointer to the event or NULL
+//
+const TRACE_EVENT* trace_event(uint16_t index){
+    uint32_t lost;
+    if (index >= trace_count(&lost)){
+        return NULL;
+    }
+    return _events + ((lost + index) & (TRACE_SIZE - 1));
+}
+
+//  trace_clear() : Remove all the events
+//
+void trace_clear(){
+    _total = 0;
+}
+
+#ifdef DEST_CASIO_CALC
+//  trace_show() : Show the events until [EXIT] is pressed
+//
+//  [UP] and [DOWN] change the page, the last events are shown first
+//
+//  @names : Names of the events (by ID)
+//  @count : # of names
+//
+void trace_show(const char* const* names, uint16_t count){
+    const TRACE_EVENT* event;
+    char line[64], value[16];
+    uint16_t events, first, index;
+    uint32_t lost;
+    uint car = KEY_NONE;
+    int y;
+
+    // The events added while the viewer is open are not shown
+    events = trace_count(&lost);
+    first = (events > TRACE_LINES)?(events - TRACE_LINES):0;
+
+    do{
+        switch (car){
+            case KEY_UP:
+                first = (first > TRACE_LINES)?(first - TRACE_LINES):0;
+                break;
+
+            case KEY_DOWN:
+                if (first + TRACE_LINES < events){
+                    first += TRACE_LINES;
+                }
+                break;
+
+            default:
+                break;
+        }
+
+        dclear(C_WHITE);
+
+        strcpy(line, "Trace : ");
+        strcat(line, __itoa(events, FALSE, value));
+        strcat(line, " events - ");
+        strcat(line, __itoa((int)lost, FALSE, value));
+        strcat(line, " lost");
+        dtext(TRACE_COL_NAME, TRACE_TITLE_Y, COLOUR_BLACK, line);
+
+        y = TRACE_TOP;
+        for (index = first; index < first + TRACE_LINES && (event = trace_event(index)); index++){
+            dtext_opt(TRACE_COL_TIME, y, COLOUR_BLUE, C_NONE, DTEXT_RIGHT, DTEXT_TOP, __itoa((int)event->time, FALSE, value), -1);
+            dtext(TRACE_COL_NAME, y, COLOUR_BLACK, _name(event->id, names, count, value));
+            dtext_opt(TRACE_COL_ARG1, y, COLOUR_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, __itoa(event->args[0], FALSE, value), -1);
+            dtext_opt(TRACE_COL_ARG2, y, COLOUR_BLACK, C_NONE, DTEXT_RIGHT, DTEXT_TOP, __itoa(event->args[1], FALSE, value), -1);
+            y += TRACE_HEIGHT;
+        }
+
+        dupdate();
+    } while (KEY_EXIT != (car = getKey()));
+}
+#else
+//  trace_dump() : Write the events (oldest first)
+//
+//  @file : Name of the file, NULL for stdout
+//  @names : Names of the events (by ID)
+//  @count : # of names
+//
+//  @return : TRUE if done
+//
+BOOL trace_dump(const char* file, const char* const* names, uint16_t count){
+    const TRACE_EVENT* event;
+    char buffer[16];
+    uint16_t index, events;
+    uint32_t lost;
+    FILE* out = file?fopen(file, "w"):stdout;
+
+    if (!out){
+        return FALSE;
+    }
+
+    events = trace_count(&lost);
+    fprintf(out, "%u events - %u lost\n", events, lost);
+    for (index = 0; (event = trace_event(index)); index++){
+        fprintf(out, "%10u %-12s %10d %10d\n", event->time,
+                _name(event->id, names, count, buffer), event->args[0], event->args[1]);
+    }
+
+    if (file){
+        fclose(out);
+    }
+    return TRUE;
+}
+#endif // #ifdef DEST_CASIO_CALC
+
+//
+// Internal functions
+//
+
+// _clock() : Current time (ms on the calculator, µs on Linux)
+//
+static uint32_t _clock(){
+#ifdef DEST_CASIO_CALC
+    if (!_chrono.running){
+        chrono_start(&_chrono);
+    }
+    return chrono_ms(&_chrono);
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000 + now.tv_nsec / 1000);
+#endif // #ifdef DEST_CASIO_CALC
+}
+
+// _name() : Name of an event, its ID if unknown
+//
+static const char* _name(uint16_t id, const char* const* names, uint16_t count, char* buffer){
+    if (names && id < count){
+        return names[id];
+    }
+
+    buffer[0] = '#';
+    __itoa(id, FALSE, buffer + 1);
+    return buffer;
+}
+
+#endif // #ifdef TRACE_MODE
+
+// EOF
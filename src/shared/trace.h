@@ -2,42 +2,103 @@
 //--
 //--	trace.h
 //--
+//--        Events kept in memory (TRACE_MODE)
+//--
 //---------------------------------------------------------------------------
 
 #ifndef __GEE_TRACE_h__
 #define __GEE_TRACE_h__    1
 
-#ifdef DEST_CASIO_CALC
+#include "casioCalcs.h"
+
+//
+// TRACE() adds an event (timestamp, ID and two values) in a ring buffer
+// of TRACE_SIZE events : nothing is drawn nor formatted, the oldest
+// events are overwritten. The IDs and their names are defined by the
+// application.
+//
+// The events are shown on the calculator by trace_show() and written by
+// trace_dump() on Linux. The time is in ms on the calculator and in µs
+// on Linux.
+//
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
 
 #ifdef TRACE_MODE
-#ifdef FX9860G
-#define TRACE_POS_X     (CASIO_WIDTH - 40)
-#define TRACE_POS_Y     5 // (CASIO_HEIGHT - 20)
-#define TRACE_WIDTH     100
-#define TRACE_HEIGHT    12
+
+#define TRACE_SIZE      256     // Events in the buffer (power of 2)
+
+// An event
+//
+typedef struct __traceEvent{
+    uint32_t time;
+    uint16_t id;
+    int32_t args[2];
+} TRACE_EVENT, * PTRACE_EVENT;
+
+//  trace_add() : Add an event
+//
+//  @id : ID of the event
+//  @arg1, @arg2 : Values
+//
+void trace_add(uint16_t id, int32_t arg1, int32_t arg2);
+
+//  trace_count() : Events in the buffer
+//
+//  @lost : Pointer to the # of events overwritten (can be NULL)
+//
+//  @return : # of events
+//
+uint16_t trace_count(uint32_t* lost);
+
+//  trace_event() : An event of the buffer
+//
+//  @index : Index of the event, 0 for the oldest
+//
+//  @return : Pointer to the event or NULL
+//
+const TRACE_EVENT* trace_event(uint16_t index);
+
+//  trace_clear() : Remove all the events
+//
+void trace_clear();
+
+#ifdef DEST_CASIO_CALC
+//  trace_show() : Show the events until [EXIT] is pressed
+//
+//  [UP] and [DOWN] change the page, the last events are shown first
+//
+//  @names : Names of the events (by ID)
+//  @count : # of names
+//
+void trace_show(const char* const* names, uint16_t count);
 #else
-#define TRACE_POS_X     (CASIO_WIDTH - 140)
-#define TRACE_POS_Y     (CASIO_HEIGHT - 60)
-#define TRACE_WIDTH     100
-#define TRACE_HEIGHT    15
-#endif // #ifdef FX9860G
+//  trace_dump() : Write the events (oldest first)
+//
+//  @file : Name of the file, NULL for stdout
+//  @names : Names of the events (by ID)
+//  @count : # of names
+//
+//  @return : TRUE if done
+//
+BOOL trace_dump(const char* file, const char* const* names, uint16_t count);
+#endif // #ifdef DEST_CASIO_CALC
 
-// TRACE : add a line of text in the screen
+// TRACE : add an event
 //
-//  @val : text to display
-//  @tCol : text colour
-//  @bkCol : Background colour
+//  @id : ID of the event
+//  @arg1, @arg2 : Values
 //
-#define TRACE(val, tCol, bkCol)      { if (NO_COLOR != bkCol) drect(TRACE_POS_X, TRACE_POS_Y, TRACE_POS_X + TRACE_WIDTH - 1, TRACE_POS_Y + TRACE_HEIGHT -1, bkCol);dtext(TRACE_POS_X, TRACE_POS_Y, tCol, val);dupdate();}
-#define TRACE_DEF(val)                   TRACE(val, COLOUR_BLACK, NO_COLOR);
-#define TRACE_WAIT(val, tCol, bkCol) {TRACE(val, tCol, bkCol); key_event_t evt; do { evt = pollevent();} while(evt.type != KEYEV_DOWN && evt.key != KEY_EXE);}
+#define TRACE(id, arg1, arg2)   trace_add((uint16_t)(id), (int32_t)(arg1), (int32_t)(arg2))
 #else
-#define TRACE(val, tCol, tbk)      {}
-#define TRACE_WAIT(val, tCol, tbk)      {}
-#define TRACE_DEF(val) {}
+#define TRACE(id, arg1, arg2)   {}
 #endif // #ifdef TRACE_MODE
 
-#endif // #ifdef DEST_CASIO_CALC
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
 
 #endif // __GEE_TRACE_h__
 
@@ -0,0 +1,717 @@
+//----------------------------------------------------------------------
+//--
+//--    solver.c
+//--
+//--            Linear constraints solver for a game grid
+//--
+//----------------------------------------------------------------------
+
+#include "solver.h"
+
+#include <string.h>
+
+// Internal helpers
+//
+
+#define _ROW(bits, solver, row)     (&(bits)[(row) * (solver)->words])
+#define _WORD_ID(var)               ((var) / SOLVER_WORD_BITS)
+#define _WORD_BIT(var)              ((SOLVER_WORD)1 << ((var) % SOLVER_WORD_BITS))
+
+static void _freeRows(PSOLVER const solver);
+static BOOL _allocRows(PSOLVER const solver);
+static void _scanRow(PSOLVER const solver, uint8_t r, BOOL fill);
+static void _reduceVar(PSOLVER const solver, uint16_t var);
+static uint16_t _extractRow(PSOLVER const solver, uint16_t row);
+static BOOL _combineRows(PSOLVER const solver, uint16_t dest, uint16_t src, BOOL add);
+static void _setBox(PSOLVER const solver, uint16_t var, uint8_t status);
+static uint16_t _countBits(SOLVER_WORD const* bits, uint16_t words);
+
+//  solver_create() : Create an empty solver
+//
+//  @return : pointer to the new solver or NULL
+//
+PSOLVER solver_create(){
+    size_t size = sizeof(SOLVER);
+    PSOLVER solver = (PSOLVER)malloc(size);
+    if (solver){
+        memset(solver, 0, size);
+    }
+    return solver;
+}
+
+//  solver_init() : Attach the solver to a new grid
+//
+//  Previous results are lost
+//
+//  @solver : Pointer to the solver
+//  @grid : Grid to analyse (only boxes states are used)
+//
+//  @return : TRUE if done
+//
+BOOL solver_init(PSOLVER const solver, PGRID const grid){
+    if (!solver || !grid || !grid->boxes){
+        return FALSE;
+    }
+
+    solver_free(solver, FALSE);     // Clear previous grid
+    solver->grid = grid;
+    solver->boxCount = grid->size.col * grid->size.row;
+
+    solver->boxVars = (int16_t*)malloc(solver->boxCount * sizeof(int16_t));
+    solver->vars = (uint16_t*)malloc(solver->boxCount * sizeof(uint16_t));
+    solver->boxes = (uint8_t*)malloc(solver->boxCount);
+    if (!solver->boxVars || !solver->vars || !solver->boxes){
+        solver_free(solver, FALSE);
+        return FALSE;
+    }
+
+    memset(solver->boxes, SOLVER_UNKNOWN, solver->boxCount);
+    solver_update(solver);
+    return TRUE;
+}
+
+//  solver_update() : The grid has changed
+//
+//  The system will be rebuilt by the next step. Boxes already solved
+//  are kept
+//
+//  @solver : Pointer to the solver
+//
+void solver_update(PSOLVER const solver){
+    if (solver && solver->grid){
+        solver->state = SOLVER_SCAN;
+        solver->cursor = 0;
+    }
+}
+
+//  solver_stepEx() : Run the solver for a limited amount of work
+//
+//  @solver : Pointer to the solver
+//  @budget : Max. count of work units (SOLVER_NO_LIMIT to run until done)
+//
+//  @return : TRUE if results are up to date
+//
+BOOL solver_stepEx(PSOLVER const solver, uint16_t budget){
+    if (!solver || !solver->grid){
+        return TRUE;
+    }
+
+    while (budget && SOLVER_IDLE != solver->state){
+        switch (solver->state){
+            // Frontier : covered boxes next to a revealed number
+            case SOLVER_SCAN:
+                if (0 == solver->cursor){
+                    _freeRows(solver);
+                    for (uint16_t id = 0; id < solver->boxCount; id++){
+                        solver->boxVars[id] = -1;
+                    }
+                }
+
+                _scanRow(solver, solver->cursor++, FALSE);
+
+                if (solver->cursor == solver->grid->size.row){
+                    if (solver->rowCount && _allocRows(solver)){
+                        solver->state = SOLVER_BUILD;
+                        solver->pivot = 0;  // first row to fill
+                    }
+                    else{
+                        solver->state = SOLVER_IDLE;    // Nothing to solve
+                    }
+                    solver->cursor = 0;
+                }
+                break;
+
+            // Fill the rows
+            case SOLVER_BUILD:
+                _scanRow(solver, solver->cursor++, TRUE);
+
+                if (solver->cursor == solver->grid->size.row){
+                    solver->state = SOLVER_EXTRACT;
+                    solver->cursor = 0;
+                    solver->pass = 0;
+                    solver->found = 0;
+                }
+                break;
+
+            case SOLVER_EXTRACT:
+                solver->found += _extractRow(solver, solver->cursor++);
+
+                if (solver->cursor == solver->rowCount){
+                    // Simple rules (pass 0) are always followed by a reduction
+                    if (0 == solver->pass ||
+                        (solver->found && solver->pass < SOLVER_MAX_PASSES)){
+                        solver->state = SOLVER_REDUCE;
+                        solver->pivot = 0;
+                        solver->pass++;
+                    }
+                    else{
+                        solver->state = SOLVER_IDLE;
+                    }
+
+                    solver->cursor = 0;
+                    solver->found = 0;
+                }
+                break;
+
+            case SOLVER_REDUCE:
+                if (solver->cursor < solver->varCount && solver->pivot < solver->rowCount){
+                    _reduceVar(solver, solver->cursor++);
+                }
+                else{
+                    solver->state = SOLVER_EXTRACT;
+                    solver->cursor = 0;
+                }
+                break;
+
+            default:
+                solver->state = SOLVER_IDLE;
+                break;
+        }
+
+        if (SOLVER_NO_LIMIT != budget){
+            budget--;
+        }
+    }
+
+    return (SOLVER_IDLE == solver->state);
+}
+
+//  solver_solve() : Run the solver until results are up to date
+//
+//  @solver : Pointer to the solver
+//
+//  @return : count of solved boxes in the grid
+//
+uint16_t solver_solve(PSOLVER const solver){
+    uint16_t count = 0;
+
+    if (solver && solver->boxes){
+        solver_stepEx(solver, SOLVER_NO_LIMIT);
+
+        for (uint16_t id = 0; id < solver->boxCount; id++){
+            if (SOLVER_UNKNOWN != solver->boxes[id]){
+                count++;
+            }
+        }
+    }
+
+    return count;
+}
+
+//  solver_reduce() : Gaussian elimination of the system
+//
+//  @solver : Pointer to the solver
+//
+void solver_reduce(PSOLVER const solver){
+    if (solver && solver->rowCount){
+        solver->pivot = 0;
+        for (uint16_t var = 0; var < solver->varCount && solver->pivot < solver->rowCount; var++){
+            _reduceVar(solver, var);
+        }
+    }
+}
+
+//  solver_extract() : Find forced boxes in the rows of the system
+//
+//  Forced boxes are removed from the system
+//
+//  @solver : Pointer to the solver
+//
+//  @return : count of new boxes found
+//
+uint16_t solver_extract(PSOLVER const solver){
+    uint16_t found = 0;
+
+    if (solver){
+        for (uint16_t row = 0; row < solver->rowCount; row++){
+            found += _extractRow(solver, row);
+        }
+    }
+
+    return found;
+}
+
+//  solver_getBox() : Status of a box
+//
+//  @solver : Pointer to the solver
+//  @pos : Position of the box
+//
+//  @return : SOLVER_UNKNOWN, SOLVER_SAFE or SOLVER_MINE
+//
+uint8_t solver_getBox(PSOLVER const solver, PCOORD const pos){
+    if (!solver || !solver->boxes ||
+        pos->col >= solver->grid->size.col || pos->row >= solver->grid->size.row){
+        return SOLVER_UNKNOWN;
+    }
+
+    return solver->boxes[pos->row * solver->grid->size.col + pos->col];
+}
+
+//  solver_getHint() : Get a box to step on
+//
+//  A covered box known to be safe or, if none, the covered box with
+//  the lowest estimated risk
+//
+//  @solver : Pointer to the solver
+//  @pos : Position of the box
+//
+//  @return : SOLVER_SAFE if the box is safe, SOLVER_UNKNOWN if it's a guess
+//            and SOLVER_MINE if no box can be found
+//
+uint8_t solver_getHint(PSOLVER const solver, PCOORD const pos){
+    uint16_t id, unknown = 0, risk, minRisk = SOLVER_RISK_MAX + 1, defRisk;
+    int16_t minesLeft;
+    uint8_t r, c;
+    PGRID grid;
+    PBOX box;
+
+    if (!solver || !solver->boxes || !pos){
+        return SOLVER_MINE;
+    }
+
+    // A safe box ?
+    grid = solver->grid;
+    minesLeft = grid->mines;
+    for (id = 0; id < solver->boxCount; id++){
+        box = &grid->boxes[id];
+        if (BOX_IS_COVERED(box)){
+            switch (solver->boxes[id]){
+                case SOLVER_SAFE:
+                    pos->row = id / grid->size.col;
+                    pos->col = id % grid->size.col;
+                    return SOLVER_SAFE;
+
+                case SOLVER_MINE:
+                    minesLeft--;
+                    break;
+
+                default:
+                    unknown++;
+                    break;
+            }
+        }
+    }
+
+    if (!unknown){
+        return SOLVER_MINE;
+    }
+
+    // Lowest risk
+    defRisk = (minesLeft <= 0)?0:(uint16_t)(minesLeft * SOLVER_RISK_MAX / unknown);
+    for (r = 0; r < grid->size.row; r++){
+        for (c = 0; c < grid->size.col; c++){
+            id = r * grid->size.col + c;
+            if (BOX_IS_COVERED(&grid->boxes[id]) &&
+                SOLVER_UNKNOWN == solver->boxes[id] &&
+                (risk = solver_getRisk(solver, r, c, defRisk)) < minRisk){
+                minRisk = risk;
+                pos->row = r;
+                pos->col = c;
+            }
+        }
+    }
+
+    return SOLVER_UNKNOWN;
+}
+
+//  solver_getRisk() : Estimated risk of an unsolved covered box
+//
+//  The risk is the highest ratio "mines left / unsolved boxes" of the
+//  revealed numbers around the box. A box with no revealed neighbour gets
+//  the default (ie. global) risk
+//
+//  @solver : Pointer to the solver
+//  @r, @c : Position of the box
+//  @defRisk : Default risk value
+//
+//  @return : risk in 1/SOLVER_RISK_MAX
+//
+uint16_t solver_getRisk(PSOLVER const solver, uint8_t r, uint8_t c, uint16_t defRisk){
+    PGRID grid = solver->grid;
+    uint16_t id, risk, maxRisk = 0;
+    uint8_t nr, nc, unknown, mines;
+    int8_t dr, dc, ddr, ddc;
+    BOOL border = FALSE;
+    PBOX box;
+
+    for (dr = -1; dr <= 1; dr++){
+        for (dc = -1; dc <= 1; dc++){
+            nr = r + dr;
+            nc = c + dc;
+            if (!(dr || dc) || nr >= grid->size.row || nc >= grid->size.col){
+                continue;
+            }
+
+            box = BOX_AT(grid, nr, nc);
+            if (!BOX_IS_NUMBER(box)){
+                continue;
+            }
+
+            // Number's neighbourhood
+            unknown = mines = 0;
+            for (ddr = -1; ddr <= 1; ddr++){
+                for (ddc = -1; ddc <= 1; ddc++){
+                    if ((ddr || ddc) &&
+                        (uint8_t)(nr + ddr) < grid->size.row &&
+                        (uint8_t)(nc + ddc) < grid->size.col){
+                        id = (nr + ddr) * grid->size.col + nc + ddc;
+                        if (BOX_IS_COVERED(&grid->boxes[id])){
+                            if (SOLVER_MINE == solver->boxes[id]){
+                                mines++;
+                            }
+                            else{
+                                if (SOLVER_UNKNOWN == solver->boxes[id]){
+                                    unknown++;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+
+            if (unknown){
+                border = TRUE;
+                risk = (BOX_NUMBER(box) > mines)?((BOX_NUMBER(box) - mines) * SOLVER_RISK_MAX / unknown):0;
+                if (risk > maxRisk){
+                    maxRisk = risk;
+                }
+            }
+        }
+    }
+
+    return (border?maxRisk:defRisk);
+}
+
+//  solver_free() : Free memory used by a solver
+//
+//  @solver : Pointer to the solver
+//  @freeAll : if FALSE only the system is freed. If TRUE solver memory
+//              will also be freed
+//
+//  @return : pointer to solver or NULL if freed
+//
+PSOLVER solver_free(PSOLVER const solver, BOOL freeAll){
+    if (solver){
+        _freeRows(solver);
+
+        if (solver->vars){
+            free(solver->vars);
+        }
+        if (solver->boxVars){
+            free(solver->boxVars);
+        }
+        if (solver->boxes){
+            free(solver->boxes);
+        }
+
+        if (freeAll){
+            free(solver);
+            return NULL;
+        }
+
+        memset(solver, 0, sizeof(SOLVER));
+    }
+
+    return solver;
+}
+
+//
+// Internal functions
+//
+
+// _freeRows() : Free the rows of the system
+//
+static void _freeRows(PSOLVER const solver){
+    if (solver->pos){
+        free(solver->pos);
+        solver->pos = NULL;
+    }
+    if (solver->neg){
+        free(solver->neg);
+        solver->neg = NULL;
+    }
+    if (solver->rhs){
+        free(solver->rhs);
+        solver->rhs = NULL;
+    }
+
+    solver->varCount = solver->rowCount = solver->words = 0;
+}
+
+// _allocRows() : Allocate the rows once the frontier is known
+//
+//  @return : TRUE if done
+//
+static BOOL _allocRows(PSOLVER const solver){
+    size_t size;
+
+    solver->words = (solver->varCount + SOLVER_WORD_BITS - 1) / SOLVER_WORD_BITS;
+    size = solver->rowCount * solver->words * sizeof(SOLVER_WORD);
+    solver->pos = (SOLVER_WORD*)malloc(size);
+    solver->neg = (SOLVER_WORD*)malloc(size);
+    solver->rhs = (int16_t*)malloc(solver->rowCount * sizeof(int16_t));
+    if (!solver->pos || !solver->neg || !solver->rhs){
+        _freeRows(solver);
+        return FALSE;
+    }
+
+    memset(solver->pos, 0, size);
+    memset(solver->neg, 0, size);
+    return TRUE;
+}
+
+// _scanRow() : Scan a row of the grid
+//
+//  Unsolved covered boxes next to a revealed number are the vars. of
+//  the system and each of these numbers is a row.
+//
+//  @solver : Pointer to the solver
+//  @r : Row in the grid
+//  @fill : FALSE to count vars. and rows, TRUE to fill the rows
+//
+static void _scanRow(PSOLVER const solver, uint8_t r, BOOL fill){
+    PGRID grid = solver->grid;
+    uint16_t id, row = solver->pivot;
+    int16_t mines;
+    uint8_t c;
+    int8_t dr, dc;
+    PBOX box;
+    BOOL border;
+
+    for (c = 0; c < grid->size.col; c++){
+        box = BOX_AT(grid, r, c);
+        if (!BOX_IS_NUMBER(box)){
+            continue;
+        }
+
+        border = FALSE;
+        mines = 0;
+        for (dr = -1; dr <= 1; dr++){
+            for (dc = -1; dc <= 1; dc++){
+                if ((dr || dc) &&
+                    (uint8_t)(r + dr) < grid->size.row &&
+                    (uint8_t)(c + dc) < grid->size.col){
+                    id = (r + dr) * grid->size.col + c + dc;
+                    if (!BOX_IS_COVERED(&grid->boxes[id])){
+                        continue;
+                    }
+
+                    switch (solver->boxes[id]){
+                        case SOLVER_MINE:
+                            mines++;
+                            break;
+
+                        case SOLVER_UNKNOWN:
+                            if (fill){
+                                _ROW(solver->pos, solver, row)[_WORD_ID(solver->boxVars[id])] |= _WORD_BIT(solver->boxVars[id]);
+                            }
+                            else{
+                                if (solver->boxVars[id] < 0){
+                                    solver->boxVars[id] = solver->varCount;
+                                    solver->vars[solver->varCount++] = id;
+                                }
+                            }
+                            border = TRUE;
+                            break;
+                    }
+                }
+            }
+        }
+
+        if (border){
+            if (fill){
+                solver->rhs[row++] = BOX_NUMBER(box) - mines;
+            }
+            else{
+                solver->rowCount++;
+            }
+        }
+    }
+
+    solver->pivot = row;
+}
+
+// _reduceVar() : Eliminate a var. from all the rows but its pivot
+//
+//  @solver : Pointer to the solver
+//  @var : ID of the var.
+//
+static void _reduceVar(PSOLVER const solver, uint16_t var){
+    uint16_t row, pivot = solver->pivot, w = _WORD_ID(var);
+    SOLVER_WORD bit = _WORD_BIT(var), tmp;
+    int16_t rhs;
+
+    // A pivot for this var. ?
+    for (row = pivot; row < solver->rowCount &&
+        !((_ROW(solver->pos, solver, row)[w] | _ROW(solver->neg, solver, row)[w]) & bit); row++);
+
+    if (row == solver->rowCount){
+        return;     // var. not in remaining rows
+    }
+
+    // Swap rows
+    if (row != pivot){
+        for (uint16_t i = 0; i < solver->words; i++){
+            tmp = _ROW(solver->pos, solver, row)[i];
+            _ROW(solver->pos, solver, row)[i] = _ROW(solver->pos, solver, pivot)[i];
+            _ROW(solver->pos, solver, pivot)[i] = tmp;
+
+            tmp = _ROW(solver->neg, solver, row)[i];
+            _ROW(solver->neg, solver, row)[i] = _ROW(solver->neg, solver, pivot)[i];
+            _ROW(solver->neg, solver, pivot)[i] = tmp;
+        }
+
+        rhs = solver->rhs[row];
+        solver->rhs[row] = solver->rhs[pivot];
+        solver->rhs[pivot] = rhs;
+    }
+
+    // Eliminate the var. from all other rows (when coefs. stay in {-1, 0, 1})
+    for (row = 0; row < solver->rowCount; row++){
+        if (row != pivot){
+            if (_ROW(solver->pos, solver, row)[w] & bit){
+                _combineRows(solver, row, pivot, (_ROW(solver->neg, solver, pivot)[w] & bit) != 0);
+            }
+            else{
+                if (_ROW(solver->neg, solver, row)[w] & bit){
+                    _combineRows(solver, row, pivot, (_ROW(solver->pos, solver, pivot)[w] & bit) != 0);
+                }
+            }
+        }
+    }
+
+    solver->pivot++;
+}
+
+// _extractRow() : Forced boxes in a row
+//
+//  @solver : Pointer to the solver
+//  @row : ID of the row
+//
+//  @return : count of boxes found
+//
+static uint16_t _extractRow(PSOLVER const solver, uint16_t row){
+    SOLVER_WORD* pos = _ROW(solver->pos, solver, row);
+    SOLVER_WORD* neg = _ROW(solver->neg, solver, row);
+    uint16_t pCount = _countBits(pos, solver->words);
+    uint16_t nCount = _countBits(neg, solver->words);
+    uint16_t w, var, found = 0;
+    uint8_t pStatus, nStatus;
+
+    if (!pCount && !nCount){
+        return 0;   // Empty row
+    }
+
+    if (solver->rhs[row] == (int16_t)pCount){
+        pStatus = SOLVER_MINE;
+        nStatus = SOLVER_SAFE;
+    }
+    else{
+        if (solver->rhs[row] == -(int16_t)nCount){
+            pStatus = SOLVER_SAFE;
+            nStatus = SOLVER_MINE;
+        }
+        else{
+            return 0;   // Nothing forced by this row
+        }
+    }
+
+    // _setBox() removes the var. from every row, this one included
+    for (w = 0; w < solver->words; w++){
+        while (pos[w] | neg[w]){
+            var = w * SOLVER_WORD_BITS;
+            if (pos[w]){
+                var += __builtin_ctz(pos[w]);
+                _setBox(solver, var, pStatus);
+            }
+            else{
+                var += __builtin_ctz(neg[w]);
+                _setBox(solver, var, nStatus);
+            }
+            found++;
+        }
+    }
+
+    return found;
+}
+
+// _combineRows() : dest = dest +/- src
+//
+//  The operation is only done if all the coefficients of the
+//  resulting row are in {-1, 0, +1}
+//
+//  @solver : Pointer to the solver
+//  @dest, @src : IDs of the rows
+//  @add : TRUE for an addition, FALSE for a substraction
+//
+//  @return : TRUE if rows have been combined
+//
+static BOOL _combineRows(PSOLVER const solver, uint16_t dest, uint16_t src, BOOL add){
+    SOLVER_WORD* dPos = _ROW(solver->pos, solver, dest);
+    SOLVER_WORD* dNeg = _ROW(solver->neg, solver, dest);
+    SOLVER_WORD* sPos = _ROW((add?solver->neg:solver->pos), solver, src);   // dest + src = dest - (-src)
+    SOLVER_WORD* sNeg = _ROW((add?solver->pos:solver->neg), solver, src);
+    SOLVER_WORD p, n;
+    uint16_t w;
+
+    // Would a coefficient be +/-2 ?
+    for (w = 0; w < solver->words; w++){
+        if ((dPos[w] & sNeg[w]) | (dNeg[w] & sPos[w])){
+            return FALSE;
+        }
+    }
+
+    for (w = 0; w < solver->words; w++){
+        p = (dPos[w] & ~sPos[w]) | (sNeg[w] & ~dNeg[w]);
+        n = (dNeg[w] & ~sNeg[w]) | (sPos[w] & ~dPos[w]);
+        dPos[w] = p;
+        dNeg[w] = n;
+    }
+
+    solver->rhs[dest] += (add?solver->rhs[src]:-solver->rhs[src]);
+    return TRUE;
+}
+
+// _setBox() : A var. has been solved
+//
+//  The var. is removed from every row
+//
+//  @solver : Pointer to the solver
+//  @var : ID of the var.
+//  @status : SOLVER_SAFE or SOLVER_MINE
+//
+static void _setBox(PSOLVER const solver, uint16_t var, uint8_t status){
+    uint16_t row, w = _WORD_ID(var);
+    SOLVER_WORD bit = _WORD_BIT(var);
+
+    solver->boxes[solver->vars[var]] = status;
+
+    for (row = 0; row < solver->rowCount; row++){
+        if (_ROW(solver->pos, solver, row)[w] & bit){
+            _ROW(solver->pos, solver, row)[w] &= ~bit;
+            if (SOLVER_MINE == status){
+                solver->rhs[row]--;
+            }
+        }
+        else{
+            if (_ROW(solver->neg, solver, row)[w] & bit){
+                _ROW(solver->neg, solver, row)[w] &= ~bit;
+                if (SOLVER_MINE == status){
+                    solver->rhs[row]++;
+                }
+            }
+        }
+    }
+}
+
+// _countBits() : Count of bits set in a bitset
+//
+static uint16_t _countBits(SOLVER_WORD const* bits, uint16_t words){
+    uint16_t count = 0;
+    for (uint16_t w = 0; w < words; w++){
+        count += __builtin_popcount(bits[w]);
+    }
+    return count;
+}
+
+// EOF
@@ -0,0 +1,205 @@
+//----------------------------------------------------------------------
+//--
+//--    solver.h
+//--
+//--            Linear constraints solver for a game grid
+//--
+//----------------------------------------------------------------------
+
+#ifndef __GEE_MINES_SOLVER_h__
+#define __GEE_MINES_SOLVER_h__    1
+
+#include "grid.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif // #ifdef __cplusplus
+
+//
+// The solver sits between the simple "count" rules and a full
+// enumeration of the frontier.
+//
+// Each revealed number bordering covered boxes gives a linear constraint :
+//      sum(covered neighbours) = number
+//
+// Rows are stored as 2 bitsets (boxes with a +1 and a -1 coefficient).
+// Since a box holds 0 or 1 mine, a combination of rows is kept only
+// when all its coefficients stay in {-1, 0, +1}. Row operations are
+// therefore plain bitwise ops on 32 bits words.
+//
+// A reduced row forces all its boxes as soon as its right-hand side
+// equals the sum of its positive (or negative) coefficients.
+//
+// Flags and questions are user's guesses : these boxes are handled as
+// covered ones.
+//
+// The solver can run by small steps (see solver_stepEx) so that it never
+// blocks the game loop. Boxes already solved are kept when the grid
+// changes : they are no more part of the next system.
+//
+
+// Status of a box for the solver
+//
+#define SOLVER_UNKNOWN      0
+#define SOLVER_SAFE         1
+#define SOLVER_MINE         2
+
+// Max. count of reduction / extraction passes
+#define SOLVER_MAX_PASSES   8
+
+// Solver states
+//
+#define SOLVER_IDLE         0   // Results are up to date
+#define SOLVER_SCAN         1   // Searching for the frontier (1 grid row per unit)
+#define SOLVER_BUILD        2   // Filling the rows (1 grid row per unit)
+#define SOLVER_EXTRACT      3   // Searching for forced boxes (1 system row per unit)
+#define SOLVER_REDUCE       4   // Gaussian elimination (1 var. per unit)
+
+// Work units
+//
+#define SOLVER_NO_LIMIT     0xFFFF
+#define SOLVER_TICK_BUDGET  24      // Units per game tick
+
+// Risk of a box (in 1/SOLVER_RISK_MAX)
+//
+#define SOLVER_RISK_MAX     256
+
+// A row of the system
+//
+typedef uint32_t SOLVER_WORD;
+#define SOLVER_WORD_BITS    32
+
+// The solver
+//
+typedef struct __solver{
+    PGRID grid;
+    uint8_t state;          // SOLVER_IDLE ... SOLVER_REDUCE
+    uint8_t pass;           // Current reduction pass
+    uint16_t cursor;        // Position in the current state
+    uint16_t pivot;         // Current pivot row (SOLVER_REDUCE)
+    uint16_t found;         // Boxes found during the current pass
+    uint16_t varCount;      // # of boxes in the frontier
+    uint16_t rowCount;      // # of constraints
+    uint16_t words;         // # of words per bitset
+    uint16_t boxCount;      // # of boxes in the grid
+    uint16_t* vars;         // var. ID => box index
+    int16_t* boxVars;       // box index => var. ID (or -1 if not in the frontier)
+    SOLVER_WORD* pos;       // +1 coefficients (rowCount x words)
+    SOLVER_WORD* neg;       // -1 coefficients (rowCount x words)
+    int16_t* rhs;           // Right-hand side of each row
+    uint8_t* boxes;         // Status of each box (SOLVER_xxx), kept between runs
+} SOLVER, * PSOLVER;
+
+//  solver_create() : Create an empty solver
+//
+//  @return : pointer to the new solver or NULL
+//
+PSOLVER solver_create();
+
+//  solver_init() : Attach the solver to a new grid
+//
+//  Previous results are lost
+//
+//  @solver : Pointer to the solver
+//  @grid : Grid to analyse (only boxes states are used)
+//
+//  @return : TRUE if done
+//
+BOOL solver_init(PSOLVER const solver, PGRID const grid);
+
+//  solver_update() : The grid has changed
+//
+//  The system will be rebuilt by the next step. Boxes already solved
+//  are kept
+//
+//  @solver : Pointer to the solver
+//
+void solver_update(PSOLVER const solver);
+
+//  solver_stepEx() : Run the solver for a limited amount of work
+//
+//  @solver : Pointer to the solver
+//  @budget : Max. count of work units (SOLVER_NO_LIMIT to run until done)
+//
+//  @return : TRUE if results are up to date
+//
+BOOL solver_stepEx(PSOLVER const solver, uint16_t budget);
+#define solver_step(solver) solver_stepEx(solver, SOLVER_TICK_BUDGET)
+
+//  solver_solve() : Run the solver until results are up to date
+//
+//  @solver : Pointer to the solver
+//
+//  @return : count of solved boxes in the grid
+//
+uint16_t solver_solve(PSOLVER const solver);
+
+//  solver_reduce() : Gaussian elimination of the system
+//
+//  @solver : Pointer to the solver
+//
+void solver_reduce(PSOLVER const solver);
+
+//  solver_extract() : Find forced boxes in the rows of the system
+//
+//  Forced boxes are removed from the system
+//
+//  @solver : Pointer to the solver
+//
+//  @return : count of new boxes found
+//
+uint16_t solver_extract(PSOLVER const solver);
+
+//  solver_getBox() : Status of a box
+//
+//  @solver : Pointer to the solver
+//  @pos : Position of the box
+//
+//  @return : SOLVER_UNKNOWN, SOLVER_SAFE or SOLVER_MINE
+//
+uint8_t solver_getBox(PSOLVER const solver, PCOORD const pos);
+
+//  solver_getHint() : Get a box to step on
+//
+//  A covered box known to be safe or, if none, the covered box with
+//  the lowest estimated risk
+//
+//  @solver : Pointer to the solver
+//  @pos : Position of the box
+//
+//  @return : SOLVER_SAFE if the box is safe, SOLVER_UNKNOWN if it's a guess
+//            and SOLVER_MINE if no box can be found
+//
+uint8_t solver_getHint(PSOLVER const solver, PCOORD const pos);
+
+//  solver_getRisk() : Estimated risk of an unsolved covered box
+//
+//  The risk is the highest ratio "mines left / unsolved boxes" of the
+//  revealed numbers around the box. A box with no revealed neighbour gets
+//  the default (ie. global) risk
+//
+//  @solver : Pointer to the solver
+//  @r, @c : Position of the box
+//  @defRisk : Default risk value
+//
+//  @return : risk in 1/SOLVER_RISK_MAX
+//
+uint16_t solver_getRisk(PSOLVER const solver, uint8_t r, uint8_t c, uint16_t defRisk);
+
+//  solver_free() : Free memory used by a solver
+//
+//  @solver : Pointer to the solver
+//  @freeAll : if FALSE only the system is freed. If TRUE solver memory
+//              will also be freed
+//
+//  @return : pointer to solver or NULL if freed
+//
+PSOLVER solver_free(PSOLVER const solver, BOOL freeAll);
+
+#ifdef __cplusplus
+}
+#endif // #ifdef __cplusplus
+
+#endif // #ifndef __GEE_MINES_SOLVER_h__
+
+// EOF
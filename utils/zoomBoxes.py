@@ -0,0 +1,77 @@
+# coding=UTF-8
+#
+#   File     :   zoomBoxes.py
+#
+#   Author     :   GeeHB
+#
+#   Description :   Smaller versions of the boxes images (zoom)
+#			        The source file contains two cols of 16 x 16 images
+#			        (original and rotated images) :
+#
+#				[Img1][rotImg1]
+#				[Img2][rotImg2]
+#				...
+#				[Imgn][rotImgn]
+#
+#			Each image is reduced separately (no bleeding between images)
+#			and the new file has the same layout
+#
+#   Comment    :   Python 3.xx
+#
+#   Parameters : ./zoomBoxes.py
+#
+
+import sys
+from PIL import Image
+
+#
+# App consts
+#
+
+# Filenames
+FILE_SRC = "../assets-cg/boxes.png"
+FILE_DEST = "../assets-cg/boxes-{}.png"
+
+# "image" dimensions
+IMG_W = 16
+IMG_H = 16
+
+# New sizes
+IMG_SIZES = [12, 8]
+
+#
+# Entry point
+#
+if "__main__" == __name__:
+
+    # Ouverture de l'image
+    try:
+        src = Image.open(FILE_SRC).convert('RGB')
+    except FileNotFoundError:
+        print(f"Impossible d'ouvrir le fichier {FILE_SRC}")
+        sys.exit(1)
+
+    # Petite verification des dimensions de l'image
+    width, height = src.size
+    if width != 2 * IMG_W or 0 != (height % IMG_H):
+        print("Les dimensions de l'image sont incorrectes")
+        sys.exit(1)
+
+    imgCount = int(height / IMG_H)
+    print(f"Le fichier '{FILE_SRC}' contient {imgCount} vignettes")
+
+    for size in IMG_SIZES:
+        dest = Image.new('RGB', (2 * size, imgCount * size))
+
+        # Reduction de chaque vignette
+        for row in range(imgCount):
+            for col in range(2):
+                img = src.crop((col * IMG_W, row * IMG_H, (col + 1) * IMG_W, (row + 1) * IMG_H))
+                dest.paste(img.resize((size, size), Image.LANCZOS), (col * size, row * size))
+
+        # Sauvegarde du fichier
+        name = FILE_DEST.format(size)
+        dest.save(name, 'png')
+        print(f"Génération du fichier '{name}' terminée")
+
+# EOF